@@ -19,9 +19,9 @@ set(PortMidi_PROCESS_INCLUDES PortMidi_INCLUDE_DIR)
 set(PortMidi_PROCESS_LIBS PortMidi_LIBRARY)
 # Porttime library is merged to Portmidi in new versions, so
 # we work around problems by adding it only if it's present
-if (${PortTime_LIBRARY})
-	set(PortMidi_PROCESS_LIBS PortMidi_PROCESS_LIBS PortTime_LIBRARY)
-endif (${PortTime_LIBRARY})
+if (PortTime_LIBRARY)
+	list(APPEND PortMidi_PROCESS_LIBS PortTime_LIBRARY)
+endif ()
 
 libfind_process(PortMidi)
 mark_as_advanced(PortTime_LIBRARY)
@@ -0,0 +1,41 @@
+#version 330 core
+
+//DEFINES
+
+layout(location = 0) in vec3 vertPos;
+layout(location = 1) in vec2 vertTexCoord;
+layout(location = 2) in vec3 vertNormal;
+layout(location = 3) in vec4 vertColor;
+
+// Per-instance attributes (glutil::InstanceInfo)
+layout(location = 4) in vec4 instPosition;  // Offset (xyz) and scale (w)
+layout(location = 5) in vec4 instColor;
+layout(location = 6) in vec4 instTexRect;  // Texture coordinate offset (xy) and scale (zw)
+layout(location = 7) in vec4 instParams;  // Rotation around z axis (x)
+
+layout (std140) uniform shaderMatrices {
+	mat4 projMatrix;
+	mat4 mvMatrix;
+	mat4 normalMatrix;
+	mat4 colorMatrix;
+};
+
+out vData {
+	vec3 lightDir;
+	vec2 texCoord;
+	vec3 normal;
+	vec4 color;
+} vertex;
+
+void main() {
+	const vec3 lightPos = vec3(-10.0, 2.0, 15.0);
+	float ca = cos(instParams.x);
+	float sa = sin(instParams.x);
+	mat3 rot = mat3(ca, sa, 0.0, -sa, ca, 0.0, 0.0, 0.0, 1.0);
+	vec4 posEye = mvMatrix * vec4(instPosition.xyz + instPosition.w * (rot * vertPos), 1.0); // Vertex position in eye space
+	gl_Position = projMatrix * posEye; // Vertex position in normalized device coordinates
+	vertex.lightDir = lightPos - posEye.xyz / posEye.w; // Light position relative to vertex
+	vertex.texCoord = instTexRect.xy + vertTexCoord * instTexRect.zw;
+	vertex.normal = normalize(mat3(normalMatrix) * (rot * vertNormal));
+	vertex.color = vertColor * instColor;
+}
@@ -117,3 +117,14 @@ void Object3d::draw(Window& window, float x, float y, float z, float s) {
 	Transform trans(window, translate(vec3(x, y, z)) * scale(s));  // Move to position and scale
 	draw(window);
 }
+
+void Object3d::draw(Window& window, glutil::InstanceArray const& instances) {
+	if (m_texture) {
+		UseTexture tex(window, *m_texture);
+		UseShader us(getShader(window, "texture_instanced"));
+		m_va.draw(instances, GL_TRIANGLES);
+	} else {
+		UseShader us(getShader(window, "3dobject_instanced"));
+		m_va.draw(instances, GL_TRIANGLES);
+	}
+}
@@ -27,6 +27,8 @@ class Object3d {
 	void draw(Window&);
 	/// draws the object with a transform
 	void draw(Window&, float x, float y, float z = 0.0f, float s = 1.0f);
+	/// draws the object at each instance with a single draw call
+	void draw(Window&, glutil::InstanceArray const& instances);
 
   private:
 	/// load a Wavefront .obj 3d object file
@@ -29,6 +29,14 @@ Analyzer::Analyzer(double rate, std::string id, unsigned step):
 	}
 }
 
+void Analyzer::record(bool enable) {
+	if (enable) {
+		if (!m_record) m_record = std::make_unique<SpscRing>(static_cast<std::size_t>(2.0 * m_rate));  // Plenty for the recorder thread to keep up
+		m_record->clear();
+	}
+	m_recording.store(enable, std::memory_order_release);
+}
+
 void Analyzer::output(float* begin, float* end, double rate) {
 	constexpr unsigned a = 2;
 	auto const size = m_passthrough.size();
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "ringbuffer.hh"
+#include "spscring.hh"
 #include "tone.hh"
 
 #include <cstdint>
@@ -8,6 +9,9 @@
 #include <vector>
 #include <list>
 #include <algorithm>
+#include <atomic>
+#include <memory>
+#include <string>
 #include <cmath>
 
 static const unsigned FFT_P = 10;
@@ -28,7 +32,12 @@ class Analyzer {
 	template <typename InIt> void input(InIt begin, InIt end) {
 		m_buf.insert(begin, end);
 		m_passthrough.insert(begin, end);
+		if (m_recording.load(std::memory_order_acquire)) m_record->push(begin, end);
 	}
+	/** Start or stop copying input to the recording queue (see Recorder). **/
+	void record(bool enable);
+	/** The recording queue (single consumer), nullptr if recording was never started. **/
+	SpscRing* recorded() { return m_record.get(); }
 	/** Call this to process all data input so far. **/
 	void process();
 	/** Get the raw FFT. **/
@@ -43,6 +52,8 @@ class Analyzer {
 	void output(float* begin, float* end, double rate);
 	/** Returns the id (color name) of the mic */
 	std::string const& getId() const { return m_id; }
+	/** Returns the sample rate of the input */
+	double getRate() const { return m_rate; }
 
   private:
 	bool calcFFT();
@@ -62,4 +73,6 @@ class Analyzer {
 	double m_peak;
 	tones_t m_tones;
 	mutable double m_oldfreq;
+	std::unique_ptr<SpscRing> m_record;  // Kept once allocated, as the audio callback may still be writing to it after recording stops
+	std::atomic<bool> m_recording{ false };
 };
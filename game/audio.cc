@@ -7,6 +7,7 @@
 #include "screen_songs.hh"
 #include "game.hh"
 #include "analyzer.hh"
+#include "cache.hh"
 #include "songs.hh"
 #include "util.hh"
 
@@ -129,7 +130,7 @@ Seconds AudioClock::pos() const {
 }
 
 Music::Music(Game& game, Audio::Files const& files, unsigned int sr, bool preview)
-: srate(sr), m_preview(preview), m_game(game) {
+: srate(sr), m_preview(preview), m_game(game), m_volume(preview ? "audio/preview_volume" : "audio/music_volume") {
 	for (auto const& tf /* trackname-filename pair */: files) {
 		if (tf.second.empty()) continue; // Skip tracks with no filenames; FIXME: Why do we even have those here, shouldn't they be eliminated earlier?
 		tracks.emplace(tf.first, std::make_unique<Track>(tf.second, sr));
@@ -181,7 +182,7 @@ bool Music::operator()(float* begin, float* end) {
 		if (t.audioBuffer.read(mixbuf.data(), static_cast<std::int64_t>(mixbuf.size()), m_pos, static_cast<float>(t.fadeLevel))) eof = false;
 	}
 	m_pos += samples;
-	const float volume = static_cast<float>(m_preview ? config["audio/preview_volume"].ui() : config["audio/music_volume"].ui()) / 100.0f;
+	const float volume = static_cast<float>(m_volume.get()) / 100.0f;
 	for (size_t i = 0, iend = mixbuf.size(); i != iend; ++i) {
 		if (i % 2 == 0) {
 			fadeLevel += fadeRate;
@@ -270,32 +271,21 @@ void Music::trackPitchBend(std::string const& name, double pitchFactor) {
 	it->second->pitchFactor = pitchFactor;
 }
 
+/// A sound effect playing from PCM shared with the sample bank (interleaved stereo at Audio::getSR())
 struct Sample {
   private:
-	std::int64_t m_pos;
-	AudioBuffer audioBuffer;
-	bool eof;
+	std::shared_ptr<std::vector<float> const> m_pcm;
+	std::size_t m_pos = 0;
+	bool eof = true;
   public:
-	Sample(fs::path const& filename, unsigned sr) : m_pos(), audioBuffer(filename, sr), eof(true) { }
-	void operator()(float* begin, float* end) {
-		if(eof) {
-			// No more data to play in this sample
-			return;
-		}
-		if (end <= begin) {
-			eof = true;
-			return;
-		}
-		std::int64_t size = end - begin;
-		std::vector<float> mixbuf(static_cast<size_t>(size));
-		if(!audioBuffer.read(mixbuf.data(), size, m_pos, 1.0)) {
-			eof = true;
-		}
-		const auto failVolume = static_cast<float>(config["audio/fail_volume"].ui()) / 100.0f;
-		for (size_t i = 0, iend = mixbuf.size(); i != iend; ++i) {
-			begin[i] += mixbuf[i] * failVolume;
-		}
-		m_pos += end - begin;
+	explicit Sample(std::shared_ptr<std::vector<float> const> pcm): m_pcm(std::move(pcm)) {}
+	void operator()(float* begin, float* end, float volume) {
+		if (eof || end <= begin) return;
+		std::size_t const count = std::min(static_cast<std::size_t>(end - begin), m_pcm->size() - m_pos);
+		float const* pcm = m_pcm->data() + m_pos;
+		for (std::size_t i = 0; i < count; ++i) begin[i] += pcm[i] * volume;
+		m_pos += count;
+		if (m_pos == m_pcm->size()) eof = true;  // No more data to play in this sample
 	}
 	void reset() {
 		eof = false;
@@ -352,6 +342,9 @@ struct Output {
 	std::unordered_map<std::string, std::unique_ptr<Sample>> samples;
 	std::vector<Command> commands;
 	std::atomic<bool> paused{ false };
+	ConfigValue<bool> passThrough{ "audio/pass-through" };
+	ConfigValue<float> passThroughRatio{ "audio/pass-through_ratio" };
+	ConfigValue<unsigned short> failVolume{ "audio/fail_volume" };
 	Output(): paused(false) {}
 
 	void callbackUpdate() {
@@ -400,9 +393,9 @@ struct Output {
 			else { ++i; }
 		}
 		// Mix in microphones (if pass-through is enabled)
-		if (mics.size() > 0 && config["audio/pass-through"].b()) {
+		if (mics.size() > 0 && passThrough) {
 			// Decrease music volume
-			float amp = 1.0f / config["audio/pass-through_ratio"].f();
+			float amp = 1.0f / passThroughRatio;
 			if (amp != 1.0f) 
 				for (auto& s : make_iterator_range(begin, end)) 
 					s *= amp;
@@ -414,8 +407,9 @@ struct Output {
 			// samples should not be created/destroyed on the fly
 			std::unique_lock<std::mutex> l(samples_mutex, std::defer_lock);
 			if(l.try_lock()) {
+				float const volume = static_cast<float>(failVolume) / 100.0f;
 				for(auto it = samples.begin() ; it != samples.end() ; ++it) {
-					(*it->second)(begin, end);
+					(*it->second)(begin, end, volume);
 				}
 			}
 		}
@@ -458,11 +452,15 @@ bool Device::isChannel(std::string const& name) const {
 }
 
 int Device::operator()(float const* inbuf, float* outbuf, std::ptrdiff_t frames) try {
+	bool input = false;
 	for (std::size_t i = 0; i < mics.size(); ++i) {
 		if (!mics[i]) continue;  // No analyzer? -> Channel not used
 		da::sample_const_iterator it = da::sample_const_iterator(inbuf + i, in);
 		mics[i]->input(it, it + frames);
+		input = true;
 	}
+	// Wake up Engine without taking its mutex (a missed wakeup only delays it until its timeout)
+	if (input && inputReady) inputReady->notify_all();
 	if (outptr) outptr->callback(outbuf, outbuf + 2 * frames, rate);
 	return paContinue;
 } catch (std::exception& e) {
@@ -475,6 +473,8 @@ struct Audio::Impl {
 	Output output;
 	std::deque<Analyzer> analyzers;
 	std::deque<Device> devices;
+	std::mutex inputMutex;
+	std::condition_variable inputReady;
 	bool playback = false;
 	std::string selectedBackend = Audio::backendConfig().getValue();
 	Impl() {
@@ -534,6 +534,7 @@ struct Audio::Impl {
 				// Match found if we got here, construct a device
 				devices.emplace_back(params.in, params.out, params.rate, info.index);
 				Device& d = devices.back();
+				d.inputReady = &inputReady;
 				// Assign mics for all channels of the device
 				int assigned_mics = 0;
 				for (unsigned j = 0; j < static_cast<unsigned>(params.in); ++j) {
@@ -611,6 +612,11 @@ ConfigItem& Audio::backendConfig() {
 void Audio::restart() {
 	close();
 	self = std::make_unique<Impl>();
+	// The sample bank outlives the devices
+	// The streams of the new devices are already running, so the playback thread may be reading the samples
+	std::lock_guard<std::mutex> l(m_samplesMutex);
+	std::lock_guard<std::mutex> ls(self->output.samples_mutex);
+	for (auto const& [id, pcm]: m_samples) self->output.samples.emplace(id, std::make_unique<Sample>(pcm));
 }
 
 void Audio::close() {
@@ -628,8 +634,44 @@ bool Audio::hasPlayback() const {
 }
 
 void Audio::loadSample(std::string const& streamId, fs::path const& filename) {
-	std::lock_guard<std::mutex> l(self->output.samples_mutex);
-	self->output.samples.emplace(streamId, std::unique_ptr<Sample>(new Sample(filename, static_cast<unsigned>(getSR()))));
+	loadSamples({ { streamId, filename } });
+}
+
+void Audio::loadSamples(std::vector<std::pair<std::string, fs::path>> const& files) {
+	auto const begin = Clock::now();
+	auto const rate = static_cast<unsigned>(getSR());
+	// Decode all files in parallel, unless there is an up-to-date copy in the PCM cache
+	std::vector<std::future<std::shared_ptr<std::vector<float> const>>> decoding;
+	for (auto const& file: files) {
+		decoding.push_back(std::async(std::launch::async, [filename = file.second, rate] {
+			std::vector<float> pcm;
+			if (!cache::loadSample(pcm, filename, rate)) {
+				pcm = decodeAudio(filename, rate);
+				cache::saveSample(pcm, filename, rate);
+			}
+			return std::make_shared<std::vector<float> const>(std::move(pcm));
+		}));
+	}
+	std::vector<std::pair<std::string, std::shared_ptr<std::vector<float> const>>> decoded;
+	for (std::size_t i = 0; i < files.size(); ++i) {
+		try {
+			decoded.emplace_back(files[i].first, decoding[i].get());
+		} catch (std::exception const& e) {
+			SpdLogger::error(LogSystem::AUDIO, "Unable to load sample={}, path={}, exception={}", files[i].first, files[i].second, e.what());
+		}
+	}
+	// Publish to the bank and to the playback thread
+	std::lock_guard<std::mutex> l(m_samplesMutex);
+	{
+		std::lock_guard<std::mutex> ls(self->output.samples_mutex);
+		for (auto const& [id, pcm]: decoded) {
+			m_samples[id] = pcm;
+			self->output.samples.insert_or_assign(id, std::make_unique<Sample>(pcm));
+		}
+	}
+	std::size_t bytes = 0;
+	for (auto const& sample: m_samples) bytes += sample.second->size() * sizeof(float);
+	SpdLogger::info(LogSystem::AUDIO, "Loaded samples={} in {:.3f}s, sample bank has samples={}, memory={} KiB", decoded.size(), Seconds(Clock::now() - begin).count(), m_samples.size(), bytes / 1024);
 }
 
 void Audio::playSample(std::string const& streamId) {
@@ -640,7 +682,9 @@ void Audio::playSample(std::string const& streamId) {
 }
 
 void Audio::unloadSample(std::string const& streamId) {
-	std::lock_guard<std::mutex> l(self->output.samples_mutex);
+	std::lock_guard<std::mutex> l(m_samplesMutex);
+	m_samples.erase(streamId);
+	std::lock_guard<std::mutex> ls(self->output.samples_mutex);
 	self->output.samples.erase(streamId);
 }
 
@@ -694,6 +738,11 @@ double Audio::getPosition() const {
 	return (o.playing.empty() || o.preloading.get()) ? getNaN() : o.playing[0]->pos();
 }
 
+void Audio::waitForInput(Seconds timeout) {
+	std::unique_lock<std::mutex> l(self->inputMutex);
+	self->inputReady.wait_for(l, timeout);
+}
+
 double Audio::getLength() const {
 	Output& o = self->output;
 	std::lock_guard<std::mutex> l(o.mutex);
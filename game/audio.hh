@@ -1,10 +1,12 @@
 #pragma once
 
 #include "configuration.hh"
+#include "configvalue.hh"
 #include "ffmpeg.hh"
 #include "notes.hh"
 #include "libda/portaudio.hpp"
 #include "aubio/aubio.h"
+#include <condition_variable>
 #include <cstddef>
 #include <cstdint>
 #include <deque>
@@ -56,6 +58,7 @@ struct Device {
 	portaudio::Stream stream;
 	std::vector<Analyzer*> mics;
 	Output* outptr;
+	std::condition_variable* inputReady = nullptr;  ///< Notified after each block of mic input
 
 	Device(int in, int out, double rate, PaDeviceIndex dev);
 	/// Start
@@ -80,6 +83,9 @@ class Audio {
 	static portaudio::Init init;
 	struct Impl;
 	std::unique_ptr<Impl> self;
+	/// Sample bank: decoded sound effects by id, kept over restart()
+	std::map<std::string, std::shared_ptr<std::vector<float> const>> m_samples;
+	std::mutex m_samplesMutex;
 	friend class ScreenSongs;
 	friend class Music;
 	static std::recursive_mutex aubio_mutex;
@@ -103,6 +109,8 @@ class Audio {
 	void playMusic(Game&, fs::path const& filename, bool preview = false, double fadeTime = 0.5, double startPos = 0.0);
 	/** Plays a list of songs **/
 	void playMusic(Game&, Files const& filenames, bool preview = false, double fadeTime = 0.5, double startPos = 0.0);
+	/** Loads several samples into the sample bank, decoding them in parallel (or reading decoded PCM from the cache) **/
+	void loadSamples(std::vector<std::pair<std::string, fs::path>> const& files);
 	/** Loads/plays/unloads a sample **/
 	void loadSample(std::string const& streamId, fs::path const& filename);
 	void playSample(std::string const& streamId);
@@ -125,6 +133,8 @@ class Audio {
 	bool isPlaying() const;
 	/** Get the current position. If not known or nothing is playing, NaN is returned. **/
 	double getPosition() const;
+	/** Wait until the next block of mic input has been given to the analyzers, or until timeout **/
+	void waitForInput(Seconds timeout);
 	void togglePause() { pause(!isPaused()); }
 	void pause(bool state = true);
 	bool isPaused() const;
@@ -179,4 +189,5 @@ class Music {
 
   private:
 	Game& m_game;
+	ConfigValue<unsigned short> m_volume; ///< Music or preview volume
 };
@@ -1,16 +1,279 @@
 #include "cache.hh"
 #include "fs.hh"
+#include "image.hh"
+#include "log.hh"
+#include "notefile.hh"
+#include "song.hh"
 #include "util.hh"
 
 #include <fmt/format.h>
 
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
 namespace cache {
+	namespace {
+		/// Modification time of the source file, stored in cached files to detect stale copies
+		std::int64_t sourceTime(fs::path const& filename) {
+			return static_cast<std::int64_t>(fs::last_write_time(filename).time_since_epoch().count());
+		}
+
+		/// Load a RAW cache file made from the given source, or reset the target and return false
+		bool loadCached(Bitmap& target, fs::path const& cache_filename, fs::path const& source_filename) {
+			if (!fs::is_regular_file(cache_filename)) return false;
+			try {
+				if (loadRAW(target, cache_filename) == sourceTime(source_filename)) return true;
+			} catch (std::exception const& e) {
+				SpdLogger::debug(LogSystem::CACHE, "Ignoring cached file, path={}, exception={}", cache_filename, e.what());
+			}
+			target = Bitmap();
+			return false;
+		}
+
+		/// Files that the notes of a song are parsed from (INI songs keep their notes in a MIDI file)
+		std::vector<fs::path> noteSources(Song const& song) {
+			std::vector<fs::path> files{ song.filename };
+			if (!song.midifilename.empty()) files.push_back(song.midifilename);
+			return files;
+		}
+
+		void putSources(notefile::Writer& out, Song const& song) {
+			auto const files = noteSources(song);
+			out.put(static_cast<std::uint32_t>(files.size()));
+			for (auto const& file: files) {
+				out.put(file.string());
+				out.put(static_cast<std::uint64_t>(fs::file_size(file)));
+				out.put(sourceTime(file));
+			}
+		}
+
+		/// Check that the cached notes were parsed from the current versions of the song's files
+		bool sourcesMatch(notefile::Reader& in, Song const& song) {
+			auto const files = noteSources(song);
+			std::uint32_t count;
+			in.get(count);
+			if (count != files.size()) return false;
+			for (auto const& file: files) {
+				std::string name;
+				std::uint64_t size;
+				std::int64_t time;
+				in.get(name);
+				in.get(size);
+				in.get(time);
+				if (name != file.string() || size != fs::file_size(file) || time != sourceTime(file)) return false;
+			}
+			return true;
+		}
+
+		/// Header of a cached sample, followed by count floats
+		struct SampleHeader {
+			char magic[4] = { 'P', 'P', 'C', 'M' };
+			std::uint32_t version = 1;
+			std::uint32_t rate = 0;
+			std::uint32_t reserved = 0;
+			std::uint64_t sourceSize = 0;
+			std::int64_t sourceTime = 0;
+			std::uint64_t count = 0;
+		};
+
+		SampleHeader sampleHeader(fs::path const& source_filename, unsigned rate) {
+			SampleHeader header;
+			header.rate = rate;
+			header.sourceSize = static_cast<std::uint64_t>(fs::file_size(source_filename));
+			header.sourceTime = sourceTime(source_filename);
+			return header;
+		}
+
+		void saveCached(Bitmap const& bitmap, fs::path const& cache_filename, fs::path const& source_filename) {
+			try {
+				fs::create_directories(cache_filename.parent_path());
+				writeRAW(cache_filename, bitmap, sourceTime(source_filename));
+			} catch (std::exception const& e) {
+				SpdLogger::warning(LogSystem::CACHE, "Unable to write cache file, path={}, exception={}", cache_filename, e.what());
+			}
+		}
+	}
+
 	fs::path constructSVGCacheFileName(fs::path const& svgfilename, float factor){
 		std::string const lod = fmt::format("{:.2f}", factor);
-		std::string const cache_basename = svgfilename.filename().string() + ".cache_" + lod + ".premul.png";
+		std::string const cache_basename = svgfilename.filename().string() + ".cache_" + lod + ".premul.raw";
 		// Windows drive name handling
 		auto const fullpath = replace(svgfilename.parent_path().string(), ':', '_');
 
 		return PathCache::getCacheDir() / "misc" / fs::path(fullpath).relative_path() / cache_basename;
 	}
+
+	bool loadSVG(Bitmap& target, fs::path const& source_filename, float factor) {
+		return loadCached(target, constructSVGCacheFileName(source_filename, factor), source_filename);
+	}
+
+	void saveSVG(Bitmap const& bitmap, fs::path const& source_filename, float factor) {
+		saveCached(bitmap, constructSVGCacheFileName(source_filename, factor), source_filename);
+	}
+
+	fs::path constructThumbnailCacheFileName(fs::path const& filename, unsigned size) {
+		std::string const cache_basename = filename.filename().string() + ".thumb_" + std::to_string(size) + ".raw";
+		// Windows drive name handling
+		auto const fullpath = replace(filename.parent_path().string(), ':', '_');
+
+		return PathCache::getCacheDir() / "thumbnails" / fs::path(fullpath).relative_path() / cache_basename;
+	}
+
+	bool loadThumbnail(Bitmap& target, fs::path const& source_filename, unsigned size) {
+		if (!loadCached(target, constructThumbnailCacheFileName(source_filename, size), source_filename)) return false;
+		if (target.width <= size && target.height <= size) return true;
+		target = Bitmap();
+		return false;
+	}
+
+	void saveThumbnail(Bitmap const& bitmap, fs::path const& source_filename, unsigned size) {
+		if (bitmap.fmt != pix::Format::CHAR_RGBA && bitmap.fmt != pix::Format::INT_ARGB) return;
+		saveCached(bitmap, constructThumbnailCacheFileName(source_filename, size), source_filename);
+	}
+
+	fs::path constructNotesCacheFileName(fs::path const& songfilename) {
+		std::string const cache_basename = songfilename.filename().string() + ".notes";
+		// Windows drive name handling
+		auto const fullpath = replace(songfilename.parent_path().string(), ':', '_');
+
+		return PathCache::getCacheDir() / "notes" / fs::path(fullpath).relative_path() / cache_basename;
+	}
+
+	bool loadNotes(Song& song) {
+		fs::path const cache_filename = constructNotesCacheFileName(song.filename);
+		if (!fs::is_regular_file(cache_filename)) return false;
+		try {
+			// The whole file is read at once and decoded from memory
+			std::ifstream file(cache_filename, std::ios::binary);
+			notefile::Reader in(std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()));
+			if (!sourcesMatch(in, song)) return false;
+			VocalTracks vocalTracks;
+			InstrumentTracks instrumentTracks;
+			DanceTracks danceTracks;
+			Song::Beats beats;
+			Song::Stops stops;
+			std::vector<Song::BPM> bpms;
+			std::vector<Song::SongSection> sections;
+			bool hasBRE;
+			std::string b0rked;
+			in.get(vocalTracks);
+			in.get(instrumentTracks);
+			in.get(danceTracks);
+			in.get(beats);
+			in.get(stops);
+			std::uint32_t count;
+			in.get(count);
+			for (std::uint32_t i = 0; i < count; ++i) {
+				double begin, step, ts;
+				in.get(begin);
+				in.get(step);
+				in.get(ts);
+				bpms.emplace_back(begin, ts, 1.0f).step = step;
+			}
+			in.get(count);
+			for (std::uint32_t i = 0; i < count; ++i) {
+				std::string name;
+				double begin;
+				in.get(name);
+				in.get(begin);
+				sections.emplace_back(name, begin);
+			}
+			in.get(hasBRE);
+			in.get(b0rked);
+			if (!in.done()) throw std::runtime_error("Trailing data in notes file");
+			song.vocalTracks = std::move(vocalTracks);
+			song.instrumentTracks = std::move(instrumentTracks);
+			song.danceTracks = std::move(danceTracks);
+			song.beats = std::move(beats);
+			song.stops = std::move(stops);
+			song.m_bpms = std::move(bpms);
+			song.songsections = std::move(sections);
+			song.hasBRE = hasBRE;
+			song.b0rked = std::move(b0rked);
+			song.loadStatus = Song::LoadStatus::FULL;
+			SpdLogger::debug(LogSystem::CACHE, "Loaded notes from cache, path={}", cache_filename);
+			return true;
+		} catch (std::exception const& e) {
+			SpdLogger::debug(LogSystem::CACHE, "Ignoring cached notes, path={}, exception={}", cache_filename, e.what());
+		}
+		return false;
+	}
+
+	void saveNotes(Song const& song) {
+		fs::path const cache_filename = constructNotesCacheFileName(song.filename);
+		try {
+			notefile::Writer out;
+			putSources(out, song);
+			out.put(song.vocalTracks);
+			out.put(song.instrumentTracks);
+			out.put(song.danceTracks);
+			out.put(song.beats);
+			out.put(song.stops);
+			out.put(static_cast<std::uint32_t>(song.m_bpms.size()));
+			for (auto const& bpm: song.m_bpms) {
+				out.put(bpm.begin);
+				out.put(bpm.step);
+				out.put(bpm.ts);
+			}
+			out.put(static_cast<std::uint32_t>(song.songsections.size()));
+			for (auto const& section: song.songsections) {
+				out.put(section.name);
+				out.put(section.begin);
+			}
+			out.put(song.hasBRE);
+			out.put(song.b0rked);
+			fs::create_directories(cache_filename.parent_path());
+			std::ofstream file(cache_filename, std::ios::binary);
+			file.write(out.data().data(), static_cast<std::streamsize>(out.data().size()));
+			if (!file) throw std::runtime_error("Writing notes failed");
+		} catch (std::exception const& e) {
+			SpdLogger::warning(LogSystem::CACHE, "Unable to write cache file, path={}, exception={}", cache_filename, e.what());
+		}
+	}
+
+	fs::path constructSampleCacheFileName(fs::path const& filename, unsigned rate) {
+		std::string const cache_basename = filename.filename().string() + "." + std::to_string(rate) + ".pcm";
+		// Windows drive name handling
+		auto const fullpath = replace(filename.parent_path().string(), ':', '_');
+
+		return PathCache::getCacheDir() / "samples" / fs::path(fullpath).relative_path() / cache_basename;
+	}
+
+	bool loadSample(std::vector<float>& pcm, fs::path const& source_filename, unsigned rate) {
+		fs::path const cache_filename = constructSampleCacheFileName(source_filename, rate);
+		if (!fs::is_regular_file(cache_filename)) return false;
+		try {
+			SampleHeader const expected = sampleHeader(source_filename, rate);
+			SampleHeader header;
+			std::ifstream file(cache_filename, std::ios::binary);
+			if (!file.read(reinterpret_cast<char*>(&header), sizeof(header))) throw std::runtime_error("Truncated header");
+			if (std::memcmp(header.magic, expected.magic, sizeof(header.magic)) != 0 || header.version != expected.version) throw std::runtime_error("Not a sample cache file");
+			if (header.rate != expected.rate || header.sourceSize != expected.sourceSize || header.sourceTime != expected.sourceTime) return false;
+			if (header.count != (fs::file_size(cache_filename) - sizeof(header)) / sizeof(float)) throw std::runtime_error("Invalid sample count");
+			pcm.resize(static_cast<std::size_t>(header.count));
+			if (!file.read(reinterpret_cast<char*>(pcm.data()), static_cast<std::streamsize>(pcm.size() * sizeof(float)))) throw std::runtime_error("Truncated samples");
+			return true;
+		} catch (std::exception const& e) {
+			SpdLogger::debug(LogSystem::CACHE, "Ignoring cached file, path={}, exception={}", cache_filename, e.what());
+		}
+		pcm.clear();
+		return false;
+	}
+
+	void saveSample(std::vector<float> const& pcm, fs::path const& source_filename, unsigned rate) {
+		fs::path const cache_filename = constructSampleCacheFileName(source_filename, rate);
+		try {
+			SampleHeader header = sampleHeader(source_filename, rate);
+			header.count = pcm.size();
+			fs::create_directories(cache_filename.parent_path());
+			std::ofstream file(cache_filename, std::ios::binary);
+			file.write(reinterpret_cast<char const*>(&header), sizeof(header));
+			file.write(reinterpret_cast<char const*>(pcm.data()), static_cast<std::streamsize>(pcm.size() * sizeof(float)));
+			if (!file) throw std::runtime_error("Writing samples failed");
+		} catch (std::exception const& e) {
+			SpdLogger::warning(LogSystem::CACHE, "Unable to write cache file, path={}, exception={}", cache_filename, e.what());
+		}
+	}
 }
@@ -4,21 +4,47 @@
 #include "fs.hh"
 #include <cstring>
 #include <stdexcept>
+#include <vector>
+
+struct Bitmap;
+class Song;
 
 namespace cache {
 
 	/** Builds the full path and file name for the SVG cache resource **/
 	fs::path constructSVGCacheFileName(fs::path const& svgfilename, float factor);
 
-	/** Load an SVG from the cache, if loading fails invalid_cache_error is thrown **/
-	template <typename T> bool loadSVG(T& target, fs::path const& source_filename, float factor) {
-		fs::path const cache_filename = cache::constructSVGCacheFileName(source_filename, factor);
-		// Verify that a cached file exists and that it is more recent than the original SVG
-		if (!fs::is_regular_file(cache_filename)) return false;
-		if (fs::last_write_time(source_filename) > fs::last_write_time(cache_filename)) return false;
-		// Try to load the cached file		
-		try { loadPNG(target, cache_filename.string()); } catch( ... ) { return false; }
-		return true;
-	}
+	/** Load a rasterized SVG from the cache, returns false if there is no valid cached copy **/
+	bool loadSVG(Bitmap& target, fs::path const& source_filename, float factor);
+
+	/** Store a rasterized SVG into the cache (failures are logged and ignored) **/
+	void saveSVG(Bitmap const& bitmap, fs::path const& source_filename, float factor);
+
+	/** Builds the full path and file name for a downscaled thumbnail of an image **/
+	fs::path constructThumbnailCacheFileName(fs::path const& filename, unsigned size);
+
+	/** Load a thumbnail from the cache, returns false if there is no valid cached copy of the given source and size **/
+	bool loadThumbnail(Bitmap& target, fs::path const& source_filename, unsigned size);
+
+	/** Store a downscaled bitmap as thumbnail of the given source (failures are logged and ignored) **/
+	void saveThumbnail(Bitmap const& bitmap, fs::path const& source_filename, unsigned size);
+
+	/** Builds the full path and file name for the parsed notes of a song **/
+	fs::path constructNotesCacheFileName(fs::path const& songfilename);
+
+	/** Load the note data of a song from the cache and mark it fully loaded, returns false if there is no up-to-date cached copy **/
+	bool loadNotes(Song& song);
+
+	/** Store the note data of a fully loaded song into the cache (failures are logged and ignored) **/
+	void saveNotes(Song const& song);
+
+	/** Builds the full path and file name for the decoded PCM of a sound effect **/
+	fs::path constructSampleCacheFileName(fs::path const& filename, unsigned rate);
+
+	/** Load decoded PCM (interleaved stereo float at the given rate) of a sound effect, returns false if there is no up-to-date cached copy **/
+	bool loadSample(std::vector<float>& pcm, fs::path const& source_filename, unsigned rate);
+
+	/** Store decoded PCM of a sound effect into the cache (failures are logged and ignored) **/
+	void saveSample(std::vector<float> const& pcm, fs::path const& source_filename, unsigned rate);
 }
 
@@ -60,9 +60,24 @@ ConfigItem& ConfigItem::incdec(int dir) {
 		auto s = static_cast<unsigned short>(std::get<OptionList>(m_value).size());
 		m_sel = static_cast<unsigned short>(m_sel + dir + s) % s;
 	}
+	notify();
 	return *this;
 }
 
+void ConfigItem::observe(Observer observer, std::weak_ptr<void const> owner) {
+	auto& list = m_observers.list;
+	list.erase(std::remove_if(list.begin(), list.end(), [](auto const& entry) { return entry.owned && entry.owner.expired(); }), list.end());
+	bool const owned = !owner.expired();
+	list.push_back({ std::move(observer), std::move(owner), owned });
+}
+
+void ConfigItem::notify() {
+	auto& list = m_observers.list;
+	list.erase(std::remove_if(list.begin(), list.end(), [this](auto const& entry) {
+		return (entry.owned && entry.owner.expired()) || !entry.observer(*this);
+	}), list.end());
+}
+
 bool ConfigItem::isDefault(bool factory) const {
 	return isDefaultImpl(factory ? m_factoryDefaultValue : m_defaultValue);
 }
@@ -141,6 +156,7 @@ std::string& ConfigItem::so() {
 void ConfigItem::select(unsigned short index) {
 	verifyType("option_list");
 	m_sel = clamp<unsigned short>(index, 0, static_cast<unsigned short>(std::get<OptionList>(m_value).size()-1));
+	notify();
 }
 
 namespace {
@@ -201,6 +217,7 @@ void ConfigItem::selectEnum(std::string const& name) {
 	if (it == m_enums.end())
 		throw std::runtime_error("Enum value " + name + " not found in " + m_shortDesc);
 	ui() = static_cast<unsigned short>(it - m_enums.begin());
+	notify();
 }
 
 
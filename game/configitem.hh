@@ -6,6 +6,7 @@
 #include <vector>
 #include <list>
 #include <functional>
+#include <memory>
 
 
 class ConfigItem {
@@ -14,6 +15,8 @@ class ConfigItem {
 	using OptionList = std::vector<std::string>; ///< a list of string options
 	using Value = std::variant<bool, unsigned short, int, float, std::string, StringList>;
 	using NumericValue = std::variant<unsigned short, int, float>;
+	/// Called after each change of value, returns false to unregister itself
+	using Observer = std::function<bool(ConfigItem const&)>;
 
 	ConfigItem() = default;
 	explicit ConfigItem(bool bval);
@@ -41,7 +44,7 @@ class ConfigItem {
 	OptionList& ol(); ///< Access optionlist item
 	std::string& so(); ///< Access currently selected string option
 	void select(unsigned short index); ///< Set optionlist selected item index
-	void reset(bool factory = false) { m_value = factory ? m_factoryDefaultValue : m_defaultValue; } ///< Reset to default
+	void reset(bool factory = false) { m_value = factory ? m_factoryDefaultValue : m_defaultValue; notify(); } ///< Reset to default
 	void makeSystem() { m_defaultValue = m_value; } ///< Make current value the system default (used when saving system config)
 	std::string const& getName() const { return m_keyName; } ///< get the name for this ConfigItem in the schema.
 	void setName(std::string const& name) { m_keyName = name; } ///< get the name for this ConfigItem in the schema.
@@ -51,7 +54,7 @@ class ConfigItem {
 	Value& value() { return m_value; }
 	const Value& value() const { return m_value; }
 	void setLongDescription(std::string const& text) { m_longDesc = text; }
-	void setValue(Value const& value) { m_value = value; }
+	void setValue(Value const& value) { m_value = value; notify(); }
 	void setDefaultValue(Value const& value) { m_defaultValue = value; }
 	void setFactoryDefaultValue(Value const& value) { m_factoryDefaultValue = value; }
 	std::string const getValue() const; ///< Get a human-readable representation of the current value
@@ -65,6 +68,13 @@ class ConfigItem {
 
 	void setGetValueFunction(std::function<std::string(ConfigItem const&)> f) { m_getValue = f; }
 
+	/// Register for change notifications (main thread only). ++, --, reset, select and setValue notify automatically,
+	/// code that writes through the reference accessors (b(), ui(), ...) or assigns a whole ConfigItem must call notify().
+	/// An observer given an owner is dropped once the owner expires, already when the next observer registers, so
+	/// short-lived observers do not pile up on items that rarely change.
+	void observe(Observer observer, std::weak_ptr<void const> owner = {});
+	void notify(); ///< Inform observers that the value has changed
+
   private:
 	void verifyType(std::string const& t) const; ///< throws std::logic_error if t != type
 	ConfigItem& incdec(int dir); ///< Increment/decrement by dir steps (must be -1 or 1)
@@ -89,6 +99,18 @@ class ConfigItem {
 	std::vector<std::string> m_enums; ///< Enum value titles
 	unsigned short m_sel = 0;
 	std::function<std::string(ConfigItem const&)> m_getValue;
+	/// Observers belong to the item rather than its value, so assigning another ConfigItem keeps them
+	struct Observers {
+		Observers() = default;
+		Observers(Observers const&) {}
+		Observers& operator=(Observers const&) { return *this; }
+		struct Entry {
+			Observer observer;
+			std::weak_ptr<void const> owner;
+			bool owned;
+		};
+		std::vector<Entry> list;
+	} m_observers;
 };
 
 using ConfigItemMap = std::map<std::string, ConfigItem>;
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "configuration.hh"
+
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+/**
+ * Typed handle to a config item for hot paths (audio callbacks, per-frame and per-note code).
+ *
+ * The item is looked up and type checked once, when the handle is constructed (on the main thread, after readConfig;
+ * not lazily in code that may first run on another thread).
+ * Reading is then a relaxed atomic load of a snapshot, safe from any thread, instead of a string lookup in the
+ * config map and a variant access. The snapshot is refreshed whenever the item notifies its observers, which
+ * happens for changes made by the options menu, ++/--, reset and setValue (see ConfigItem::notify).
+ */
+template <typename T> class ConfigValue {
+	static_assert(std::is_same_v<T, bool> || std::is_same_v<T, unsigned short> || std::is_same_v<T, int> || std::is_same_v<T, float>,
+	  "ConfigValue supports bool, uint, int and float items");
+  public:
+	explicit ConfigValue(std::string const& name, ConfigItemMap& items = config): m_value(std::make_shared<std::atomic<T>>()) {
+		auto it = items.find(name);
+		if (it == items.end()) throw std::logic_error("Config item " + name + " used in C++ but missing from config schema");
+		m_item = &it->second;
+		if (m_item->getType() != typeName()) throw std::logic_error("Config item type mismatch: item=" + name + ", type=" + m_item->getType() + ", requested=" + typeName());
+		m_value->store(std::get<T>(m_item->value()), std::memory_order_relaxed);
+		// The observer only holds a weak reference, so handles may be destroyed before the item
+		std::weak_ptr<std::atomic<T>> weak = m_value;
+		m_item->observe([weak](ConfigItem const& item) {
+			auto value = weak.lock();
+			if (!value) return false;
+			value->store(std::get<T>(item.value()), std::memory_order_relaxed);
+			return true;
+		}, weak);
+	}
+	T get() const { return m_value->load(std::memory_order_relaxed); }
+	operator T() const { return get(); }
+	/// The underlying item, for UI code (descriptions, formatting, changing the value)
+	ConfigItem& item() const { return *m_item; }
+
+  private:
+	static char const* typeName() {
+		if constexpr (std::is_same_v<T, bool>) return "bool";
+		else if constexpr (std::is_same_v<T, unsigned short>) return "uint";
+		else if constexpr (std::is_same_v<T, int>) return "int";
+		else return "float";
+	}
+	ConfigItem* m_item;
+	std::shared_ptr<std::atomic<T>> m_value;
+};
@@ -5,15 +5,21 @@
 #include "portmidi.hh"
 
 #include <fmt/format.h>
+#include <porttime.h>
+#include <SDL_thread.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
 #include <regex>
+#include <thread>
 #include <unordered_map>
 
 namespace input {
 
 	class Midi: public Hardware {
 	public:
-		Midi() {
+		Midi(EventQueue& queue): m_queue(queue) {
 			std::regex re(config["game/midi_input"].s());
 			for (int dev = 0; dev < Pm_CountDevices(); ++dev) {
 				try {
@@ -29,36 +35,69 @@ namespace input {
 					SpdLogger::warn(LogSystem::CONTROLLERS, "MIDI device error: {}.", e.what());
 				}
 			}
+			if (!m_streams.empty()) m_thread = std::thread(&Midi::run, this);
 		}
 		std::string getName(int dev) const override {
 			PmDeviceInfo const* info = Pm_GetDeviceInfo(dev);
 			if (!info) throw std::logic_error("Invalid MIDI device requested in Midi::getName");
 			return fmt::format("{}: {}", dev, info->name);
 		}
-		bool process(Event& event) override {
-			PmEvent ev;
-			for (auto it = m_streams.begin(); it != m_streams.end();++it) {
-				if (Pm_Read(*it->second, &ev, 1) != 1) continue;
+		~Midi() override {
+			m_quit = true;
+			if (m_thread.joinable()) m_thread.join();
+		}
+	private:
+		/// Reader thread: drain everything pending on every wakeup, so that a burst of notes costs one wakeup, not one frame each.
+		/// PortMidi cannot block until input arrives, so polling backs off while idle. The events carry driver timestamps,
+		/// so a later wakeup only delays their delivery, not the time they are judged by.
+		void run() {
+			SDL_SetThreadPriority(SDL_THREAD_PRIORITY_HIGH);
+			auto const minWait = 1ms, maxWait = 8ms;
+			auto wait = minWait;
+			while (!m_quit) {
+				bool any = false;
+				for (auto& stream: m_streams) any |= read(stream.first, *stream.second);
+				if (any) { wait = minWait; continue; }
+				std::this_thread::sleep_for(wait);
+				wait = std::min(wait * 2, maxWait);
+			}
+			if (m_dropped) SpdLogger::warn(LogSystem::CONTROLLERS, "MIDI events dropped={} (controller event queue full).", m_dropped);
+		}
+		/// Read one batch from a stream, returns true if there were any events
+		bool read(unsigned dev, pm::Input& stream) {
+			PmEvent buf[64];
+			int const count = Pm_Read(stream, buf, 64);
+			if (count <= 0) return false;
+			// PortMidi stamps events with PortTime (milliseconds) when the driver receives them
+			std::uint32_t const ptNow = static_cast<std::uint32_t>(Pt_Time());
+			Time const now = Clock::now();
+			for (int i = 0; i < count; ++i) {
+				PmEvent const& ev = buf[i];
 				auto evnt = static_cast<unsigned char>(Pm_MessageStatus(ev.message) & 0xF0);
 				auto note = static_cast<unsigned char>(Pm_MessageData1(ev.message));
 				auto vel  = static_cast<unsigned char>(Pm_MessageData2(ev.message));
 				unsigned chan = (ev.message & 0x0F) + 1;  // It is conventional to use one-based indexing
 				if (evnt == 0x80 /* NOTE OFF */) { evnt = static_cast<unsigned char>(0x90); vel = 0; }  // Translate NOTE OFF into NOTE ON with zero-velocity
 				if (evnt != 0x90 /* NOTE ON */) continue;  // Ignore anything that isn't NOTE ON/OFF
-				SpdLogger::info(LogSystem::CONTROLLERS, "MIDI note ON/OFF event: ch={}, note={}, vel={}", chan, unsigned(note), unsigned(vel));
+				SpdLogger::debug(LogSystem::CONTROLLERS, "MIDI note ON/OFF event: ch={}, note={}, vel={}", chan, unsigned(note), unsigned(vel));
+				Event event;
+				event.time = deviceTime(static_cast<std::uint32_t>(ev.timestamp), ptNow, now);
 				event.value = vel / 127.0;
-				event.source = SourceId(SourceType::MIDI, it->first, chan);
+				event.source = SourceId(SourceType::MIDI, dev, chan);
 				event.hw = static_cast<unsigned>(note);
-				return true;
+				if (!m_queue.push(event)) ++m_dropped;
 			}
-			return false;
+			return true;
 		}
-	private:
 		pm::Initialize m_init;
 		std::unordered_map<unsigned, std::unique_ptr<pm::Input>> m_streams;
+		EventQueue& m_queue;
+		unsigned m_dropped = 0;
+		std::atomic<bool> m_quit{ false };
+		std::thread m_thread;
 	};
 
-	Hardware::ptr constructMidi() { return Hardware::ptr(new Midi()); }
+	Hardware::ptr constructMidi(EventQueue& queue) { return Hardware::ptr(new Midi(queue)); }
 	bool Hardware::midiEnabled() { return true; }
 }
 
@@ -67,7 +106,7 @@ namespace input {
 #include "controllers.hh"
 
 namespace input {
-	Hardware::ptr constructMidi() { return Hardware::ptr(); }
+	Hardware::ptr constructMidi(EventQueue&) { return Hardware::ptr(); }
 	bool Hardware::midiEnabled() { return false; }
 }
 
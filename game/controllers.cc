@@ -3,11 +3,11 @@
 #include "chrono.hh"
 #include "fs.hh"
 #include "libxml++.hh"
-#include "unicode.hh"
 
 #include <fmt/format.h>
 #include <SDL_joystick.h>
 #include <SDL_keyboard.h>
+#include <SDL_timer.h>
 
 #include <algorithm>
 #include <deque>
@@ -103,6 +103,10 @@ namespace input {
 		typedef std::map<SourceId, ControllerDef const*> Assignments;
 		Assignments m_assignments;
 	
+		// Declared before m_hw so that the queue outlives the hardware threads pushing to it
+		EventQueue m_incoming{ 1024 };
+		unsigned m_dropped = 0;
+
 		typedef std::map<SourceType, Hardware::ptr> HW;
 		HW m_hw;
 
@@ -125,7 +129,10 @@ namespace input {
 			readControllers(PathCache::getConfigDir() / "controllers.xml");
 			m_hw[SourceType::KEYBOARD] = constructKeyboard();
 			m_hw[SourceType::JOYSTICK] = constructJoysticks();
-			if (Hardware::midiEnabled()) m_hw[SourceType::MIDI] = constructMidi();
+			if (Hardware::midiEnabled()) m_hw[SourceType::MIDI] = constructMidi(m_incoming);
+		}
+		explicit Impl(std::map<SourceType, HardwareFactory> const& backends): m_eventsEnabled() {
+			for (auto const& [type, construct]: backends) m_hw[type] = construct(m_incoming);
 		}
 	
 		void readControllers(fs::path const& file) {
@@ -214,7 +221,7 @@ namespace input {
 		Button findButton(DevType type, std::string name) {
 			Button button = ButtonId::GENERIC_UNASSIGNED;
 			if (name.empty()) return button;
-			name = UnicodeUtil::toUpper(name);
+			name = toUpper(name);  // Button names are ASCII
 			std::replace( name.begin(), name.end(), '-', '_');
 			// Try getting button first from devtype-specific, then generic names
 			if (!buttonByName(type, name, button) && !buttonByName(DevType::GENERIC, name, button)) {
@@ -256,9 +263,10 @@ namespace input {
 					Event event;
 					event.time = now;
 					if (!typehw.second->process(event)) break;
-					pushHWEvent(event);
+					enqueue(event);
 				}
 			}
+			drain();
 			// Reset all key repeat timers if there is a latency spike
 			if (now - m_prevProcess > 50ms) {
 				for (auto& kv: m_navRepeat) kv.second.time = now;
@@ -282,11 +290,29 @@ namespace input {
 		bool pushEvent(SDL_Event const& sdlEv, Time t) {
 			for (auto& typehw: m_hw) {
 				Event event;
-				event.time = t;
-				if (typehw.second->process(event, sdlEv)) { pushHWEvent(event); return true; }
+				event.time = sdlCaptureTime(sdlEv, t);
+				if (typehw.second->process(event, sdlEv)) {
+					enqueue(event);
+					drain();
+					return true;
+				}
 			}
 			return false;
 		}
+		/// SDL stamps events in milliseconds of SDL_GetTicks when they arrive from the OS, which may be well before polling
+		static Time sdlCaptureTime(SDL_Event const& sdlEv, Time polled) {
+			if (sdlEv.common.timestamp == 0) return polled;  // Not stamped
+			return deviceTime(sdlEv.common.timestamp, SDL_GetTicks(), Clock::now());
+		}
+		/// Queue a hardware event to be handled by the next drain()
+		void enqueue(Event const& event) {
+			if (m_incoming.push(event)) return;
+			if (m_dropped++ % 100 == 0) SpdLogger::warn(LogSystem::CONTROLLERS, "Controller event queue full, dropped events={}.", m_dropped);
+		}
+		/// Handle all queued hardware events
+		void drain() {
+			for (Event event; m_incoming.pop(event); ) pushHWEvent(event);
+		}
 		/// Assign event's source a ControllerDef (if not already assigned) and return it
 		ControllerDef const* assign(Event const& event) {
 			// Attempt insertion (does not override existing values)
@@ -336,7 +362,7 @@ namespace input {
 		bool pushMappedEvent(Event& ev) {
 			if (ev.button == ButtonId::GENERIC_UNASSIGNED) return false;
 			if (!valueChanged(ev)) return false;  // Avoid repeated or other useless events
-			SpdLogger::info(LogSystem::CONTROLLERS, "Processing controller event {}.", ev);
+			SpdLogger::debug(LogSystem::CONTROLLERS, "Processing controller event {}.", ev);
 			ev.nav = navigation(ev);
 			// Emit nav event (except if device is currently registered for events)
 			if (ev.nav != NavButton::NONE) {
@@ -382,6 +408,7 @@ namespace input {
 
 	// External API simply wraps self (pImpl)
 	Controllers::Controllers(): self(new Controllers::Impl()) {}
+	Controllers::Controllers(std::map<SourceType, HardwareFactory> const& backends): self(new Controllers::Impl(backends)) {}
 	Controllers::~Controllers() {}
 	bool Controllers::getNav(NavEvent& ev) { return self->getNav(ev); }
 	DevicePtr Controllers::registerDevice(SourceId const& source) { return self->registerDevice(source); }
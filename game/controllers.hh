@@ -3,15 +3,19 @@
 #include "chrono.hh"
 #include "configuration.hh"
 #include "log.hh"
+#include "mpscqueue.hh"
 #include "util.hh"
 
 #include <fmt/format.h>
 #include <SDL_events.h>
 
+#include <algorithm>
 #include <climits>
 #include <cstdint>
 #include <deque>
+#include <functional>
 #include <iostream>
+#include <map>
 #include <memory>
 #include <optional>
 #include <stdexcept>
@@ -68,7 +72,7 @@ namespace input {
 		Button button; ///< Mapped button id
 		NavButton nav; ///< Navigational button interpretation
 		double value; ///< Zero for button release, up to 1.0 for press (e.g. velocity value), or axis value (-1.0 .. 1.0)
-		Time time; ///< When did the event occur
+		Time time; ///< When the hardware captured the event (minus device latency from controllers.xml)
 		DevType devType; ///< Device type
 		Event(): source(), hw(), nav(NavButton::NONE), value(), time(), devType() {}
 		bool pressed() const { return value != 0.0; }
@@ -76,6 +80,33 @@ namespace input {
 		std::string toString() const;
 	};
 
+	/// Events that arrived more than this before the frame are judged as if they arrived this much before it
+	constexpr Seconds maxEventAge = 250ms;
+
+	/**
+	* Song time at which an event was captured, for judging hits by when they happened rather than by the frame that
+	* processes them. Both clocks advance at the same rate, so the event is simply as much earlier on the song time
+	* of the frame as it was captured before the frame time. Events without a time are judged at the frame time.
+	*/
+	inline double captureSongTime(Event const& ev, double frameSongTime, Time frameTime) {
+		if (ev.time == Time()) return frameSongTime;
+		Seconds const age = std::clamp<Seconds>(frameTime - ev.time, 0s, maxEventAge);
+		return frameSongTime - age.count();
+	}
+
+	/**
+	* Map a device timestamp (in milliseconds of a wrapping device clock) onto Clock, given the device clock and Clock read
+	* at the same moment. Returns now for timestamps that are in the future or more than a second old (i.e. nonsense).
+	*/
+	inline Time deviceTime(std::uint32_t stampMs, std::uint32_t nowMs, Time now) {
+		std::uint32_t const age = nowMs - stampMs;  // Wraps correctly
+		if (age > 1000) return now;
+		return now - std::chrono::milliseconds(age);
+	}
+
+	/// Queue of hardware events from the backends (any thread) to Controllers
+	using EventQueue = MpscQueue<Event>;
+
 	/// NavEvent is a menu navigation event, generalized for all controller type so that the user doesn't need to know about controllers.
 	struct NavEvent {
 		SourceId source;
@@ -103,12 +134,18 @@ namespace input {
 	};
 	typedef std::shared_ptr<Device> DevicePtr;
 
+	class Hardware;
+	/// Constructs a backend, given the queue for events that it reads on a thread of its own
+	using HardwareFactory = std::function<std::shared_ptr<Hardware>(EventQueue&)>;
+
 	/// The main controller class that contains everything
 	class Controllers {
 	public:
 		Controllers(const Controllers&) = delete;
   		const Controllers& operator=(const Controllers&) = delete;
 		Controllers();
+		/// Use only the given backends and no controllers.xml, so that events are passed on as the backends map them
+		explicit Controllers(std::map<SourceType, HardwareFactory> const& backends);
 		~Controllers();
 		/// Return true and a nav event if there are any in queue. Otherwise return false.
 		bool getNav(NavEvent& ev);
@@ -146,7 +183,8 @@ namespace input {
 	
 	Hardware::ptr constructKeyboard();
 	Hardware::ptr constructJoysticks();
-	Hardware::ptr constructMidi();
+	/// MIDI events are read on a thread of its own and pushed directly to queue, which must outlive the Hardware
+	Hardware::ptr constructMidi(EventQueue& queue);
 }
 // Custom formatter for SDL_Keymod
 template <>
@@ -226,6 +226,7 @@ bool DanceGraph::difficulty(DanceDifficulty level, bool check_only) {
 	for (auto const& n: track.notes) m_notes.push_back(DanceNote(n));
 	std::sort(m_notes.begin(), m_notes.end(), lessEnd()); // for engine's iterators
 	m_notesIt = m_notes.begin();
+	m_visibleNotes.reset(m_notes.begin(), m_notes.end());
 	m_level = level;
 	for (auto& noteIt: m_activeNotes) noteIt = m_notes.end();
 	m_scoreFactor = 1;
@@ -237,7 +238,8 @@ bool DanceGraph::difficulty(DanceDifficulty level, bool check_only) {
 /// Handles input and some logic
 void DanceGraph::engine() {
 	double time = m_audio.getPosition();
-	time -= config["audio/controller_delay"].f();
+	Time const frameTime = Clock::now();
+	time -= m_controllerDelay;
 	doUpdates();
 	// Handle stops
 	bool outsideStop = true;
@@ -258,6 +260,7 @@ void DanceGraph::engine() {
 	bool difficulty_changed = false;
 	// Handle all events
 	for (input::Event ev; m_dev->getEvent(ev); ) {
+		double const stepTime = input::captureSongTime(ev, time, frameTime);  // Judge by when the arrow was actually stepped on
 		m_dead = 0; // Keep alive
 		// Menu keys
 		if (menuOpen() && ev.value != 0.0) {
@@ -283,11 +286,11 @@ void DanceGraph::engine() {
 			// Gaming controls
 			if (ev.value == 0.0) {
 				m_pressed[buttonId] = false;
-				dance(time, ev);
+				dance(stepTime, ev);
 				m_pressed_anim[buttonId].setTarget(0.0);
 			} else if (ev.value != 0.0) {
 				m_pressed[buttonId] = true;
-				dance(time, ev);
+				dance(stepTime, ev);
 				m_pressed_anim[buttonId].setValue(1.0);
 			}
 		}
@@ -377,16 +380,38 @@ namespace {
 			va.texCoord((arrow_i+1.0f) * one_arrow_tex_w, ty).vertex(arrowSize, y);
 		}
 	}
+
+	/// The quad of a single arrow; instances place and scale it and pick their part of the texture
+	glutil::VertexArray const& arrowQuad() {
+		static glutil::VertexArray const quad = [] {
+			glutil::VertexArray va;
+			vertexPair(va, -1.0f, -arrowSize, 0.0f);
+			vertexPair(va, -1.0f, arrowSize, 1.0f);
+			return va;
+		}();
+		return quad;
+	}
+
+	/// Queue a dance pad icon, arrow_i < 0 being a single thing in a texture (e.g. mine)
+	glutil::InstanceInfo& addArrow(glutil::InstanceArray& instances, float arrow_i, float x, float y, float scale, float ty1 = 0.0f, float ty2 = 1.0f) {
+		auto& instance = instances.add(x, y, 0.0f, scale);
+		if (arrow_i < 0.0f) instance.instTexRect = glmath::vec4(0.0f, ty1, 1.0f, ty2 - ty1);
+		else instance.instTexRect = glmath::vec4(arrow_i * one_arrow_tex_w, ty1, one_arrow_tex_w, ty2 - ty1);
+		return instance;
+	}
+
+	/// Hit arrows fade out as they grow
+	glmath::vec4 glowColor(double glow) { return glmath::vec4(1.0f, 1.0f, 1.0f, std::max(1.0f - static_cast<float>(glow), 0.0f)); }
 }
 
-/// Draw a dance pad icon using the given texture
-void DanceGraph::drawArrow(float arrow_i, Texture& tex, float ty1, float ty2) {
-	glActiveTexture(GL_TEXTURE0);
-	glBindTexture(tex.type(), tex.id());
-	glutil::VertexArray va;
-	vertexPair(va, arrow_i, -arrowSize, ty1);
-	vertexPair(va, arrow_i,  arrowSize, ty2);
-	va.draw();
+/// Draw the queued dance pad icons using the given texture
+void DanceGraph::drawArrows(glutil::InstanceArray& instances, Texture& tex) {
+	if (instances.empty()) return;
+	auto& window = m_game.getWindow();
+	UseTexture texture(window, tex);
+	UseShader shader(getShader(window, "texture_instanced"));
+	arrowQuad().draw(instances);
+	instances.clear();
 }
 
 /// Draws the dance graph
@@ -411,26 +436,25 @@ void DanceGraph::draw(double time) {
 		drawBeats(time);
 
 		// Arrows on cursor
-		{
-			UseShader us(getShader(window, "dancenote"));
-			m_uniforms.clock = static_cast<float>(time);
-			m_uniforms.noteType = 0;
-			m_uniforms.scale = getScale();
-			for (unsigned arrow_i = 0; arrow_i < m_pads; ++arrow_i) {
-				float l = static_cast<float>(m_pressed_anim[arrow_i].get());
-				m_uniforms.hitAnim = l;
-				m_uniforms.position = glmath::vec2(panel2x(static_cast<float>(arrow_i)), time2y(0.0));
-				glBufferSubData(GL_UNIFORM_BUFFER, m_uniforms.offset(), m_uniforms.size(), &m_uniforms);
-				drawArrow(static_cast<float>(arrow_i), m_arrows_cursor);
-			}
+		for (unsigned arrow_i = 0; arrow_i < m_pads; ++arrow_i) {
+			float l = static_cast<float>(m_pressed_anim[arrow_i].get());
+			addArrow(m_arrowInstances, static_cast<float>(arrow_i), panel2x(static_cast<float>(arrow_i)), time2y(0.0), getScale() * (1.0f - l * 0.5f));
 		}
+		drawArrows(m_arrowInstances, m_arrows_cursor);
 
-		// Draw the notes
+		// Draw the notes: all icons of a kind with one call, then the hold bodies and the texts on top of them
 		if (time == time) { // Check that time is not NaN
-			for (auto& n: m_notes) {
-				if (n.note.end - time < past) continue;
-				if (n.note.begin - time > future) continue;
-				drawNote(n, time); // Let's just do all the calculating in the sub, instead of passing them as a long list
+			m_visibleNotes.update(time + past, time + future);
+			auto visible = [&](DanceNote const& n) { return n.note.end - time >= past && n.note.begin - time <= future; };
+			for (auto& n: m_visibleNotes) {
+				if (visible(n)) drawNote(n, time); // Let's just do all the calculating in the sub, instead of passing them as a long list
+			}
+			drawArrows(m_arrowInstances, m_arrows);
+			drawArrows(m_mineInstances, m_mine);
+			drawArrows(m_holdInstances, m_arrows_hold);
+			drawHoldBodies(time);
+			for (auto& n: m_visibleNotes) {
+				if (visible(n)) drawNoteText(n, time);
 			}
 		}
 	}
@@ -459,9 +483,8 @@ void DanceGraph::drawBeats(double time) {
 	va.draw();
 }
 
-/// Draws a single note (or hold)
+/// Queues a single note (or hold) for drawing
 void DanceGraph::drawNote(DanceNote& note, double time) {
-	auto& window = m_game.getWindow();
 	double tBeg = note.note.begin - time;
 	double tEnd = note.note.end - time;
 	float arrow_i = note.note.note;
@@ -476,68 +499,77 @@ void DanceGraph::drawNote(DanceNote& note, double time) {
 		note.hitAnim.setTarget(1.0, false);
 	}
 	double glow = note.hitAnim.get();
+	float scale = getScale() * (1.0f + static_cast<float>(glow));
 
-	{
-		UseShader us(getShader(window, "dancenote"));
-		m_uniforms.hitAnim = static_cast<float>(glow);
-		m_uniforms.clock = static_cast<float>(time);
-		m_uniforms.scale = getScale();
-
-		if (yEnd - yBeg > arrowSize) {
-			// Draw holds
-			if (note.isHit && !note.releaseTime) { // The note is being held down
-				yBeg = std::max(time2y(0.0f), yBeg);
-				yEnd = std::max(time2y(0.0f), yEnd);
-			}
-			if (note.releaseTime) yBeg = time2y(note.releaseTime.value() - time); // Oh noes, it got released!
-			m_uniforms.noteType = 2;
-			m_uniforms.position = glmath::vec2(x, yBeg);
-			glBufferSubData(GL_UNIFORM_BUFFER, m_uniforms.offset(), m_uniforms.size(), &m_uniforms);
-			// Draw begin
-			drawArrow(arrow_i, m_arrows_hold, 0.0f, 1.0f/3.0f);
-			if (yEnd - yBeg > 0) {
-				glActiveTexture(GL_TEXTURE0);
-				glBindTexture(m_arrows_hold.type(), m_arrows_hold.id());
-				glutil::VertexArray va;
-				// Middle
-				vertexPair(va, arrow_i, arrowSize, 1.0f/3.0f);
-				float l = (yEnd - yBeg) / getScale();
-				float yMid = std::max(l-arrowSize, arrowSize);
-				vertexPair(va, arrow_i, yMid, 2.0f/3.0f);
-				// End
-				vertexPair(va, arrow_i, l, 1.0f);
-				va.draw();
-			}
-		} else {
-			// Draw short note
-			if (mine && note.isHit) yBeg = time2y(0.0);
-			m_uniforms.noteType = (mine ? 3 : 1);
-			m_uniforms.position = glmath::vec2(x, yBeg);
-			glBufferSubData(GL_UNIFORM_BUFFER, m_uniforms.offset(), m_uniforms.size(), &m_uniforms);
-			drawArrow((mine ? -1 : arrow_i), (mine ? m_mine : m_arrows));
+	if (yEnd - yBeg > arrowSize) {
+		// Draw holds
+		if (note.isHit && !note.releaseTime) { // The note is being held down
+			yBeg = std::max(time2y(0.0f), yBeg);
+			yEnd = std::max(time2y(0.0f), yEnd);
 		}
+		if (note.releaseTime) yBeg = time2y(note.releaseTime.value() - time); // Oh noes, it got released!
+		// Draw begin
+		addArrow(m_holdInstances, arrow_i, x, yBeg, scale, 0.0f, 1.0f/3.0f).instColor = glowColor(glow);
+		if (yEnd - yBeg > 0) m_holdBodies.push_back({ arrow_i, x, yBeg, yEnd, static_cast<float>(glow) });
+	} else if (mine) {
+		// Draw mine, they rotate!
+		if (note.isHit) yBeg = time2y(0.0);
+		addArrow(m_mineInstances, -1.0f, x, yBeg, scale).instParams.x = -static_cast<float>(TAU * (time - std::floor(time)));
+	} else {
+		// Draw short note
+		addArrow(m_arrowInstances, arrow_i, x, yBeg, scale).instColor = glowColor(glow);
+	}
+}
+
+/// Draws the middle and the end of the queued holds
+void DanceGraph::drawHoldBodies(double time) {
+	if (m_holdBodies.empty()) return;
+	auto& window = m_game.getWindow();
+	UseShader us(getShader(window, "dancenote"));
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(m_arrows_hold.type(), m_arrows_hold.id());
+	m_uniforms.clock = static_cast<float>(time);
+	m_uniforms.scale = getScale();
+	m_uniforms.noteType = 2;
+	for (auto const& hold: m_holdBodies) {
+		m_uniforms.hitAnim = hold.glow;
+		m_uniforms.position = glmath::vec2(hold.x, hold.yBeg);
+		glBufferSubData(GL_UNIFORM_BUFFER, m_uniforms.offset(), m_uniforms.size(), &m_uniforms);
+		glutil::VertexArray va;
+		// Middle
+		vertexPair(va, hold.arrow_i, arrowSize, 1.0f/3.0f);
+		float l = (hold.yEnd - hold.yBeg) / getScale();
+		float yMid = std::max(l-arrowSize, arrowSize);
+		vertexPair(va, hold.arrow_i, yMid, 2.0f/3.0f);
+		// End
+		vertexPair(va, hold.arrow_i, l, 1.0f);
+		va.draw();
 	}
+	m_holdBodies.clear();
+}
 
-	// Draw a text telling how well we hit
+/// Draws a text telling how well we hit a note
+void DanceGraph::drawNoteText(DanceNote& note, double time) {
+	if (note.note.type == Note::Type::MINE || !note.isHit) return;
+	double tBeg = note.note.begin - time;
+	double tEnd = note.note.end - time;
+	double glow = note.hitAnim.get();
 	double alpha = 1.0 - glow;
-	if (!mine && note.isHit) {
-		std::string text;
-		if (!note.releaseTime && tBeg < tEnd) { // Is being held down and is a hold note
-			text = "HOLD";
-			alpha = glow = 1.0;
-		} else if (glow > 0.0) { // Released already, display rank
-			text = note.score ? getRank(note.error) : "FAIL!";
-		}
-		if (!text.empty()) {
-			auto& window = m_game.getWindow();
-			double sc = getScale() * 0.6 * arrowSize * (3.0 + glow);
-			Transform trans(window, glmath::translate(glmath::vec3(0.0f, 0.0f, 0.5f * static_cast<float>(glow)))); // Slightly elevated
-			ColorTrans c(window, Color::alpha(static_cast<float>(std::sqrt(alpha))));
-			m_popupText->render(_(text));
-			m_popupText->dimensions().middle(x).center(time2y(0.0f)).stretch(static_cast<float>(sc), static_cast<float>(sc/2.0));
-			m_popupText->draw(window);
-		}
+	std::string text;
+	if (!note.releaseTime && tBeg < tEnd) { // Is being held down and is a hold note
+		text = "HOLD";
+		alpha = glow = 1.0;
+	} else if (glow > 0.0) { // Released already, display rank
+		text = note.score ? getRank(note.error) : "FAIL!";
 	}
+	if (text.empty()) return;
+	auto& window = m_game.getWindow();
+	double sc = getScale() * 0.6 * arrowSize * (3.0 + glow);
+	Transform trans(window, glmath::translate(glmath::vec3(0.0f, 0.0f, 0.5f * static_cast<float>(glow)))); // Slightly elevated
+	ColorTrans c(window, Color::alpha(static_cast<float>(std::sqrt(alpha))));
+	m_popupText->render(_(text));
+	m_popupText->dimensions().middle(panel2x(note.note.note)).center(time2y(0.0f)).stretch(static_cast<float>(sc), static_cast<float>(sc/2.0));
+	m_popupText->draw(window);
 }
 
 /// Draw popups and other info texts
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "instrumentgraph.hh"
+#include "notewindow.hh"
 
 #include <optional>
 
@@ -20,6 +21,13 @@ struct DanceNote {
 
 typedef std::vector<DanceNote> DanceNotes;
 
+/// DanceNotes are sorted by end time (see DanceGraph::difficulty)
+template <> struct NoteSpan<DanceNote> {
+	static double key(DanceNote const& n) { return n.note.end; }
+	static double begin(DanceNote const& n) { return n.note.begin; }
+	static double end(DanceNote const& n) { return n.note.end; }
+};
+
 /// handles drawing of notes
 class DanceGraph: public InstrumentGraph {
   public:
@@ -51,19 +59,30 @@ class DanceGraph: public InstrumentGraph {
 	void dance(double time, input::Event const& ev);
 	void drawBeats(double time);
 	void drawNote(DanceNote& note, double time);
+	void drawNoteText(DanceNote& note, double time);
+	void drawHoldBodies(double time);
 	void drawInfo(double time, Dimensions dimensions);
-	void drawArrow(float arrow_i, Texture& tex, float ty1 = 0.0f, float ty2 = 1.0f);
+	void drawArrows(glutil::InstanceArray& instances, Texture& tex);
 
 	// Helpers
 	float panel2x(float f) const { return getScale() * (-(static_cast<float>(m_pads) * 0.5f) + m_arrow_map[static_cast<unsigned>(f)] + 0.5f); } /// Get x for an arrow line
 	float getScale() const { return 1.0f / static_cast<float>(m_pads) * 8.0f; }
 	double getNotesBeginTime() const { return m_notes.front().note.begin; }
 	glutil::danceNoteUniforms m_uniforms;
+	/// The stretchy part of a hold, drawn after all the arrows
+	struct HoldBody {
+		float arrow_i, x, yBeg, yEnd, glow;
+	};
+	std::vector<HoldBody> m_holdBodies;
+	glutil::InstanceArray m_arrowInstances; /// arrows (or cursor arrows) queued by drawNote, drawn with one call
+	glutil::InstanceArray m_holdInstances; /// heads of holds
+	glutil::InstanceArray m_mineInstances;
 
 	// Note stuff
 	DanceNotes m_notes; /// contains the dancing notes for current game mode and difficulty
 	DanceNotes::iterator m_notesIt; /// the first note that hasn't gone away yet
 	DanceNotes::iterator m_activeNotes[max_panels]; /// hold notes that are currently pressed down
+	NoteWindow<DanceNotes::iterator> m_visibleNotes; /// notes on screen
 
 	// Textures
 	Texture m_beat;
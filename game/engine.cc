@@ -5,13 +5,15 @@
 #include "song.hh"
 #include "database.hh"
 #include "configuration.hh"
+#include "fs.hh"
+#include "profiler.hh"
+#include "recorder.hh"
+#include <cmath>
 #include <iostream>
 #include <list>
 
-const double Engine::TIMESTEP = 0.01;
-
 Engine::Engine(Audio& audio, VocalTrackPtrs vocals, Database& database):
-  m_audio(audio), m_time(), m_quit(), m_database(database)
+  m_audio(audio), m_database(database)
 {
 	auto& analyzers = m_audio.analyzers();
 	if (analyzers.size() != vocals.size()) throw std::logic_error("Engine requires the same number of vocal tracks as there are analyzers.");
@@ -25,17 +27,38 @@ Engine::Engine(Audio& audio, VocalTrackPtrs vocals, Database& database):
 		m_database.cur.push_back(Player(*vocals[i], a, frames));
 		++i;
 	}
+	if (config["audio/record_mics"].b() && !analyzers.empty()) {
+		// Mic input arriving now was sung a round trip ago
+		double const songTime = m_audio.getPosition() - m_roundTrip;
+		m_recorder = std::make_unique<Recorder>(analyzers, PathCache::getDataDir() / "recordings", std::isfinite(songTime) ? songTime : 0.0);
+	}
 	m_thread.reset(new std::thread(std::ref(*this)));
 }
 
+Engine::~Engine() {
+	kill();
+}
+
 void Engine::operator()() {
+	Profiler prof("engine");
 	while (!m_quit) {
 		for (Player& player: m_database.cur) player.prepare();
-		double t = m_audio.getPosition() - config["audio/round-trip"].f();
-		double timeLeft = m_time - t;
-		if (timeLeft != timeLeft || timeLeft > 1.0) timeLeft = 1.0;  // FIXME: Workaround for NaN values and other weirdness (should fix the weirdness instead)
-		if (timeLeft > 0.0) { std::this_thread::sleep_for(std::min(TIMESTEP, timeLeft) * 1s); continue; }
-		for (Player& player: m_database.cur) player.update();
-		m_time += TIMESTEP;
+		if (m_audio.isPaused()) {
+			// The clock stands still, so there is nothing to do but keep the analyzers drained
+			std::this_thread::sleep_for(50ms);
+			continue;
+		}
+		double const t = m_audio.getPosition() - m_roundTrip;  // NaN while no song is playing
+		auto const batch = m_scheduler.take(t);
+		if (batch.steps == 0) {
+			// Woken up by new mic input, or at the latest when the next step is due
+			m_audio.waitForInput(m_scheduler.wait(t) * 1s);
+			continue;
+		}
+		for (unsigned i = 0; i < batch.steps; ++i) {
+			for (Player& player: m_database.cur) player.update();
+		}
+		prof.add("step lag", batch.lag);
+		if (batch.steps > 1) prof.add("catch-up", batch.lag);
 	}
 }
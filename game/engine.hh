@@ -1,5 +1,8 @@
 #pragma once
 
+#include "configvalue.hh"
+#include "stepscheduler.hh"
+
 #include <atomic>
 #include <memory>
 #include <thread>
@@ -7,22 +10,28 @@
 
 class Audio;
 class Database;
+class Recorder;
 class VocalTrack;
 
 /// performous engine
 class Engine {
+  public:
+	static constexpr double TIMESTEP = 0.01;  ///< The duration of one engine time step in seconds
+
+  private:
 	Audio& m_audio;
-	double m_time;
+	StepScheduler m_scheduler{ TIMESTEP };  ///< Paces the steps by the audio position
+	ConfigValue<float> m_roundTrip{ "audio/round-trip" };
 	std::atomic<bool> m_quit{ false };
 	Database& m_database;
 	std::unique_ptr<std::thread> m_thread;
+	std::unique_ptr<Recorder> m_recorder;  ///< Mic recording, if enabled in config
 
   public:
 	typedef std::vector<VocalTrack*> VocalTrackPtrs;
-	static const double TIMESTEP;  ///< The duration of one engine time step in seconds
 	/// Construct an engine thread with vocal tracks and players specified by parameters
 	Engine(Audio& audio, VocalTrackPtrs vocals, Database& database);
-	~Engine() { kill(); }
+	~Engine();
 	/// Terminates processing
 	void kill() { 
 		m_quit = true;
@@ -201,6 +201,26 @@ AudioBuffer::AudioBuffer(fs::path const& file, unsigned rate, size_t size):
 		});
 }
 
+std::vector<float> decodeAudio(fs::path const& file, unsigned rate) {
+	std::vector<float> pcm;
+	AudioFFmpeg ffmpeg(file, static_cast<int>(rate), [&pcm](const std::int16_t *data, std::int64_t count, std::int64_t sample_position) {
+		if (sample_position < 0) return;
+		auto const pos = static_cast<std::size_t>(sample_position);
+		if (pcm.size() < pos + static_cast<std::size_t>(count)) pcm.resize(pos + static_cast<std::size_t>(count));  // Any gap stays silent
+		for (std::int64_t i = 0; i < count; ++i) pcm[pos + static_cast<std::size_t>(i)] = da::conv_from_s16(data[i]);
+	});
+	try {
+		while (true) ffmpeg.handleOneFrame();
+	} catch (const FFmpeg::Eof&) {}
+	// Same gain as AudioBuffer::read would apply
+	if (ffmpeg.getReplayGainInDecibels() != 0.0) {
+		auto const gain = static_cast<float>(ffmpeg.getReplayGainVolumeFactor());
+		for (float& s: pcm) s *= gain;
+	}
+	pcm.shrink_to_fit();
+	return pcm;
+}
+
 AudioBuffer::~AudioBuffer() {
 	{
 		std::unique_lock<std::mutex> l(m_mutex);
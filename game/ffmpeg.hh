@@ -137,6 +137,9 @@ class VideoFFmpeg : public FFmpeg {
 
 };
 
+/// Decode a whole audio file into interleaved stereo float PCM at the given rate, with replay gain applied (for short sound effects)
+std::vector<float> decodeAudio(fs::path const& file, unsigned rate);
+
 class AudioBuffer {
   public:
 	using uFvec = std::unique_ptr<fvec_t, std::integral_constant<decltype(&del_fvec), &del_fvec>>;
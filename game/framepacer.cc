@@ -0,0 +1,92 @@
+#include "framepacer.hh"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+void FrameHistogram::add(double seconds, bool missed) {
+	auto const bin = static_cast<std::size_t>(std::max(0.0, seconds) / binWidth);
+	++m_bins[std::min(bin, m_bins.size() - 1)];
+	++m_frames;
+	if (missed) ++m_missed;
+}
+
+double FrameHistogram::percentile(double fraction) const {
+	if (m_frames == 0) return 0.0;
+	auto const wanted = std::max(1.0, std::ceil(fraction * static_cast<double>(m_frames)));
+	unsigned long count = 0;
+	for (std::size_t i = 0; i < m_bins.size(); ++i) {
+		count += m_bins[i];
+		if (static_cast<double>(count) >= wanted) return static_cast<double>(i + 1) * binWidth;
+	}
+	return static_cast<double>(m_bins.size()) * binWidth;
+}
+
+void FramePacer::configure(Settings const& settings) {
+	if (m_period > 0.0 && settings == m_settings) return;
+	m_settings = settings;
+	double const refresh = settings.refreshRate > 0.0 ? settings.refreshRate : 60.0;
+	double const target = settings.maxFps > 0.0 ? settings.maxFps : refresh;
+	m_swapInterval = 0;
+	m_vsyncPaced = false;
+	m_period = 1.0 / target;
+	if (settings.vsync) {
+		// Swapping every n vsyncs gives the target rate if it divides the refresh rate (a higher rate is not possible)
+		double const ratio = refresh / target;
+		int const n = std::max(1, static_cast<int>(std::lround(ratio)));
+		m_swapInterval = 1;
+		bool const supported = settings.maxSwapInterval <= 0 || n <= settings.maxSwapInterval;
+		if (supported && (ratio < 1.0 || std::abs(ratio - n) < 0.05 * n)) {
+			m_swapInterval = n;
+			m_vsyncPaced = true;
+			m_period = n / refresh;
+		}
+	}
+	m_frameStart.reset();
+}
+
+Time FramePacer::wakeUp(Time now) const {
+	if (m_vsyncPaced) {
+		if (!m_settings.lateLatch || !m_presented) return now;
+		// Leave time for processing the frame as long as recent frames took, plus a millisecond to spare
+		double const lead = std::min(m_period, m_work + 0.001);
+		return *m_presented + clockDur(Seconds(m_period - lead));
+	}
+	if (!m_frameStart) return now;
+	return *m_frameStart + clockDur(Seconds(m_period));
+}
+
+void FramePacer::begin(Time when) {
+	m_begin = when;
+	if (m_vsyncPaced) return;
+	// Stay on the grid unless more than a frame late (then start a new grid instead of hurrying to catch up)
+	auto const period = clockDur(Seconds(m_period));
+	Time const next = m_frameStart ? *m_frameStart + period : when;
+	m_frameStart = (when - next < period ? next : when);
+}
+
+void FramePacer::rendered(Time when) {
+	double const work = Seconds(when - m_begin).count();
+	m_work = std::max(work, m_work * 0.98);
+}
+
+void FramePacer::presented(Time when, std::string const& screen) {
+	if (m_presented) {
+		double const interval = Seconds(when - *m_presented).count();
+		m_histograms[screen].add(interval, interval > 1.5 * m_period);
+	}
+	m_presented = when;
+}
+
+std::string FramePacer::report() const {
+	std::string ret;
+	for (auto const& [screen, histogram]: m_histograms) {
+		if (histogram.frames() == 0) continue;
+		fmt::format_to(std::back_inserter(ret), "{}: frames={}, p50={:.2f} ms, p95={:.2f} ms, p99={:.2f} ms, missed={}\n", screen,
+		  histogram.frames(), histogram.percentile(0.50) * 1000.0, histogram.percentile(0.95) * 1000.0, histogram.percentile(0.99) * 1000.0,
+		  histogram.missed());
+	}
+	return ret;
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "chrono.hh"
+
+#include <array>
+#include <map>
+#include <optional>
+#include <string>
+
+/// Distribution of frame times, in quarter millisecond bins up to 100 ms (longer frames go to the last bin)
+class FrameHistogram {
+  public:
+	/// Add a frame that took the given time (seconds)
+	void add(double seconds, bool missed);
+	unsigned long frames() const { return m_frames; }
+	unsigned long missed() const { return m_missed; }
+	/// The time (seconds) that the given fraction of frames took at most, e.g. 0.95 for p95; zero if there are no frames
+	double percentile(double fraction) const;
+
+  private:
+	static constexpr double binWidth = 0.00025;
+	std::array<unsigned long, 400> m_bins{};
+	unsigned long m_frames = 0;
+	unsigned long m_missed = 0;
+};
+
+/**
+ * Decides when the main loop starts a frame. With vsync at the target rate the buffer swap paces the frames and the
+ * pacer does not wait at all, except for late latching: starting the frame only as long before the next vsync as it
+ * has recently taken to process one, so that the audio clock and controller events read while drawing are as fresh
+ * as possible when the frame is shown. Otherwise frames start on a fixed grid of the target period.
+ *
+ * All times are passed in by the caller, so that the pacer can be driven by a fake clock.
+ */
+class FramePacer {
+  public:
+	struct Settings {
+		double refreshRate = 60.0;  ///< Display refresh rate (Hz)
+		bool vsync = true;  ///< Whether buffer swaps wait for vsync
+		double maxFps = 0.0;  ///< Target frame rate, zero for the display refresh rate
+		bool lateLatch = false;  ///< Start frames as late as possible before vsync
+		int maxSwapInterval = 0;  ///< Largest swap interval the driver accepts, zero for no limit
+		bool operator==(Settings const& other) const {
+			return refreshRate == other.refreshRate && vsync == other.vsync && maxFps == other.maxFps && lateLatch == other.lateLatch
+			  && maxSwapInterval == other.maxSwapInterval;
+		}
+	};
+	FramePacer() { configure(Settings()); }
+	explicit FramePacer(Settings const& settings) { configure(settings); }
+	/// Change settings; call every frame, only actual changes have an effect
+	void configure(Settings const& settings);
+	/// Number of vsyncs per buffer swap (0 for no vsync)
+	int swapInterval() const { return m_swapInterval; }
+	/// Time between frames (seconds)
+	double period() const { return m_period; }
+	/// When to start the next frame, as called after presenting one (a time in the past means now)
+	Time wakeUp(Time now) const;
+	/// The frame started (woke up) at the given time
+	void begin(Time when);
+	/// The frame was drawn and is about to be presented (just before the buffer swap)
+	void rendered(Time when);
+	/// The buffer swap of a frame of the named screen returned at the given time
+	void presented(Time when, std::string const& screen);
+	/// Frame times of the named screen so far
+	FrameHistogram const& histogram(std::string const& screen) { return m_histograms[screen]; }
+	/// One line per screen with its frame time percentiles and missed frames
+	std::string report() const;
+
+  private:
+	Settings m_settings;
+	int m_swapInterval = 0;
+	double m_period = 0.0;
+	bool m_vsyncPaced = false;  ///< The buffer swap waits for the next frame
+	std::optional<Time> m_frameStart;  ///< Grid time of the current frame
+	std::optional<Time> m_presented;  ///< When the previous frame was presented
+	Time m_begin;  ///< When the current frame started processing
+	double m_work = 0.0;  ///< Recent processing time of a frame (decaying peak, seconds)
+	std::map<std::string, FrameHistogram> m_histograms;
+};
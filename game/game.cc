@@ -1,6 +1,7 @@
 #include "game.hh"
 
 #include "audio.hh"
+#include "chrono.hh"
 #include "configuration.hh"
 #include "fs.hh"
 #include "graphic/glutil.hh"
@@ -16,7 +17,7 @@
 Game::Game(Window& window):
   m_window(window),
   m_messagePopup(0.0, 1.0), m_textMessage(findFile("message_text.svg"), config["graphic/text_lod"].f()),
-  m_loadingProgress(0.0f), m_logo(findFile("logo.svg")), m_logoAnim(0.0, 0.5)
+  m_loadingProgress(0.0f), m_logo(findFile("logo.svg")), m_logoAnim(0.0, 0.5), m_mainThread(std::this_thread::get_id())
 {
 	SpdLogger::notice(LogSystem::AUDIO, "Starting the audio subsystem (errors printed on console may be ignored).");
 	m_textMessage.dimensions.middle().center(-0.05f);
@@ -37,11 +38,25 @@ void Game::updateScreen() {
 }
 
 Screen* Game::getScreen(std::string const& name) {
-	auto it = screens.find(name);
-	if (it != screens.end()){
-		return it->second.get();
+	std::function<std::unique_ptr<Screen>()> factory;
+	{
+		std::lock_guard<std::mutex> l(m_screensMutex);
+		auto it = screens.find(name);
+		if (it != screens.end()){
+			return it->second.get();
+		}
+		auto f = screenFactories.find(name);
+		if (f == screenFactories.end()) throw std::invalid_argument("Screen " + name + " does not exist");
+		factory = f->second;
 	}
-	throw std::invalid_argument("Screen " + name + " does not exist");
+	if (std::this_thread::get_id() != m_mainThread) throw std::logic_error("Screen " + name + " must be created on the main thread before use");
+	// Constructed without the lock, as screens may look up other screens
+	auto const begin = Clock::now();
+	std::unique_ptr<Screen> s = factory();
+	SpdLogger::debug(LogSystem::LOGGER, "Created screen={} in {:.3f}s", name, Seconds(Clock::now() - begin).count());
+	std::lock_guard<std::mutex> l(m_screensMutex);
+	screenFactories.erase(name);
+	return screens.insert(std::make_pair(name, std::move(s))).first->second.get();
 }
 
 void Game::prepareScreen() {
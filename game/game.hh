@@ -1,7 +1,11 @@
 #pragma once
 
+#include <functional>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 
 #include "animvalue.hh"
 #include "opengl_text.hh"
@@ -19,8 +23,14 @@ class Game {
 	~Game();
 	/// Adds a screen to the manager
 	void addScreen(std::unique_ptr<Screen> s) {
+		std::lock_guard<std::mutex> l(m_screensMutex);
 		screens.insert(std::make_pair(s->getName(), std::move(s)));
 	}
+	/// Adds a screen that is only constructed when first used (see getScreen)
+	void addScreen(std::string const& name, std::function<std::unique_ptr<Screen>()> factory) {
+		std::lock_guard<std::mutex> l(m_screensMutex);
+		screenFactories[name] = std::move(factory);
+	}
 	/// Switches active screen
 	void activateScreen(std::string const& name);
 	/// Does actual switching of screens (if necessary)
@@ -33,7 +43,11 @@ class Game {
 	void reloadGL() { if (currentScreen) currentScreen->reloadGL(); }
 	/// Returns pointer to current Screen
 	Screen* getCurrentScreen() { return currentScreen; }
-	/// Returns pointer to Screen for given name
+	/**
+	 * Returns pointer to Screen for given name, constructing it if it was added with a factory and not used yet.
+	 * May be called from any thread, but screens are only constructed on the main (GL) thread: the screens that other
+	 * threads look up (Songs by the audio, Playlist by the webserver) are constructed in the "screens" startup stage.
+	 */
 	Screen* getScreen(std::string const& name);
 	/// Returns a reference to the window
 	Window& window() { return m_window; }
@@ -84,6 +98,8 @@ private:
 	bool m_finished = false;
 	typedef std::map<std::string, std::unique_ptr<Screen>> screenmap_t;
 	screenmap_t screens;
+	std::map<std::string, std::function<std::unique_ptr<Screen>()>> screenFactories;
+	std::mutex m_screensMutex;  ///< Guards screens and screenFactories
 	Screen* newScreen = nullptr;
 	Screen* currentScreen = nullptr;
 	PlayList currentPlaylist;
@@ -97,6 +113,7 @@ private:
 	float m_loadingProgress;
 	Texture m_logo;
 	AnimValue m_logoAnim;
+	std::thread::id const m_mainThread;  ///< Where the game was created; screens are only constructed there
 	AnimValue m_dialogTimeOut;
 	// Dialog members
 	std::unique_ptr<Dialog> m_dialog;
@@ -0,0 +1,246 @@
+#include "frame_capture.hh"
+
+#include "configuration.hh"
+#include "log.hh"
+#include "platform.hh"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <utility>
+
+#if (BOOST_OS_WINDOWS)
+#define popen _popen
+#define pclose _pclose
+#endif
+
+FrameCapture::FrameCapture(fs::path folder): m_folder(std::move(folder)), m_thread(&FrameCapture::run, this) {}
+
+FrameCapture::~FrameCapture() {
+	// Deliver everything already read back, then let the encoder drain its queue
+	collect(true);
+	if (m_recording) toggleRecording();
+	{
+		std::lock_guard<std::mutex> l(m_mutex);
+		m_quit = true;
+	}
+	m_condition.notify_one();
+	m_thread.join();
+	for (auto& slot: m_slots) {
+		if (slot.fence) glDeleteSync(slot.fence);
+		if (slot.pbo) glDeleteBuffers(1, &slot.pbo);
+	}
+}
+
+void FrameCapture::screenshot() {
+	m_screenshot = true;
+}
+
+bool FrameCapture::toggleRecording() {
+	if (m_recording) {
+		m_recording = false;
+		collect(true);
+		Job job;
+		job.kind = Kind::RECORDING;
+		job.finish = true;
+		push(std::move(job));
+		if (m_dropped) SpdLogger::notice(LogSystem::OPENGL, "Recording dropped {} frames because the encoder could not keep up.", m_dropped);
+		return false;
+	}
+	m_recording = true;
+	m_fps = std::max<unsigned>(1, config["graphic/capture_fps"].ui());
+	m_ffmpeg = config["graphic/capture_ffmpeg"].b();
+	m_nextFrame = Clock::now();
+	m_dropped = 0;
+	return true;
+}
+
+void FrameCapture::frame(unsigned width, unsigned height) {
+	collect(false);
+	if (width == 0 || height == 0) return;
+	if (m_screenshot) {
+		m_screenshot = false;
+		Slot& slot = m_slots[m_next];
+		if (slot.fence) collect(true);  // Never skip a screenshot, even if the ring is full
+		if (slot.fence) {
+			// The GPU did not finish that readback within the timeout, give it up rather than leak its fence
+			glDeleteSync(slot.fence);
+			slot.fence = nullptr;
+			if (slot.kind == Kind::RECORDING) ++m_dropped;
+			else SpdLogger::error(LogSystem::OPENGL, "Screenshot dropped, its readback did not finish in time.");
+		}
+		read(slot, width, height, Kind::SCREENSHOT);
+	}
+	auto const now = Clock::now();
+	if (m_recording && now >= m_nextFrame) {
+		auto const period = clockDur(Seconds(1.0 / m_fps));
+		m_nextFrame += period;
+		if (m_nextFrame < now) m_nextFrame = now + period;  // Fell behind (e.g. loading screen), don't try to catch up
+		Slot& slot = m_slots[m_next];
+		if (slot.fence) ++m_dropped;  // The GPU is still busy with all slots, skip this frame rather than stall
+		else read(slot, width, height, Kind::RECORDING);
+	}
+}
+
+void FrameCapture::read(Slot& slot, unsigned width, unsigned height, Kind kind) {
+	std::size_t const bytes = std::size_t(width) * height * 3;
+	if (!slot.pbo) glGenBuffers(1, &slot.pbo);
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+	if (slot.size != bytes) {
+		glBufferData(GL_PIXEL_PACK_BUFFER, static_cast<GLsizeiptr>(bytes), nullptr, GL_STREAM_READ);
+		slot.size = bytes;
+	}
+	// Tightly packed rows, as expected by both writePNG and ffmpeg rawvideo
+	glPixelStorei(GL_PACK_ALIGNMENT, 1);
+	glReadPixels(0, 0, static_cast<GLsizei>(width), static_cast<GLsizei>(height), GL_RGB, GL_UNSIGNED_BYTE, nullptr);
+	glPixelStorei(GL_PACK_ALIGNMENT, 4);
+	slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+	slot.width = width;
+	slot.height = height;
+	slot.kind = kind;
+	m_next = (m_next + 1) % slotCount;
+}
+
+void FrameCapture::collect(bool wait) {
+	// Oldest first, so that recorded frames reach the encoder in order
+	for (std::size_t i = 0; i < slotCount; ++i) {
+		Slot& slot = m_slots[(m_next + i) % slotCount];
+		if (!slot.fence) continue;
+		GLenum const status = glClientWaitSync(slot.fence, wait ? GL_SYNC_FLUSH_COMMANDS_BIT : 0, wait ? GLuint64(1e9) : 0);
+		if (status == GL_TIMEOUT_EXPIRED) {
+			if (wait) continue;
+			return;  // Later slots cannot be ready either
+		}
+		glDeleteSync(slot.fence);
+		slot.fence = nullptr;
+		if (status == GL_WAIT_FAILED) {
+			SpdLogger::error(LogSystem::OPENGL, "Frame capture readback failed.");
+			continue;
+		}
+		Job job;
+		job.kind = slot.kind;
+		job.fps = m_fps;
+		job.ffmpeg = m_ffmpeg;
+		Bitmap& img = job.bitmap;
+		img.width = slot.width;
+		img.height = slot.height;
+		img.fmt = pix::Format::RGB;
+		img.linearPremul = true; // Not really, but this will use correct gamma.
+		img.bottomFirst = true;
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+		auto const* data = static_cast<unsigned char const*>(glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, static_cast<GLsizeiptr>(slot.size), GL_MAP_READ_BIT));
+		if (data) {
+			img.buf.assign(data, data + slot.size);
+			glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+		}
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+		if (!data) SpdLogger::error(LogSystem::OPENGL, "Frame capture could not map the pixel buffer.");
+		else push(std::move(job));
+	}
+}
+
+void FrameCapture::push(Job&& job) {
+	{
+		std::lock_guard<std::mutex> l(m_mutex);
+		if (job.kind == Kind::RECORDING && !job.finish && m_jobs.size() >= maxQueue) {
+			++m_dropped;
+			return;
+		}
+		m_jobs.push_back(std::move(job));
+	}
+	m_condition.notify_one();
+}
+
+void FrameCapture::run() {
+	while (true) {
+		Job job;
+		{
+			std::unique_lock<std::mutex> l(m_mutex);
+			m_condition.wait(l, [this]{ return m_quit || !m_jobs.empty(); });
+			if (m_jobs.empty()) break;  // Quit only once everything has been written
+			job = std::move(m_jobs.front());
+			m_jobs.pop_front();
+		}
+		try {
+			encode(job);
+		} catch (std::exception const& e) {
+			SpdLogger::error(LogSystem::IMAGE, "Frame capture failed, exception={}", e.what());
+		}
+	}
+	if (m_pipe) pclose(m_pipe);
+}
+
+void FrameCapture::encode(Job& job) {
+	Bitmap const& img = job.bitmap;
+	if (job.kind == Kind::SCREENSHOT) {
+		fs::path const filename = nextFilename(".png");
+		writePNG(filename, img);
+		SpdLogger::info(LogSystem::OPENGL, "Screenshot taken, file={} ({}x{}).", filename, img.width, img.height);
+		return;
+	}
+	if (job.finish) {
+		if (m_pipe) pclose(m_pipe);
+		if (m_pipe || !m_sequence.empty()) SpdLogger::info(LogSystem::OPENGL, "Recording finished.");
+		m_pipe = nullptr;
+		m_sequence.clear();
+		return;
+	}
+	if (!job.ffmpeg) {
+		if (m_sequence.empty()) {
+			m_sequence = nextFilename("");
+			fs::create_directories(m_sequence);
+			m_sequenceFrame = 0;
+			SpdLogger::info(LogSystem::OPENGL, "Recording to image sequence, folder={}", m_sequence);
+		}
+		writePNG(m_sequence / fmt::format("frame_{:06}.png", ++m_sequenceFrame), img);
+		return;
+	}
+	if (!m_pipe) {
+		fs::path const filename = nextFilename(".mp4");
+		// Frames are bottom row first and yuv420p needs even dimensions
+		std::string const command = fmt::format(
+		  "ffmpeg -loglevel error -y -f rawvideo -pixel_format rgb24 -video_size {}x{} -framerate {} -i - "
+		  "-vf vflip,scale=trunc(iw/2)*2:trunc(ih/2)*2 -c:v libx264 -preset veryfast -pix_fmt yuv420p \"{}\"",
+		  img.width, img.height, job.fps, filename.string());
+#if !(BOOST_OS_WINDOWS)
+		m_pipe = popen(command.c_str(), "w");
+#else
+		m_pipe = popen(command.c_str(), "wb");
+#endif
+		if (!m_pipe) throw std::runtime_error("Unable to start ffmpeg: " + command);
+		m_pipeWidth = img.width;
+		m_pipeHeight = img.height;
+		SpdLogger::info(LogSystem::OPENGL, "Recording to video, file={} ({}x{} at {} FPS)", filename, img.width, img.height, job.fps);
+	}
+	if (img.width != m_pipeWidth || img.height != m_pipeHeight) {
+		SpdLogger::debug(LogSystem::OPENGL, "Recording skipped a frame of different size ({}x{}).", img.width, img.height);
+		return;
+	}
+	if (std::fwrite(img.data(), 1, img.buf.size(), m_pipe) != img.buf.size()) {
+		pclose(m_pipe);
+		m_pipe = nullptr;
+		throw std::runtime_error("Writing to ffmpeg failed, recording stopped");
+	}
+}
+
+fs::path FrameCapture::nextFilename(std::string const& suffix) {
+	std::string const prefix = "Performous_";
+	// Find the highest number in use once, instead of probing every file name
+	if (!m_numbered) {
+		m_numbered = true;
+		std::error_code error;
+		for (auto const& entry: fs::directory_iterator(m_folder, error)) {
+			std::string const name = entry.path().filename().string();
+			if (name.compare(0, prefix.size(), prefix) != 0) continue;
+			unsigned number = 0;
+			for (auto it = name.begin() + static_cast<std::ptrdiff_t>(prefix.size()); it != name.end() && std::isdigit(static_cast<unsigned char>(*it)); ++it) {
+				number = number * 10 + static_cast<unsigned>(*it - '0');
+			}
+			m_lastNumber = std::max(m_lastNumber, number);
+		}
+	}
+	return m_folder / (prefix + std::to_string(++m_lastNumber) + suffix);
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "chrono.hh"
+#include "fs.hh"
+#include "image.hh"
+
+#include <epoxy/gl.h>
+
+#include <array>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+/// Asynchronous readback of rendered frames for screenshots and continuous capture (recording).
+/// Frames are read into a ring of pixel buffer objects and only mapped once the GPU has finished with them,
+/// and a worker thread does all encoding and disk I/O, so the render loop never waits for either.
+class FrameCapture {
+  public:
+	/// Files are written into folder (the home folder by default) as Performous_N
+	explicit FrameCapture(fs::path folder = PathCache::getHomeDir());
+	~FrameCapture();
+	FrameCapture(FrameCapture const&) = delete;
+	FrameCapture& operator=(FrameCapture const&) = delete;
+	/// Capture the next rendered frame as a PNG in the home folder
+	void screenshot();
+	/// Start or stop recording. Frames are captured at graphic/capture_fps either as a numbered PNG sequence or,
+	/// if graphic/capture_ffmpeg is set, piped into an ffmpeg process. Returns true if recording is now active.
+	bool toggleRecording();
+	bool recording() const { return m_recording; }
+	/// Call after rendering each frame (before swapping buffers) with the size of the drawable area.
+	void frame(unsigned width, unsigned height);
+
+  private:
+	enum class Kind { SCREENSHOT, RECORDING };
+	/// A pending readback into one of the pixel buffer objects
+	struct Slot {
+		GLuint pbo = 0;
+		GLsync fence = nullptr;
+		std::size_t size = 0;  ///< Allocated size of the buffer
+		unsigned width = 0, height = 0;
+		Kind kind = Kind::SCREENSHOT;
+	};
+	/// Work item for the encoder thread
+	struct Job {
+		Kind kind = Kind::SCREENSHOT;
+		Bitmap bitmap;
+		unsigned fps = 0;  ///< Recording frame rate
+		bool ffmpeg = false;  ///< Pipe recording into ffmpeg instead of writing PNGs
+		bool finish = false;  ///< Recording has ended, close the output
+	};
+	void read(Slot& slot, unsigned width, unsigned height, Kind kind);
+	void collect(bool wait);
+	void push(Job&& job);
+	void run();
+	void encode(Job& job);
+	fs::path nextFilename(std::string const& suffix);
+
+	static constexpr std::size_t slotCount = 3;
+	static constexpr std::size_t maxQueue = 8;  ///< Frames waiting for the encoder before new recorded frames are dropped
+	std::array<Slot, slotCount> m_slots;
+	std::size_t m_next = 0;
+	bool m_screenshot = false;
+	bool m_recording = false;
+	bool m_ffmpeg = false;
+	unsigned m_fps = 0;
+	Time m_nextFrame;
+	unsigned m_dropped = 0;
+	// Encoder thread state (shared, guarded by m_mutex)
+	std::mutex m_mutex;
+	std::condition_variable m_condition;
+	std::deque<Job> m_jobs;
+	bool m_quit = false;
+	// Encoder thread private state
+	fs::path const m_folder;
+	unsigned m_lastNumber = 0;  ///< Highest Performous_N number in use
+	bool m_numbered = false;
+	fs::path m_sequence;  ///< Folder of the current PNG sequence
+	unsigned m_sequenceFrame = 0;
+	std::FILE* m_pipe = nullptr;  ///< ffmpeg process of the current recording
+	unsigned m_pipeWidth = 0, m_pipeHeight = 0;
+	std::thread m_thread;
+};
@@ -3,6 +3,8 @@
 #include "video_driver.hh"
 #include "window.hh"
 
+#include <utility>
+
 namespace glutil {
 
 	GLintptr alignOffset(GLintptr offset) {
@@ -15,6 +17,10 @@ namespace glutil {
 		return static_cast<GLintptr>(result);
 	}
 
+	namespace {
+		unsigned s_drawCalls = 0;
+	}
+
 	void VertexArray::clear() {
 		m_vertices.clear();
 	}
@@ -27,8 +33,31 @@ namespace glutil {
 
 		glerror.check("draw arrays");
 		glDrawArrays(mode, 0, size());
+		++s_drawCalls;
 	}
 
+	void VertexArray::draw(InstanceArray const& instances, GLint mode) {
+		GLErrorChecker glerror("VertexArray::draw instanced");
+		if (empty() || instances.empty()) return;
+
+		glBindBuffer(GL_ARRAY_BUFFER, Window::instanceVBO());
+		glBufferData(GL_ARRAY_BUFFER, InstanceArray::stride() * instances.size(), instances.data(), GL_DYNAMIC_DRAW);
+		glBindBuffer(GL_ARRAY_BUFFER, Window::VBO());
+		glBufferData(GL_ARRAY_BUFFER, stride() * size(), &m_vertices.front(), GL_DYNAMIC_DRAW);
+
+		glerror.check("draw arrays instanced");
+		// The instance attributes are only enabled while drawing, so that other shaders never see stale instance data
+		for (GLuint attr = Window::instancePosition; attr <= Window::instanceParams; ++attr) glEnableVertexAttribArray(attr);
+		glDrawArraysInstanced(mode, 0, size(), instances.size());
+		for (GLuint attr = Window::instancePosition; attr <= Window::instanceParams; ++attr) glDisableVertexAttribArray(attr);
+		++s_drawCalls;
+	}
+
+	unsigned VertexArray::drawCalls() {
+		return std::exchange(s_drawCalls, 0u);
+	}
+
+#ifdef GL_ERROR_CHECKS
 	GLErrorChecker::GLErrorChecker(std::string const& info): info(info) {
 		stack.push_back(std::string());
 		check("before starting");
@@ -48,6 +77,7 @@ namespace glutil {
 		}
 		stack.back() = info + " after " + what;
 	}
+#endif
 
 /* static */ std::string GLErrorChecker::msg(GLenum err) {
 	switch(err) {
@@ -63,6 +93,44 @@ namespace glutil {
 	}
 }
 
+#ifdef GL_ERROR_CHECKS
 /* static */ thread_local std::vector<std::string> GLErrorChecker::stack;
+#endif
+
+	namespace {
+		std::string_view debugTypeName(GLenum type) {
+			switch (type) {
+				case GL_DEBUG_TYPE_ERROR: return "error";
+				case GL_DEBUG_TYPE_DEPRECATED_BEHAVIOR: return "deprecated behavior";
+				case GL_DEBUG_TYPE_UNDEFINED_BEHAVIOR: return "undefined behavior";
+				case GL_DEBUG_TYPE_PORTABILITY: return "portability";
+				case GL_DEBUG_TYPE_PERFORMANCE: return "performance";
+				default: return "other";
+			}
+		}
+
+		void GLAPIENTRY debugCallback(GLenum, GLenum type, GLuint id, GLenum severity, GLsizei length, GLchar const* message, void const*) {
+			std::string_view text = length < 0 ? std::string_view(message) : std::string_view(message, static_cast<std::size_t>(length));
+			if (type == GL_DEBUG_TYPE_ERROR || severity == GL_DEBUG_SEVERITY_HIGH) SpdLogger::error(LogSystem::OPENGL, "OpenGL {} id={}: {}", debugTypeName(type), id, text);
+			// Drivers may repeat these every frame, so they go through the rate limiter (which warnings and errors bypass)
+			else SpdLogger::info(LogSystem::OPENGL, "OpenGL {} id={}: {}", debugTypeName(type), id, text);
+		}
+	}
+
+	bool enableDebugOutput() {
+		if (epoxy_gl_version() < 43 && !epoxy_has_gl_extension("GL_KHR_debug")) return false;
+		glEnable(GL_DEBUG_OUTPUT);
+#ifdef GL_ERROR_CHECKS
+		glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);  // Report from within the offending call, so that a breakpoint shows where
+#endif
+		glDebugMessageCallback(debugCallback, nullptr);
+		// Only errors and serious problems; notifications and performance hints would flood the log
+		glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DONT_CARE, 0, nullptr, GL_FALSE);
+		glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DEBUG_SEVERITY_HIGH, 0, nullptr, GL_TRUE);
+		glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DEBUG_SEVERITY_MEDIUM, 0, nullptr, GL_TRUE);
+		glDebugMessageControl(GL_DONT_CARE, GL_DEBUG_TYPE_PERFORMANCE, GL_DEBUG_SEVERITY_MEDIUM, 0, nullptr, GL_FALSE);
+		glDebugMessageControl(GL_DONT_CARE, GL_DEBUG_TYPE_ERROR, GL_DONT_CARE, 0, nullptr, GL_TRUE);
+		return true;
+	}
 
 }
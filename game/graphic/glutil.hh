@@ -5,6 +5,7 @@
 #include "glmath.hh"
 #include <epoxy/gl.h>
 #include <string>
+#include <string_view>
 #include <iostream>
 #include <vector>
 
@@ -19,6 +20,15 @@ namespace glutil {
 		glmath::vec3 vertNormal = glmath::vec3(0.0f);
 		glmath::vec4 vertColor = glmath::vec4(1.0f);
 	};
+
+	// Note: if you reorder or otherwise change the contents of this, Window::initBuffers() and instanced.vert must be modified accordingly
+	/// Per-instance attributes of instanced draws: the mesh is rotated, scaled and moved into place
+	struct InstanceInfo {
+		glmath::vec4 instPosition = glmath::vec4(0.0f, 0.0f, 0.0f, 1.0f);  ///< Offset (xyz) and scale (w)
+		glmath::vec4 instColor = glmath::vec4(1.0f);  ///< Multiplies the vertex color (premultiplied alpha, like ColorTrans)
+		glmath::vec4 instTexRect = glmath::vec4(0.0f, 0.0f, 1.0f, 1.0f);  ///< Texture coordinates are offset (xy) and scaled (zw) by this
+		glmath::vec4 instParams = glmath::vec4(0.0f);  ///< Rotation around z axis in radians (x), unused (yzw)
+	};
 	
 	// Uniform block structs
 	struct shaderMatrices {
@@ -75,6 +85,23 @@ namespace glutil {
 	}; // 32 bytes
 	// Total 368 bytes
 
+	/// Instances to draw a mesh at, with one draw call for all of them
+	class InstanceArray {
+	private:
+		std::vector<InstanceInfo> m_instances;
+	public:
+		/// Add an instance at the given position and scale
+		InstanceInfo& add(float x, float y, float z = 0.0f, float scale = 1.0f) {
+			m_instances.emplace_back().instPosition = glmath::vec4(x, y, z, scale);
+			return m_instances.back();
+		}
+		bool empty() const { return m_instances.empty(); }
+		GLsizei size() const { return static_cast<GLsizei>(m_instances.size()); }
+		InstanceInfo const* data() const { return m_instances.data(); }
+		static GLsizei stride() { return sizeof(InstanceInfo); }
+		void clear() { m_instances.clear(); }
+	};
+
 	/// Handy vertex array capable of drawing itself
 	class VertexArray {
 	private:
@@ -116,6 +143,19 @@ namespace glutil {
 		}
 
 		void draw(GLint mode = GL_TRIANGLE_STRIP);
+		/// Draw all instances of this mesh with a single draw call. Needs a shader that takes the instance attributes (instanced.vert).
+		void draw(InstanceArray const& instances, GLint mode = GL_TRIANGLE_STRIP);
+		/// Append another triangle strip to this one, joined by degenerate triangles so that both can be drawn with one call
+		void strip(VertexArray const& other) {
+			if (other.empty()) return;
+			if (!empty()) {
+				// Two repeated vertices make degenerate (invisible) triangles; a third keeps the winding if this strip has odd length
+				m_vertices.push_back(m_vertices.back());
+				if (m_vertices.size() % 2 == 0) m_vertices.push_back(m_vertices.back());
+				m_vertices.push_back(other.m_vertices.front());
+			}
+			m_vertices.insert(m_vertices.end(), other.m_vertices.begin(), other.m_vertices.end());
+		}
 
 		bool empty() const {
 			return m_vertices.empty();
@@ -124,10 +164,15 @@ namespace glutil {
 		GLsizei size() const {
 			return static_cast<int>(m_vertices.size());
 		}
+
+		VertexInfo const* data() const { return m_vertices.data(); }
 		
 		static GLsizei stride() { return sizeof(VertexInfo); }
 		
 		void clear();
+
+		/// Number of draw calls since the last call (for profiling)
+		static unsigned drawCalls();
 	};
 
 	/// Wrapper struct for RAII
@@ -142,7 +187,9 @@ namespace glutil {
 		}
 	};
 
-	/// Checks for OpenGL error and displays it with given location info
+#ifdef GL_ERROR_CHECKS
+	/// Checks for OpenGL error and displays it with given location info. Each check calls glGetError, which stalls the
+	/// pipeline on many drivers, so this is only compiled in as a diagnostic mode (cmake -DGL_ERROR_CHECKS=ON).
 	class GLErrorChecker {
 		static thread_local std::vector<std::string> stack;
 		std::string info;
@@ -154,6 +201,21 @@ namespace glutil {
 		static void reset() { glGetError(); }  ///< Ignore any existing error
 		static std::string msg(GLenum err);
 	};
+#else
+	/// Compiles to nothing; errors are reported by the debug output callback instead (see enableDebugOutput)
+	class GLErrorChecker {
+	public:
+		GLErrorChecker(std::string_view) {}
+		~GLErrorChecker() {}
+		void check(std::string_view = {}) {}
+		static void reset() {}
+		static std::string msg(GLenum err);
+	};
+#endif
+
+	/// Log OpenGL errors through a KHR_debug message callback as the driver detects them. Returns false if the context
+	/// does not support debug output.
+	bool enableDebugOutput();
 }
 
 
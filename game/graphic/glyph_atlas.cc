@@ -0,0 +1,170 @@
+#include "glyph_atlas.hh"
+
+#include "../log.hh"
+
+#include <pango/pangocairo.h>
+
+#include <utility>
+
+namespace {
+	unsigned s_rasterizations = 0;
+
+	/// Upload a blank atlas (also clearing the gaps between the glyphs of a previous one)
+	void blank(OpenGLTexture<GL_TEXTURE_2D> const& texture) {
+		std::vector<unsigned char> zeros(GlyphAtlas::size * GlyphAtlas::size);
+		glActiveTexture(GL_TEXTURE0);
+		glBindTexture(texture.type(), texture.id());
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+		glTexImage2D(texture.type(), 0, GL_R8, GlyphAtlas::size, GlyphAtlas::size, 0, GL_RED, GL_UNSIGNED_BYTE, zeros.data());
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	}
+}
+
+GlyphAtlas::GlyphAtlas() {
+	glutil::GLErrorChecker glerror("GlyphAtlas");
+	blank(m_texture);
+	// Same filtering as text textures (Texture::load)
+	glTexParameterf(m_texture.type(), GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameterf(m_texture.type(), GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTexParameterf(m_texture.type(), GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameterf(m_texture.type(), GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	// The single channel is coverage, read as white premultiplied by it
+	GLint const swizzle[] = { GL_RED, GL_RED, GL_RED, GL_RED };
+	glTexParameteriv(m_texture.type(), GL_TEXTURE_SWIZZLE_RGBA, swizzle);
+}
+
+void GlyphAtlas::clear() {
+	SpdLogger::debug(LogSystem::TEXT, "Glyph atlas full, emptying it. glyphs={}", m_cells.size());
+	m_cells.clear();
+	m_fonts.clear();
+	m_packer.clear();
+	blank(m_texture);
+	++m_generation;
+}
+
+unsigned GlyphAtlas::rasterizations() {
+	return std::exchange(s_rasterizations, 0u);
+}
+
+GlyphAtlas::Cell const* GlyphAtlas::find(PangoFont* font, PangoGlyph glyph, GlyphOutline const& outline) {
+	Key const key(font, glyph, outline);
+	auto it = m_cells.find(key);
+	if (it != m_cells.end()) return &it->second;
+	PangoRectangle ink;
+	pango_font_get_glyph_extents(font, glyph, &ink, nullptr);
+	Cell cell = bounds(ink, outline.width);
+	if (cell.w > 0.0f) {
+		int const w = static_cast<int>(cell.w), h = static_cast<int>(cell.h);
+		auto const pos = m_packer.add(static_cast<unsigned>(w), static_cast<unsigned>(h));
+		if (!pos) return nullptr;
+		cell.x = static_cast<float>(pos->first);
+		cell.y = static_cast<float>(pos->second);
+		// Rasterize the outline or the filled glyph, only coverage
+		std::shared_ptr<cairo_surface_t> surface(cairo_image_surface_create(CAIRO_FORMAT_A8, w, h), cairo_surface_destroy);
+		std::shared_ptr<cairo_t> dc(cairo_create(surface.get()), cairo_destroy);
+		cairo_set_antialias(dc.get(), CAIRO_ANTIALIAS_FAST);
+		std::shared_ptr<PangoGlyphString> glyphs(pango_glyph_string_new(), pango_glyph_string_free);
+		pango_glyph_string_set_size(glyphs.get(), 1);
+		glyphs->glyphs[0] = PangoGlyphInfo();
+		glyphs->glyphs[0].glyph = glyph;
+		glyphs->glyphs[0].attr.is_cluster_start = 1;
+		cairo_move_to(dc.get(), -cell.left, -cell.top);
+		pango_cairo_glyph_string_path(dc.get(), font, glyphs.get());
+		if (outline.width > 0.0f) {
+			cairo_set_line_join(dc.get(), outline.join);
+			cairo_set_line_cap(dc.get(), outline.cap);
+			cairo_set_miter_limit(dc.get(), outline.miterLimit);
+			cairo_set_line_width(dc.get(), outline.width);
+			cairo_stroke(dc.get());
+		} else {
+			cairo_fill(dc.get());
+		}
+		cairo_surface_flush(surface.get());
+		glutil::GLErrorChecker glerror("GlyphAtlas::find");
+		glActiveTexture(GL_TEXTURE0);
+		glBindTexture(m_texture.type(), m_texture.id());
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+		glPixelStorei(GL_UNPACK_ROW_LENGTH, cairo_image_surface_get_stride(surface.get()));
+		glTexSubImage2D(m_texture.type(), 0, static_cast<GLint>(pos->first), static_cast<GLint>(pos->second), w, h, GL_RED, GL_UNSIGNED_BYTE, cairo_image_surface_get_data(surface.get()));
+		glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+		++s_rasterizations;
+	}
+	if (m_fonts.find(font) == m_fonts.end()) m_fonts.emplace(font, std::shared_ptr<PangoFont>(PANGO_FONT(g_object_ref(font)), g_object_unref));
+	return &m_cells.emplace(key, cell).first->second;
+}
+
+GlyphRun::GlyphRun(PangoLayout* layout, float x, float y, float width, float height, Color const& fill, Color const& stroke, GlyphOutline const& outline):
+  m_width(width), m_height(height), m_fill(fill.linear()), m_stroke(stroke.linear()), m_outline(outline)
+{
+	std::map<PangoFont*, unsigned> fonts;
+	std::shared_ptr<PangoLayoutIter> iter(pango_layout_get_iter(layout), pango_layout_iter_free);
+	do {
+		PangoLayoutRun* run = pango_layout_iter_get_run_readonly(iter.get());
+		if (!run) continue;  // End of a line
+		PangoFont* font = run->item->analysis.font;
+		auto it = fonts.find(font);
+		if (it == fonts.end()) {
+			it = fonts.emplace(font, static_cast<unsigned>(m_fonts.size())).first;
+			m_fonts.emplace_back(PANGO_FONT(g_object_ref(font)), g_object_unref);
+		}
+		PangoRectangle logical;
+		pango_layout_iter_get_run_extents(iter.get(), nullptr, &logical);
+		int const baseline = pango_layout_iter_get_baseline(iter.get());
+		int pen = logical.x;
+		for (int i = 0; i < run->glyphs->num_glyphs; ++i) {
+			PangoGlyphInfo const& info = run->glyphs->glyphs[i];
+			if (info.glyph != PANGO_GLYPH_EMPTY) {
+				m_glyphs.push_back({ it->second, info.glyph,
+				  x + static_cast<float>(pen + info.geometry.x_offset) / PANGO_SCALE, y + static_cast<float>(baseline + info.geometry.y_offset) / PANGO_SCALE });
+			}
+			pen += info.geometry.width;
+		}
+	} while (pango_layout_iter_next_run(iter.get()));
+}
+
+bool GlyphRun::layout(GlyphAtlas& atlas) {
+	m_quads.clear();
+	auto const add = [&](GlyphOutline const& outline, glmath::vec4 const& color) {
+		for (auto const& g: m_glyphs) {
+			GlyphAtlas::Cell const* cell = atlas.find(m_fonts[g.font].get(), g.glyph, outline);
+			if (!cell) return false;
+			if (cell->w == 0.0f) continue;
+			float const x = g.x + cell->left, y = g.y + cell->top;
+			float const s = 1.0f / static_cast<float>(GlyphAtlas::size);
+			m_quads.push_back({ x / m_width, y / m_height, (x + cell->w) / m_width, (y + cell->h) / m_height,
+			  cell->x * s, cell->y * s, (cell->x + cell->w) * s, (cell->y + cell->h) * s, color });
+		}
+		return true;
+	};
+	if (m_fill.w > 0.0f && !add(GlyphOutline(), m_fill)) return false;
+	return !(m_outline.width > 0.0f && m_stroke.w > 0.0f && !add(m_outline, m_stroke));
+}
+
+void GlyphRun::draw(Window& window, Dimensions const& dim) {
+	GlyphAtlas& atlas = window.glyphAtlas();
+	if (!m_laidOut || m_generation != atlas.generation()) {
+		// A full atlas is emptied and the text laid out again; if it still does not fit, only a part of it is drawn
+		if (!layout(atlas)) {
+			atlas.clear();
+			if (!layout(atlas)) SpdLogger::notice(LogSystem::TEXT, "Text does not fit in the glyph atlas, glyphs={}", m_glyphs.size());
+		}
+		m_generation = atlas.generation();
+		m_laidOut = true;
+	}
+	if (m_quads.empty()) return;
+	glutil::VertexArray va;
+	for (auto const& q: m_quads) {
+		float const x1 = dim.x1() + q.x1 * dim.w(), x2 = dim.x1() + q.x2 * dim.w();
+		float const y1 = dim.y1() + q.y1 * dim.h(), y2 = dim.y1() + q.y2 * dim.h();
+		va.color(q.color).texCoord(q.s1, q.t1).vertex(x1, y1);
+		va.color(q.color).texCoord(q.s2, q.t1).vertex(x2, y1);
+		va.color(q.color).texCoord(q.s1, q.t2).vertex(x1, y2);
+		va.color(q.color).texCoord(q.s1, q.t2).vertex(x1, y2);
+		va.color(q.color).texCoord(q.s2, q.t1).vertex(x2, y1);
+		va.color(q.color).texCoord(q.s2, q.t2).vertex(x2, y2);
+	}
+	UseTexture texture(window, atlas.texture());
+	glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+	va.draw(GL_TRIANGLES);
+}
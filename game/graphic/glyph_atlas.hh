@@ -0,0 +1,100 @@
+#pragma once
+
+#include "shelf_packer.hh"
+#include "../color.hh"
+#include "../texture.hh"
+
+#include <pango/pango.h>
+
+#include <cmath>
+#include <map>
+#include <memory>
+#include <tuple>
+#include <vector>
+
+/// How a glyph is rasterized: filled (width 0) or as an outline of the given width
+struct GlyphOutline {
+	float width = 0.0f;
+	cairo_line_join_t join = CAIRO_LINE_JOIN_MITER;
+	cairo_line_cap_t cap = CAIRO_LINE_CAP_BUTT;
+	float miterLimit = 1.0f;
+	bool operator<(GlyphOutline const& other) const {
+		return std::tie(width, join, cap, miterLimit) < std::tie(other.width, other.join, other.cap, other.miterLimit);
+	}
+};
+
+/**
+ * Glyphs rasterized once into a shared texture, so that text that changes often (scores, timers, song list labels)
+ * does not need to be rasterized again each time. The glyphs are white coverage masks; the text color comes from
+ * vertex colors. When the atlas gets full it is emptied and the texts currently shown fill it again.
+ */
+class GlyphAtlas {
+  public:
+	static constexpr unsigned size = 2048;  ///< Width and height of the texture in pixels
+	/// A glyph in the atlas
+	struct Cell {
+		float x = 0.0f, y = 0.0f, w = 0.0f, h = 0.0f;  ///< Pixels in the atlas, zero size for glyphs with nothing to draw
+		float left = 0.0f, top = 0.0f;  ///< Top left corner of the bitmap relative to the pen position
+	};
+
+	GlyphAtlas();
+	/// Size and offset of the bitmap of a glyph with the given ink extents (Pango units), with room for half the outline
+	/// and for antialiasing on each side; zero size if there is no ink
+	static Cell bounds(PangoRectangle const& ink, float outlineWidth) {
+		Cell cell;
+		float const margin = 0.5f * outlineWidth + 1.0f;
+		cell.left = std::floor(static_cast<float>(ink.x) / PANGO_SCALE - margin);
+		cell.top = std::floor(static_cast<float>(ink.y) / PANGO_SCALE - margin);
+		if (ink.width <= 0 || ink.height <= 0) return cell;
+		cell.w = std::ceil(static_cast<float>(ink.x + ink.width) / PANGO_SCALE + margin) - cell.left;
+		cell.h = std::ceil(static_cast<float>(ink.y + ink.height) / PANGO_SCALE + margin) - cell.top;
+		return cell;
+	}
+	/// The cell of a glyph, rasterized into the atlas if needed; nullptr if the atlas is full
+	Cell const* find(PangoFont* font, PangoGlyph glyph, GlyphOutline const& outline);
+	/// Empty the atlas, invalidating all cells found so far
+	void clear();
+	/// Changes whenever the atlas is emptied
+	unsigned generation() const { return m_generation; }
+	OpenGLTexture<GL_TEXTURE_2D> const& texture() const { return m_texture; }
+	/// Number of glyphs rasterized since the previous call
+	static unsigned rasterizations();
+
+  private:
+	using Key = std::tuple<PangoFont*, PangoGlyph, GlyphOutline>;
+	OpenGLTexture<GL_TEXTURE_2D> m_texture;
+	ShelfPacker m_packer{ size, size };
+	std::map<Key, Cell> m_cells;
+	std::map<PangoFont*, std::shared_ptr<PangoFont>> m_fonts;  ///< Keeps the fonts of the cells alive, so that their addresses stay unique
+	unsigned m_generation = 0;
+};
+
+/// A text shaped by Pango, drawn glyph by glyph from the glyph atlas of the window
+class GlyphRun {
+  public:
+	/// Take the glyphs of a layout drawn at (x, y) pixels of a width x height text box
+	GlyphRun(PangoLayout* layout, float x, float y, float width, float height, Color const& fill, Color const& stroke, GlyphOutline const& outline);
+	/// Draw in the given dimensions, filling all glyphs first and then drawing their outlines on top
+	void draw(Window&, Dimensions const& dim);
+
+  private:
+	struct Glyph {
+		unsigned font;  ///< Index to m_fonts
+		PangoGlyph glyph;
+		float x, y;  ///< Pen position in pixels
+	};
+	struct Quad {
+		float x1, y1, x2, y2;  ///< Position relative to the text box, [0, 1]
+		float s1, t1, s2, t2;  ///< Texture coordinates in the atlas
+		glmath::vec4 color;
+	};
+	bool layout(GlyphAtlas& atlas);
+	std::vector<std::shared_ptr<PangoFont>> m_fonts;
+	std::vector<Glyph> m_glyphs;
+	float m_width, m_height;
+	glmath::vec4 m_fill, m_stroke;  ///< Premultiplied
+	GlyphOutline m_outline;
+	std::vector<Quad> m_quads;
+	unsigned m_generation = 0;
+	bool m_laidOut = false;
+};
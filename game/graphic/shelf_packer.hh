@@ -0,0 +1,46 @@
+#pragma once
+
+#include <optional>
+#include <utility>
+#include <vector>
+
+/**
+ * Packs rectangles (e.g. glyphs of a texture atlas) into a fixed size area, row by row. A rectangle goes on the first
+ * row ("shelf") that is tall enough without wasting more than half of its height, otherwise on a new row below the
+ * others. Rectangles are only ever added; clear() starts over. There is a gap between the rectangles so that texture
+ * filtering does not bleed from one to another.
+ */
+class ShelfPacker {
+  public:
+	static constexpr unsigned gap = 1;
+	ShelfPacker(unsigned width, unsigned height): m_width(width), m_height(height) {}
+	/// Top left corner for a w x h rectangle, or nothing if it does not fit
+	std::optional<std::pair<unsigned, unsigned>> add(unsigned w, unsigned h) {
+		if (auto pos = place(w, h, true)) return pos;
+		unsigned const y = m_shelves.empty() ? gap : m_shelves.back().y + m_shelves.back().height;
+		if (gap + w <= m_width && y + h + gap <= m_height) {
+			m_shelves.push_back({ y, h + gap, gap });
+			return place(w, h, true);
+		}
+		return place(w, h, false);  // Out of rows, any shelf with room will do
+	}
+	void clear() { m_shelves.clear(); }
+
+  private:
+	struct Shelf {
+		unsigned y, height;  ///< Height includes the gap below
+		unsigned used;  ///< x of the next rectangle
+	};
+	std::optional<std::pair<unsigned, unsigned>> place(unsigned w, unsigned h, bool snug) {
+		for (auto& shelf: m_shelves) {
+			if (h + gap > shelf.height || (snug && 2 * (h + gap) < shelf.height) || shelf.used + w + gap > m_width) continue;
+			unsigned const x = shelf.used;
+			shelf.used += w + gap;
+			return std::make_pair(x, shelf.y);
+		}
+		return std::nullopt;
+	}
+
+	unsigned m_width, m_height;
+	std::vector<Shelf> m_shelves;
+};
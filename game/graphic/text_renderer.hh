@@ -7,6 +7,7 @@
 
 class TextRenderer {
 public:
+	/// Shape the text; it is drawn from the glyph atlas of the window
 	OpenGLText render(std::string const&, TextStyle const&, float m);
 	Size measure(std::string const&, TextStyle const&, float m);
 };
@@ -2,7 +2,9 @@
 
 #include "color_trans.hh"
 #include "configuration.hh"
+#include "frame_capture.hh"
 #include "game.hh"
+#include "glyph_atlas.hh"
 #include "log.hh"
 #include "platform.hh"
 #include "view_trans.hh"
@@ -13,11 +15,6 @@
 #include <SDL_rect.h>
 #include <SDL_video.h>
 
-GLuint Window::m_ubo = 0;
-GLuint Window::m_vao = 0;
-GLuint Window::m_vbo = 0;
-GLint Window::bufferOffsetAlignment = -1;
-
 namespace {
 	float s_width;
 	float s_height;
@@ -96,6 +93,9 @@ void Window::start() {
 		GLattrSetter attr_buf(SDL_GL_BUFFER_SIZE, 32);
 		GLattrSetter attr_d(SDL_GL_DEPTH_SIZE, 24);
 		GLattrSetter attr_db(SDL_GL_DOUBLEBUFFER, 1);
+#ifdef GL_ERROR_CHECKS
+		GLattrSetter attr_debug(SDL_GL_CONTEXT_FLAGS, SDL_GL_CONTEXT_DEBUG_FLAG);  // Drivers report more through debug output
+#endif
 		Uint32 flags = SDL_WINDOW_HIDDEN | SDL_WINDOW_RESIZABLE | SDL_WINDOW_OPENGL;
 		if (config["graphic/highdpi"].b()) {
 			flags |= SDL_WINDOW_ALLOW_HIGHDPI;
@@ -181,6 +181,7 @@ void Window::start() {
 		glContext.reset(SDL_GL_CreateContext(screen.get()));
 		if (glContext == nullptr) throw std::runtime_error(std::string("SDL_GL_CreateContext failed with error: ") + SDL_GetError());
 		if (epoxy_gl_version() < 33) throw std::runtime_error("Performous needs at least OpenGL 3.3+ Core profile to run.");
+		if (!glutil::enableDebugOutput()) SpdLogger::info(LogSystem::OPENGL, "KHR_debug not supported, OpenGL errors are only reported in builds with GL_ERROR_CHECKS.");
 		glutil::GLErrorChecker error("Initializing buffers");
 		{
 			initBuffers();
@@ -208,12 +209,7 @@ void Window::start() {
 }
 
 Window::~Window() {
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
-	glBindBuffer(GL_UNIFORM_BUFFER, 0);
-	glBindVertexArray(0);
-	glDeleteBuffers(1, &m_vbo);
-	glDeleteBuffers(1, &m_ubo);
-	glDeleteVertexArrays(1, &m_vao);
+	deleteBuffers();
 }
 
 void Window::createShaders() {
@@ -226,6 +222,8 @@ void Window::createShaders() {
 			shader("texture").compileFile(findFile("shaders/stereo3d.geom"));
 			shader("3dobject").compileFile(findFile("shaders/stereo3d.geom"));
 			shader("dancenote").compileFile(findFile("shaders/stereo3d.geom"));
+			shader("texture_instanced").compileFile(findFile("shaders/stereo3d.geom"));
+			shader("3dobject_instanced").compileFile(findFile("shaders/stereo3d.geom"));
 		}
 		else {
 			SpdLogger::warning(LogSystem::OPENGL, "Stereo3D was enabled but the 'GL_ARB_viewport_array' extension is unsupported; will now disable Stereo3D.");
@@ -259,6 +257,21 @@ void Window::createShaders() {
 	  .compileFile(findFile("shaders/core.frag"))
 	  .link()
 	  .bindUniformBlocks();
+	// Instanced variants of texture and 3dobject, the instance color taking the place of ColorTrans
+	shader("texture_instanced")
+	  .addDefines("#define ENABLE_TEXTURING\n")
+	  .addDefines("#define ENABLE_VERTEX_COLOR\n")
+	  .compileFile(findFile("shaders/instanced.vert"))
+	  .compileFile(findFile("shaders/core.frag"))
+	  .link()
+	  .bindUniformBlocks();
+	shader("3dobject_instanced")
+	  .addDefines("#define ENABLE_LIGHTING\n")
+	  .addDefines("#define ENABLE_VERTEX_COLOR\n")
+	  .compileFile(findFile("shaders/instanced.vert"))
+	  .compileFile(findFile("shaders/core.frag"))
+	  .link()
+	  .bindUniformBlocks();
 
 	updateColor();
 	view(0);  // For loading screens
@@ -273,25 +286,6 @@ void Window::resetShaders() {
 	createShaders();
 }
 
-void Window::initBuffers() {
-	glGenVertexArrays(1, &Window::m_vao); // Create VAO.
-	glBindVertexArray(Window::m_vao);
-	glGenBuffers(1, &Window::m_vbo); // Create VBO.
-	glGenBuffers(1, &Window::m_ubo); // Create UBO.
-
-	GLsizei stride = glutil::VertexArray::stride();
-	glBindBuffer(GL_ARRAY_BUFFER, Window::m_vbo);
-
-	glEnableVertexAttribArray(vertPos);
-	glVertexAttribPointer(vertPos, 3, GL_FLOAT, GL_FALSE, stride, (void *)offsetof(glutil::VertexInfo, vertPos));
-	glEnableVertexAttribArray(vertTexCoord);
-	glVertexAttribPointer(vertTexCoord, 2, GL_FLOAT, GL_FALSE, stride, (void *)offsetof(glutil::VertexInfo, vertTexCoord));
-	glEnableVertexAttribArray(vertNormal);
-	glVertexAttribPointer(vertNormal, 3, GL_FLOAT, GL_FALSE, stride, (void *)offsetof(glutil::VertexInfo, vertNormal));
-	glEnableVertexAttribArray(vertColor);
-	glVertexAttribPointer(vertColor, 4, GL_FLOAT, GL_FALSE, stride, (void *)offsetof(glutil::VertexInfo, vertColor));
-}
-
 void Window::blank() {
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 }
@@ -459,6 +453,18 @@ void Window::swap() {
 	SDL_GL_SwapWindow(screen.get());
 }
 
+bool Window::setSwapInterval(int interval) {
+	if (SDL_GL_SetSwapInterval(interval) == 0) return true;
+	SpdLogger::notice(LogSystem::OPENGL, "Setting swap interval={} failed: {}", interval, SDL_GetError());
+	return false;
+}
+
+double Window::refreshRate() const {
+	SDL_DisplayMode mode;
+	if (SDL_GetWindowDisplayMode(screen.get(), &mode) != 0 || mode.refresh_rate <= 0) return 60.0;
+	return mode.refresh_rate;
+}
+
 void Window::event(Uint8 const& eventID, Sint32 const& data1, Sint32 const& data2) {
 	switch (eventID) {
 		case SDL_WINDOWEVENT_MOVED:
@@ -502,6 +508,11 @@ FBO& Window::getFBO() {
 	return *m_fbo;
 }
 
+GlyphAtlas& Window::glyphAtlas() {
+	if (!m_glyphAtlas) m_glyphAtlas = std::make_unique<GlyphAtlas>();
+	return *m_glyphAtlas;
+}
+
 void Window::setFullscreen() {
 	if (m_fullscreen == config["graphic/fullscreen"].b()) return;  // We are done here
 	m_fullscreen = config["graphic/fullscreen"].b();
@@ -561,7 +572,17 @@ void Window::resize() {
 }
 
 void Window::screenshot() {
-	Bitmap img;
+	if (!m_capture) m_capture = std::make_unique<FrameCapture>();
+	m_capture->screenshot();
+}
+
+bool Window::toggleRecording() {
+	if (!m_capture) m_capture = std::make_unique<FrameCapture>();
+	return m_capture->toggleRecording();
+}
+
+void Window::captureFrame() {
+	if (!m_capture) return;
 	int nativeW;
 	int nativeH;
 	if (std::stoi(SDL_GetHint("SDL_HINT_VIDEO_HIGHDPI_DISABLED")) == 1) {
@@ -570,24 +591,7 @@ void Window::screenshot() {
 	else {
 		SDL_GL_GetDrawableSize(screen.get(), &nativeW, &nativeH);
 	}
-	img.width = static_cast<unsigned>(nativeW);
-	img.height = static_cast<unsigned>(nativeH);
-	unsigned stride = (img.width * 3 + 3) & ~3u;  // Rows are aligned to 4 byte boundaries
-	img.buf.resize(stride * img.height);
-	img.fmt = pix::Format::RGB;
-	img.linearPremul = true; // Not really, but this will use correct gamma.
-	img.bottomFirst = true;
-	// Get pixel data from OpenGL
-	glReadPixels(0, 0, img.width, img.height, GL_RGB, GL_UNSIGNED_BYTE, img.data());
-	// Compose filename with first available number
-	fs::path filename;
-	for (unsigned i = 1;; ++i) {
-		filename = PathCache::getHomeDir() / ("Performous_" + std::to_string(i) + ".png");
-		if (!fs::exists(filename)) break;
-	}
-	// Save to disk
-	writePNG(filename.string(), img, stride);
-	SpdLogger::info(LogSystem::OPENGL, "Screenshot taken, file={} ({}x{}).", filename, img.width, img.height);
+	m_capture->frame(static_cast<unsigned>(nativeW), static_cast<unsigned>(nativeH));
 }
 
 Window::SDLSystem::SDLSystem() {
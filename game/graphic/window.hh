@@ -15,7 +15,9 @@
 struct SDL_Surface;
 struct SDL_Window;
 class FBO;
+class FrameCapture;
 class Game;
+class GlyphAtlas;
 
 float screenW();
 float screenH();
@@ -35,24 +37,43 @@ class Window {
 	void render(Game &game, std::function<void (void)> drawFunc);
 	/// clears window
 	void blank();
-	/// Initialize VAO and VBO.
-	void initBuffers();
+	/// Initialize VAO and VBO (in window_buffers.cc, usable without a window).
+	static void initBuffers();
+	/// Delete the buffers created by initBuffers.
+	static void deleteBuffers();
 	/// swaps buffers
 	void swap();
+	/// Set the number of vsyncs to wait for in swap() (0 = none); returns false if the driver does not support it
+	bool setSwapInterval(int interval);
+	/// Refresh rate of the display of the window (Hz), 60 if unknown
+	double refreshRate() const;
 	/// Handle window events
 	void event(Uint8 const& eventID, Sint32 const& data1, Sint32 const& data2);
 	/// Resize window (contents) / toggle full screen according to config. Returns true if resized.
 	void resize();
-	/// take a screenshot
+	/// take a screenshot of the next rendered frame
 	void screenshot();
+	/// Start or stop recording, returns true if recording is now active
+	bool toggleRecording();
+	/// Read back the frame just rendered if a screenshot or recording needs it (call before swap)
+	void captureFrame();
 
 	/// Return reference to Uniform Buffer Object.
 	static GLuint const& UBO() { return Window::m_ubo; }
 	/// Return reference to Vertex Array Object.
 	GLuint const& VAO() const { return Window::m_vao; }
 	/// Return reference to Vertex Buffer Object.
-	GLuint const& VBO() const { return Window::m_vbo; }
+	static GLuint const& VBO() { return Window::m_vbo; }
+	/// Return reference to the buffer of per-instance attributes (see glutil::InstanceInfo).
+	static GLuint const& instanceVBO() { return Window::m_instanceVbo; }
+	/// Attribute locations of glutil::InstanceInfo; disabled except during instanced draws.
+	static constexpr GLuint instancePosition = 4;
+	static constexpr GLuint instanceColor = 5;
+	static constexpr GLuint instanceTexRect = 6;
+	static constexpr GLuint instanceParams = 7;
 	FBO& getFBO();
+	/// Glyphs of dynamic texts (see GlyphRun), created on first use
+	GlyphAtlas& glyphAtlas();
 
 	/// Store value of GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT.
 	static GLint bufferOffsetAlignment;
@@ -80,15 +101,16 @@ class Window {
 		~SDLSystem();
 	};
 
-	const GLuint vertPos = 0;
-	const GLuint vertTexCoord = 1;
-	const GLuint vertNormal = 2;
-	const GLuint vertColor = 3;
+	static constexpr GLuint vertPos = 0;
+	static constexpr GLuint vertTexCoord = 1;
+	static constexpr GLuint vertNormal = 2;
+	static constexpr GLuint vertColor = 3;
 	bool m_fullscreen = false;
 	bool m_needResize = true;
 	static GLuint m_ubo;
 	static GLuint m_vao;
 	static GLuint m_vbo;
+	static GLuint m_instanceVbo;
 	glutil::stereo3dParams m_stereoUniforms;
 	glutil::shaderMatrices m_matrixUniforms;
 	glutil::lyricColorUniforms m_lyricColorUniforms;
@@ -104,4 +126,6 @@ class Window {
 	std::unique_ptr<SDL_Window, void (*)(SDL_Window*)> screen;
 	std::unique_ptr<std::remove_pointer_t<SDL_GLContext> /* SDL_GLContext is a void* */, void (*)(SDL_GLContext)> glContext;
 	std::unique_ptr<ShaderManager> m_shaderManager;
+	std::unique_ptr<FrameCapture> m_capture;  ///< Owns GL buffers, must go before the context
+	std::unique_ptr<GlyphAtlas> m_glyphAtlas;  ///< Owns a GL texture, must go before the context
 };
@@ -0,0 +1,52 @@
+// The buffers shared by all drawing, apart from window.cc so that they can be used without a window (e.g. in tests)
+
+#include "window.hh"
+
+#include <cstddef>
+
+GLuint Window::m_ubo = 0;
+GLuint Window::m_vao = 0;
+GLuint Window::m_vbo = 0;
+GLuint Window::m_instanceVbo = 0;
+GLint Window::bufferOffsetAlignment = -1;
+
+void Window::initBuffers() {
+	glGenVertexArrays(1, &Window::m_vao); // Create VAO.
+	glBindVertexArray(Window::m_vao);
+	glGenBuffers(1, &Window::m_vbo); // Create VBO.
+	glGenBuffers(1, &Window::m_ubo); // Create UBO.
+
+	GLsizei stride = glutil::VertexArray::stride();
+	glBindBuffer(GL_ARRAY_BUFFER, Window::m_vbo);
+
+	glEnableVertexAttribArray(vertPos);
+	glVertexAttribPointer(vertPos, 3, GL_FLOAT, GL_FALSE, stride, (void *)offsetof(glutil::VertexInfo, vertPos));
+	glEnableVertexAttribArray(vertTexCoord);
+	glVertexAttribPointer(vertTexCoord, 2, GL_FLOAT, GL_FALSE, stride, (void *)offsetof(glutil::VertexInfo, vertTexCoord));
+	glEnableVertexAttribArray(vertNormal);
+	glVertexAttribPointer(vertNormal, 3, GL_FLOAT, GL_FALSE, stride, (void *)offsetof(glutil::VertexInfo, vertNormal));
+	glEnableVertexAttribArray(vertColor);
+	glVertexAttribPointer(vertColor, 4, GL_FLOAT, GL_FALSE, stride, (void *)offsetof(glutil::VertexInfo, vertColor));
+
+	// Per-instance attributes come from a buffer of their own, advancing once per instance
+	glGenBuffers(1, &Window::m_instanceVbo);
+	glBindBuffer(GL_ARRAY_BUFFER, Window::m_instanceVbo);
+	GLsizei instanceStride = glutil::InstanceArray::stride();
+	glVertexAttribPointer(instancePosition, 4, GL_FLOAT, GL_FALSE, instanceStride, (void *)offsetof(glutil::InstanceInfo, instPosition));
+	glVertexAttribPointer(instanceColor, 4, GL_FLOAT, GL_FALSE, instanceStride, (void *)offsetof(glutil::InstanceInfo, instColor));
+	glVertexAttribPointer(instanceTexRect, 4, GL_FLOAT, GL_FALSE, instanceStride, (void *)offsetof(glutil::InstanceInfo, instTexRect));
+	glVertexAttribPointer(instanceParams, 4, GL_FLOAT, GL_FALSE, instanceStride, (void *)offsetof(glutil::InstanceInfo, instParams));
+	for (GLuint attr = instancePosition; attr <= instanceParams; ++attr) glVertexAttribDivisor(attr, 1);
+	glBindBuffer(GL_ARRAY_BUFFER, Window::m_vbo);
+}
+
+void Window::deleteBuffers() {
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+	glBindVertexArray(0);
+	glDeleteBuffers(1, &m_vbo);
+	glDeleteBuffers(1, &m_instanceVbo);
+	glDeleteBuffers(1, &m_ubo);
+	glDeleteVertexArrays(1, &m_vao);
+	m_vbo = m_instanceVbo = m_ubo = m_vao = 0;
+}
@@ -337,7 +337,8 @@ bool GuitarGraph::difficulty(Difficulty level, bool check_only) {
 /// Core engine
 void GuitarGraph::engine() {
 	double time = m_audio.getPosition();
-	time -= config["audio/controller_delay"].f();
+	Time const frameTime = Clock::now();
+	time -= m_controllerDelay;
 	doUpdates();
 	if (!m_drumfills.empty()) updateDrumFill(time); // Drum Fills / BREs
 	m_whammy = 0;
@@ -345,6 +346,7 @@ void GuitarGraph::engine() {
 	handleCountdown(time, time < getNotesBeginTime() ? getNotesBeginTime() : m_jointime+1);
 	// Handle all events
 	for (input::Event ev; m_dev->getEvent(ev); ) {
+		double const hitTime = input::captureSongTime(ev, time, frameTime);  // Judge by when the button was actually hit
 		unsigned buttonId = to_underlying(ev.button.id);
 		// Lefty mode flip of buttons
 		if (m_leftymode.b() && m_drums && ev.source.type != input::SourceType::MIDI) {
@@ -409,14 +411,14 @@ void GuitarGraph::engine() {
 		if (!m_drums) {
 			if (ev.button == input::ButtonId::GUITAR_GODMODE && ev.pressed()) activateStarpower();
 			if (ev.button == input::ButtonId::GUITAR_WHAMMY) m_whammy = (1.0 + ev.value + 2.0*(rand()/double(RAND_MAX))) / 4.0;
-			if (buttonId <= m_pads && !ev.pressed()) endHold(buttonId, time);
+			if (buttonId <= m_pads && !ev.pressed()) endHold(buttonId, hitTime);
 		}
 
 		// Playing
 		if (m_drums) {
-			if (ev.pressed() && ev.button.layer() < 8 && ev.button.num() < m_pads) drumHit(time, ev.button.layer(), ev.button.num());
+			if (ev.pressed() && ev.button.layer() < 8 && ev.button.num() < m_pads) drumHit(hitTime, ev.button.layer(), ev.button.num());
 		} else {
-			guitarPlay(time, ev);
+			guitarPlay(hitTime, ev);
 		}
 		if (m_score < 0) m_score = 0;
 	}
@@ -817,12 +819,18 @@ void GuitarGraph::drawNotes(double time) {
 			drawNote(4, c, m_dfIt->end - time, m_dfIt->end - time, 0.0f, false, false, 0.0, 0.0);
 		}
 	}
-	if (time != time) return;  // Check that time is not NaN
+	if (time != time) {  // Check that time is not NaN
+		drawNoteObjects();
+		return;
+	}
 
 	glmath::vec4 neckglow{};  // Used for calculating the average neck color
 
 	// Iterate chords
-	for (auto& chord: m_chords) {
+	auto const passed = m_visibleChords.begin();
+	m_visibleChords.update(time + past, time + future);
+	for (auto it = passed; it < m_visibleChords.begin(); ++it) it->passed = true; // Mark as past note for rewinding
+	for (auto& chord: m_visibleChords) {
 		float tBeg = static_cast<float>(chord.begin - time);
 		float tEnd = static_cast<float>(m_drums ? tBeg : chord.end - time);
 		if (tBeg > future) break;
@@ -870,6 +878,7 @@ void GuitarGraph::drawNotes(double time) {
 			  chord.releaseTimes[fret] > 0.0 ? chord.releaseTimes[fret] - time : getNaN());
 		}
 	}
+	drawNoteObjects();
 	// Mangle neck glow color as needed
 	// Convert sum into average and apply correctness as premultiplied alpha
 	if (neckglow.w > 0.0f) neckglow = static_cast<float>((correctness() / neckglow.w)) * neckglow;
@@ -1079,36 +1088,35 @@ void GuitarGraph::drawNote(unsigned fret, Color color, double tBeg, double tEnd,
 		va.draw();
 		glEnable(GL_DEPTH_TEST);
 		// Render the fret object
-		{
-			ColorTrans c(window, color);
-			m_fretObj.draw(window, x, fretY, 0.0f);
-		}
+		m_fretInstances.add(x, fretY).instColor = color.linear();
 	} else {
 		// Too short note: only render the ring
 		if (hitAnim > 0.0f && tEnd <= maxTolerance) {
 			float s = static_cast<float>(1.0f - hitAnim);
 			color.a = s;
-			{
-				ColorTrans c(window, color);
-				m_fretObj.draw(window, x, yBeg, 0.0f, s);
-			}
+			m_fretInstances.add(x, yBeg, 0.0f, s).instColor = color.linear();
 		} else {
 			color.a = clamp(time2a(static_cast<float>(tBeg))*2.0f,0.0f,1.0f);
-			{
-				ColorTrans c(window, color);
-				m_fretObj.draw(window, x, yBeg, 0.0f);
-			}
+			m_fretInstances.add(x, yBeg).instColor = color.linear();
 		}
 	}
 	// Hammer note caps
 	if (tappable) {
 		float l = std::max(0.3f, static_cast<float>(m_correctness.get()));
 		float s = static_cast<float>(1.0f - hitAnim);
-		ColorTrans c(window, Color(l, l, l, s));
-		m_tappableObj.draw(window, x, yBeg, 0.0f, s);
+		m_tappableInstances.add(x, yBeg, 0.0f, s).instColor = Color(l, l, l, s).linear();
 	}
 }
 
+/// Draws the fret objects and note caps queued by drawNote, with one draw call for each kind
+void GuitarGraph::drawNoteObjects() {
+	auto& window = m_game.getWindow();
+	m_fretObj.draw(window, m_fretInstances);
+	m_tappableObj.draw(window, m_tappableInstances);
+	m_fretInstances.clear();
+	m_tappableInstances.clear();
+}
+
 /// Draws a drum fill
 void GuitarGraph::drawDrumfill(double tBeg, double tEnd) {
 	auto& window = m_game.getWindow();
@@ -1166,12 +1174,12 @@ void GuitarGraph::drawInfo(double time) {
 		if (canActivateStarpower()) {
 			m_text.dimensions.screenBottom(-0.02f).middle(-0.12f);
 			if (!m_drums)
-				m_text.draw(window, _("God Mode Ready!"));
+				m_text.draw(window, _c("God Mode Ready!"));
 			else if (m_dfIt != m_drumfills.end() && time >= m_dfIt->begin && time <= m_dfIt->end)
-				m_text.draw(window, _("Drum Fill!"));
+				m_text.draw(window, _c("Drum Fill!"));
 		} else if (m_solo) {
 			m_text.dimensions.screenBottom(-0.02f).middle(-0.03f);
-			m_text.draw(window, _("Solo!"));
+			m_text.draw(window, _c("Solo!"));
 		}
 	}
 	drawPopups();
@@ -1263,6 +1271,7 @@ void GuitarGraph::updateChords() {
 		m_chords.push_back(c);
 	}
 	m_chordIt = m_chords.begin();
+	m_visibleChords.reset(m_chords.begin(), m_chords.end());
 
 	m_hasTomTrack = false;
 	if(m_drums) {
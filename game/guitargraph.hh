@@ -2,6 +2,7 @@
 
 #include "instrumentgraph.hh"
 #include "3dobject.hh"
+#include "notewindow.hh"
 
 #include <cstdint>
 
@@ -92,6 +93,8 @@ class GuitarGraph: public InstrumentGraph {
 	glmath::vec4 m_neckglowColor;
 	Object3d m_fretObj; /// 3d object for regular note
 	Object3d m_tappableObj; /// 3d object for the HOPO note cap
+	glutil::InstanceArray m_fretInstances; /// Fret objects queued by drawNote
+	glutil::InstanceArray m_tappableInstances; /// HOPO note caps queued by drawNote
 	std::vector<std::string> m_samples; /// sound effects
 	std::unique_ptr<Texture> m_neck; /// necks
 	std::unique_ptr<SvgTxtThemeSimple> m_scoreText;
@@ -125,6 +128,7 @@ class GuitarGraph: public InstrumentGraph {
 	void drawNotes(double time);  ///< Frets etc.
 	void drawBar(double time, float h);
 	void drawNote(unsigned fret, Color, double tBeg, double tEnd, float whammy = 0.0f, bool tappable = false, bool hit = false, double hitAnim = 0.0, double releaseTime = 0.0);
+	void drawNoteObjects();
 	void drawDrumfill(double tBeg, double tEnd);
 	void drawInfo(double time);
 	float getFretX(unsigned fret) { return (-2.0f + static_cast<float>(fret) - (m_drums ? 0.5f : 0.0f)) * (m_leftymode.b() ? -1 : 1); }
@@ -136,6 +140,7 @@ class GuitarGraph: public InstrumentGraph {
 	typedef std::vector<GuitarChord> Chords;
 	Chords m_chords;
 	Chords::iterator m_chordIt;
+	NoteWindow<Chords::iterator> m_visibleChords; /// chords on screen
 	typedef std::map<Duration const*, unsigned> NoteStatus; // Note in song to m_events[unsigned - 1] or 0 for not played
 	NoteStatus m_notes;
 	std::vector<Duration> m_solos; /// holds guitar solos
@@ -2,6 +2,7 @@
 
 #include "configuration.hh"
 #include "libxml++.hh"
+#include "notes.hh"
 
 
 #include <algorithm>
@@ -131,5 +132,5 @@ void Hiscore::save(xmlpp::Element *hiscores) {
 }
 
 unsigned short Hiscore::currentLevel() const {
-	return config["game/difficulty"].ui();
+	return static_cast<unsigned short>(gameDifficulty());
 }
@@ -8,6 +8,22 @@
 
 #include <unicode/locid.h>
 
+#include <mutex>
+
+namespace {
+	using Translations = std::map<std::string, std::string, std::less<>>;
+	std::mutex translationsMutex;
+	/// Cached translations by locale and message. Entries are never removed, so references to them stay valid.
+	std::map<std::string, Translations> translationCache;
+	/// Translations for the locale currently set (the one that _() uses)
+	Translations* currentTranslations = &translationCache[""];
+
+	void selectTranslations(std::string const& locale) {
+		std::lock_guard<std::mutex> l(translationsMutex);
+		currentTranslations = &translationCache[locale];
+	}
+}
+
 std::pair<std::string, std::string> TranslationEngine::m_currentLanguage{"en_US.UTF-8", "English" };
 std::string TranslationEngine::m_package = PACKAGE;
 boost::locale::generator TranslationEngine::m_gen{};
@@ -72,11 +88,13 @@ void TranslationEngine::setLanguage(const std::string& language, bool fromSettin
 #endif
 		if (error.isFailure()) throw std::runtime_error("Error " + std::to_string(error.get()) + " creating search locale: " + error.errorName());
 		std::locale::global(m_gen(m_currentLanguage.first));
+		selectTranslations(m_currentLanguage.first);
 		SpdLogger::notice(LogSystem::I18N, "Current language: {}.", m_currentLanguage.second);
 	}
 	catch (std::runtime_error& e) {
 		SpdLogger::warning(LogSystem::I18N, "Unable to configure locale, will try to fallback to en_US.UTF-8. Exception={}", e.what());
 		std::locale::global(m_gen("en_US.UTF-8"));
+		selectTranslations("en_US.UTF-8");
 	}
 
 	icu::RuleBasedCollator* search;
@@ -95,12 +113,24 @@ std::to_string(error.get()) + ": " + error.errorName());
 	UnicodeUtil::m_sortCollator.reset(sort);
 	UnicodeUtil::m_searchCollator->setStrength(icu::Collator::PRIMARY);
 	UnicodeUtil::m_sortCollator->setStrength(icu::Collator::SECONDARY);
+	++UnicodeUtil::m_sortGeneration;
 
 	// We ideally want an ICU locale to feed to the case-mapping functions in UnicodeUtil.
 	auto icuLoc = icu::Locale::createCanonical(getCurrentLanguage().first.c_str());
 	TranslationEngine::m_icuLocale = std::make_unique<icu::Locale>(icuLoc);
 }
 
+std::string const& TranslationEngine::translateCached(std::string_view message) {
+	std::lock_guard<std::mutex> l(translationsMutex);
+	auto it = currentTranslations->find(message);
+	if (it == currentTranslations->end()) {
+		std::string key(message);
+		std::string translation = boost::locale::translate(key).str();
+		it = currentTranslations->emplace(std::move(key), std::move(translation)).first;
+	}
+	return it->second;
+}
+
 std::string TranslationEngine::getLanguageByHumanReadableName(const std::string& language) {
 	if (language == "Auto") {
 		return boost::locale::util::get_system_locale(true);
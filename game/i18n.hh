@@ -5,10 +5,13 @@
 
 #include <iostream>
 #include <string>
+#include <string_view>
 #include <map>
 #include <memory>
 
 #define _(x) boost::locale::translate(x).str()
+/// Like _(), but each message is translated only once per language; use for text that is drawn every frame
+#define _c(x) TranslationEngine::translateCached(x)
 #define translate_noop(x) x
 
 class TranslationEngine {
@@ -23,6 +26,9 @@ public:
 	static std::pair<std::string, std::string> const& getCurrentLanguage();
 	static std::map<std::string, std::string> GetAllLanguages(bool refresh = false);
 	static icu::Locale& getIcuLocale() { return *m_icuLocale; }
+	/// Translation of message in the current language. The reference stays valid (and unchanged) for the lifetime of the program;
+	/// after setLanguage, the next call returns another reference with the new translation.
+	static std::string const& translateCached(std::string_view message);
 
 private:
 	static std::vector<std::string> getLocalePaths();
@@ -2,6 +2,7 @@
 #include "image.hh"
 #include "log.hh"
 
+#include <boost/iostreams/device/mapped_file.hpp>
 #include <jpeglib.h>
 #include <png.h>
 #include <webp/decode.h>
@@ -11,6 +12,7 @@
 #include <string>
 #include <cstring>
 #include <algorithm>
+#include <array>
 
 namespace {
 	void writePngHelper(png_structp pngPtr, png_bytep data, png_size_t length) {
@@ -44,6 +46,20 @@ namespace {
 		png_write_end(pngPtr, nullptr);
 	}
 
+	/// Header of RAW files, followed by width * height * 4 bytes of pixel data
+	struct RawHeader {
+		std::array<char, 4> magic{{'P', 'R', 'A', 'W'}};
+		std::uint32_t version = 1;
+		std::uint32_t width = 0;
+		std::uint32_t height = 0;
+		std::uint32_t format = 0;  ///< pix::Format of the pixel data
+		std::uint32_t linearPremul = 0;
+		float ar = 0.0f;
+		std::uint32_t reserved = 0;
+		std::int64_t tag = 0;
+	};
+	static_assert(sizeof(RawHeader) == 40, "RawHeader must not contain padding");
+
 	struct my_jpeg_error_mgr {
 		struct jpeg_error_mgr pub;	/* "public" fields */
 		jmp_buf setjmp_buffer;	/* for return to caller */
@@ -186,6 +202,55 @@ void loadJPEG(Bitmap& bitmap, fs::path const& filename) {
 	jpeg_destroy_decompress(&cinfo);
 }
 
+void writeRAW(fs::path const& filename, Bitmap const& bitmap, std::int64_t tag) {
+	SpdLogger::debug(LogSystem::IMAGE, "Saving RAW file, path={}", filename);
+	if (bitmap.fmt != pix::Format::CHAR_RGBA && bitmap.fmt != pix::Format::INT_ARGB)
+		throw std::logic_error("Unsupported pixel format in writeRAW");
+	RawHeader header;
+	header.width = bitmap.width;
+	header.height = bitmap.height;
+	header.format = static_cast<std::uint32_t>(bitmap.fmt);
+	header.linearPremul = bitmap.linearPremul;
+	header.ar = bitmap.ar;
+	header.tag = tag;
+	std::ofstream file(filename, std::ios::binary);
+	file.write(reinterpret_cast<char const*>(&header), sizeof(header));
+	file.write(reinterpret_cast<char const*>(bitmap.data()), static_cast<std::streamsize>(std::size_t(bitmap.width) * bitmap.height * 4));
+	if (!file) throw std::runtime_error("Writing RAW failed: " + filename.string());
+}
+
+std::int64_t loadRAW(Bitmap& bitmap, fs::path const& filename) {
+	SpdLogger::debug(LogSystem::IMAGE, "Loading RAW file, path={}", filename);
+	namespace io = boost::iostreams;
+	// Private (copy-on-write) mapping so that the pixels may be modified without touching the file
+	auto file = std::make_shared<io::mapped_file>(filename.string(), io::mapped_file::priv);
+	RawHeader header;
+	if (file->size() < sizeof(header)) throw std::runtime_error("Truncated RAW file: " + filename.string());
+	std::memcpy(&header, file->const_data(), sizeof(header));
+	if (header.magic != RawHeader().magic || header.version != RawHeader().version)
+		throw std::runtime_error("Not a RAW file: " + filename.string());
+	if (file->size() != sizeof(header) + std::size_t(header.width) * header.height * 4)
+		throw std::runtime_error("Truncated RAW file: " + filename.string());
+	bitmap.buf.clear();
+	bitmap.ptr = reinterpret_cast<unsigned char*>(file->data()) + sizeof(header);
+	bitmap.owner = file;
+	bitmap.resize(header.width, header.height);
+	bitmap.fmt = static_cast<pix::Format>(header.format);
+	bitmap.linearPremul = header.linearPremul;
+	bitmap.ar = header.ar;
+	return header.tag;
+}
+
+void argbToRgba(unsigned char* data, std::size_t pixels) {
+	// Written with whole-pixel bit operations so that the compiler can vectorize the loop
+	for (std::size_t i = 0; i < pixels; ++i, data += 4) {
+		std::uint32_t pixel;
+		std::memcpy(&pixel, data, 4);
+		pixel = (pixel & 0xFF00FF00u) | ((pixel >> 16) & 0xFFu) | ((pixel & 0xFFu) << 16);
+		std::memcpy(data, &pixel, 4);
+	}
+}
+
 /**
   * \brief    Load a WEBP image from the given filename.  Throws a std::runtime_error on any error
   *
@@ -334,6 +399,53 @@ void Bitmap::crop(const unsigned width, const unsigned height, const unsigned x,
 	this->height = height;
 }
 
+void Bitmap::downscale(unsigned maxSize) {
+	if (maxSize == 0 || (width <= maxSize && height <= maxSize)) return;
+
+	unsigned bpp, stride;
+	switch (fmt) {
+	case pix::Format::INT_ARGB:
+	case pix::Format::CHAR_RGBA: bpp = 4; stride = width * 4; break;
+	case pix::Format::RGB: bpp = 3; stride = (width * 3 + 3) & ~3u; break;  // Word-aligned rows (see loadJPEG)
+	default: throw std::logic_error("Unsupported picture format.");
+	}
+
+	unsigned const longest = std::max(width, height);
+	unsigned const w = std::max(1u, static_cast<unsigned>(std::uint64_t(width) * maxSize / longest));
+	unsigned const h = std::max(1u, static_cast<unsigned>(std::uint64_t(height) * maxSize / longest));
+	std::vector<unsigned char> out(std::size_t(w) * h * 4);
+	unsigned char* dst = out.data();
+	for (unsigned y = 0; y < h; ++y) {
+		unsigned const y1 = static_cast<unsigned>(std::uint64_t(y) * height / h);
+		unsigned const y2 = std::max(y1 + 1, static_cast<unsigned>(std::uint64_t(y + 1) * height / h));
+		for (unsigned x = 0; x < w; ++x) {
+			unsigned const x1 = static_cast<unsigned>(std::uint64_t(x) * width / w);
+			unsigned const x2 = std::max(x1 + 1, static_cast<unsigned>(std::uint64_t(x + 1) * width / w));
+			// Average all source pixels covered by the destination pixel
+			std::uint32_t sum[4] = { 0, 0, 0, 0 };
+			for (unsigned sy = y1; sy < y2; ++sy) {
+				unsigned char const* src = data() + sy * stride + x1 * bpp;
+				for (unsigned sx = x1; sx < x2; ++sx, src += bpp) {
+					for (unsigned c = 0; c < bpp; ++c) sum[c] += src[c];
+				}
+			}
+			std::uint32_t const count = (y2 - y1) * (x2 - x1);
+			for (unsigned c = 0; c < bpp; ++c) dst[c] = static_cast<unsigned char>((sum[c] + count / 2) / count);
+			if (bpp == 3) dst[3] = 0xFF;
+			dst += 4;
+		}
+	}
+	float const aspect = ar;
+	// The result is always owned, also when the source was someone else's (e.g. a memory-mapped cache file)
+	buf.swap(out);
+	ptr = nullptr;
+	owner.reset();
+	width = w;
+	height = h;
+	ar = aspect;  // Keep the exact aspect ratio of the original image
+	if (fmt == pix::Format::RGB) fmt = pix::Format::CHAR_RGBA;
+}
+
 void Bitmap::copyFromCairo(cairo_surface_t* surface) {
 	unsigned width = static_cast<unsigned>(cairo_image_surface_get_width(surface));
 	unsigned height = static_cast<unsigned>(cairo_image_surface_get_height(surface));
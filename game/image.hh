@@ -6,6 +6,7 @@
 #include <algorithm>
 #include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <stdexcept>
 #include <vector>
 
@@ -21,6 +22,7 @@ namespace pix {
 struct Bitmap {
 	std::vector<unsigned char> buf;  // Pixel data if owned by Bitmap
 	unsigned char* ptr;  // Pixel data if owned by someone else
+	std::shared_ptr<void> owner;  // Keeps ptr alive when it points to memory we manage (e.g. a memory-mapped file)
 	unsigned width, height;
 	float ar;  // Aspect ratio
 	double timestamp;  // Used for video frames
@@ -35,8 +37,10 @@ struct Bitmap {
 		ar = float(w) / float(h);
 	}
 	void swap(Bitmap& b) {
-		if (ptr || b.ptr) throw std::logic_error("Cannot Bitmap::swap foreign pointers.");
+		if ((ptr && !owner) || (b.ptr && !b.owner)) throw std::logic_error("Cannot Bitmap::swap foreign pointers.");
 		buf.swap(b.buf);
+		std::swap(ptr, b.ptr);
+		owner.swap(b.owner);
 		std::swap(width, b.width);
 		std::swap(height, b.height);
 		std::swap(ar, b.ar);
@@ -47,6 +51,8 @@ struct Bitmap {
 	unsigned char* data() { return ptr ? ptr : buf.data(); }
 	void copyFromCairo(cairo_surface_t* surface);
 	void crop(const unsigned width, const unsigned height, const unsigned x, const unsigned y);
+	/// Box-filter the image so that neither side exceeds maxSize. The result is always four bytes per pixel.
+	void downscale(unsigned maxSize);
 };
 
 enum class ImageType { UNKNOWN, BMP, GIF, ICON, PNG, JPEG, SVG, WEBP,  _INVALID };  // Types of images we can identify
@@ -62,3 +68,11 @@ void loadPNG(Bitmap& bitmap, fs::path const& filename);
 void loadJPEG(Bitmap& bitmap, fs::path const& filename);
 void loadWEBP(Bitmap& bitmap, fs::path const& filename);
 
+// Uncompressed four bytes per pixel format used by our caches. The tag is stored in the header and returned when loading.
+// Loading maps the file into memory (Bitmap::ptr) instead of copying the pixels.
+void writeRAW(fs::path const& filename, Bitmap const& bitmap, std::int64_t tag = 0);
+std::int64_t loadRAW(Bitmap& bitmap, fs::path const& filename);
+
+/// Convert Cairo's native-endian ARGB pixels (BGRA byte order on little-endian) to RGBA byte order, in place.
+void argbToRgba(unsigned char* data, std::size_t pixels);
+
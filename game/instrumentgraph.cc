@@ -39,7 +39,8 @@ InstrumentGraph::InstrumentGraph(Game &game, Audio& audio, Song const& song, inp
   m_bigStreak(),
   m_countdown(3), // Display countdown 3 secs before note start
   m_dead(),
-  m_ready()
+  m_ready(),
+  m_controllerDelay("audio/controller_delay")
 {
 	double time = m_audio.getPosition();
 	m_jointime = time < 0.0 ? -1.0 : time + join_delay;
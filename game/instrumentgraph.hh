@@ -171,4 +171,5 @@ public:
 	double m_jointime; /// when the player joined
 	unsigned m_dead; /// how many notes has been passed without hitting buttons
 	bool m_ready;
+	ConfigValue<float> m_controllerDelay; /// subtracted from input event times
 };
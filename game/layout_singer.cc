@@ -71,11 +71,11 @@ void LayoutSinger::drawScore(Window& window, PositionMode position) {
 		if (p->m_prevLineScore > 0.5 && fact > 0) {
 			std::string prevLineRank;
 			double fzoom = 3.0 / (2.0 + fact);
-			if (p->m_prevLineScore > 0.95) prevLineRank = _("Perfect");
-			else if (p->m_prevLineScore > 0.9) prevLineRank = _("Excellent");
-			else if (p->m_prevLineScore > 0.8) prevLineRank = _("Great");
-			else if (p->m_prevLineScore > 0.6) prevLineRank = _("Good");
-			else if (p->m_prevLineScore > 0.4) prevLineRank = _("OK");
+			if (p->m_prevLineScore > 0.95) prevLineRank = _c("Perfect");
+			else if (p->m_prevLineScore > 0.9) prevLineRank = _c("Excellent");
+			else if (p->m_prevLineScore > 0.8) prevLineRank = _c("Great");
+			else if (p->m_prevLineScore > 0.6) prevLineRank = _c("Good");
+			else if (p->m_prevLineScore > 0.4) prevLineRank = _c("OK");
 			m_line_rank_text[i%4]->render(prevLineRank);
 			switch(position) {
 				case LayoutSinger::PositionMode::FULL:
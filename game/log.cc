@@ -122,17 +122,21 @@ struct StderrGrabber {
 };
 
 std::unique_ptr<StderrGrabber> SpdLogger::grabber;
+fs::path SpdLogger::m_logFilename;
 std::unordered_map<LogSystem, LoggerPtr> SpdLogger::builtLoggers;
 std::shared_ptr<spdlog::sinks::dist_sink_mt> SpdLogger::m_sink;
 std::shared_ptr<spdlog::sinks::basic_file_sink_mt> SpdLogger::m_profilerSink;
 std::shared_mutex SpdLogger::m_LoggerRegistryMutex;
 LoggerPtr SpdLogger::m_defaultLogger;
 LoggerPtr SpdLogger::m_ProfilerLogger;
+std::atomic<spdlog::level::level_enum> SpdLogger::m_minLevel{ spdlog::level::trace };
+LogRateLimiter SpdLogger::m_rateLimiters[LogSystem::COUNT];
+std::atomic<std::size_t> SpdLogger::m_rateLimited{ 0 };
 
-SpdLogger::SpdLogger (spdlog::level::level_enum const& consoleLevel) {
-	spdlog::init_thread_pool(2048, 1);
+SpdLogger::SpdLogger (spdlog::level::level_enum const& consoleLevel, fs::path const& logDir) {
+	spdlog::init_thread_pool(queueSize, 1);
 	
-	initializeSinks(consoleLevel);
+	initializeSinks(consoleLevel, logDir);
 
 	for (const auto& system: LogSystem()) {
 		if (system == LogSystem::LOGGER) continue;
@@ -156,15 +160,16 @@ LoggerPtr SpdLogger::constructLogger(const LogSystem system) {
 	return newLogger;
 }
 
-void SpdLogger::initializeSinks(spdlog::level::level_enum const& consoleLevel) {
+void SpdLogger::initializeSinks(spdlog::level::level_enum const& consoleLevel, fs::path const& logDir) {
 	auto const time = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch());
 	std::string logHeader(fmt::format(
 		"{0:*^80}\n"
 		"{1:*^80}\n",
 			fmt::format(" {} {} starting, {} ", PACKAGE, VERSION, timeFormat(time, "%Y/%m/%d @ %H:%M:%S")),
 			fmt::format(" Logging any events of level {}, or higher. ", spdlog::level::to_string_view(consoleLevel))));
-	spdlog::filename_t filename = PathCache::getLogFilename().u8string();
-	spdlog::filename_t profilerLogFilename = PathCache::getProfilerLogFilename().u8string();
+	m_logFilename = logDir.empty() ? PathCache::getLogFilename() : logDir / "infolog.txt";
+	spdlog::filename_t filename = m_logFilename.u8string();
+	spdlog::filename_t profilerLogFilename = (logDir.empty() ? PathCache::getProfilerLogFilename() : logDir / "profiler.txt").u8string();
 	m_sink = std::make_shared<spdlog::sinks::dist_sink_mt>();
 	
 	auto stdout_sink = std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
@@ -193,7 +198,7 @@ void SpdLogger::initializeSinks(spdlog::level::level_enum const& consoleLevel) {
 	m_sink->add_sink(stdout_sink);
 	m_sink->add_sink(stderr_sink);
 
-	m_defaultLogger = std::make_shared<spdlog::async_logger>(LogSystem{LogSystem::LOGGER}.toString(), m_sink, spdlog::thread_pool(), spdlog::async_overflow_policy::block);
+	m_defaultLogger = std::make_shared<spdlog::async_logger>(LogSystem{LogSystem::LOGGER}.toString(), m_sink, spdlog::thread_pool(), spdlog::async_overflow_policy::overrun_oldest);
 	
 	m_defaultLogger->set_level(spdlog::level::trace);
 	spdlog::set_default_logger(m_defaultLogger);
@@ -216,11 +221,15 @@ void SpdLogger::initializeSinks(spdlog::level::level_enum const& consoleLevel) {
 	
 	m_sink->set_pattern(formatString);
 
+	// The profiler sink, when added, shares the level of the file sink
+	auto minLevel = spdlog::level::off;
+	for (auto const& sink: m_sink->sinks()) minLevel = std::min(minLevel, sink->level());
+	m_minLevel = minLevel;
 }
 
 void SpdLogger::toggleProfilerLogger() {
 	if (!m_ProfilerLogger) {
-		m_ProfilerLogger = std::make_shared<spdlog::async_logger>(LogSystem{LogSystem::PROFILER}.toString(), m_profilerSink, spdlog::thread_pool(), spdlog::async_overflow_policy::block);
+		m_ProfilerLogger = std::make_shared<spdlog::async_logger>(LogSystem{LogSystem::PROFILER}.toString(), m_profilerSink, spdlog::thread_pool(), spdlog::async_overflow_policy::overrun_oldest);
 		m_ProfilerLogger->set_level(spdlog::level::trace);
 	}
 	if (config["graphic/fps"].b() == true && std::find(m_sink->sinks().begin(), m_sink->sinks().end(), m_profilerSink) == m_sink->sinks().end())  {
@@ -250,8 +259,23 @@ void SpdLogger::writeLogHeader(spdlog::filename_t filename, std::FILE* fd, std::
 	}
 }
 
+bool SpdLogger::allow(LogSystem::Values subsystem) {
+	auto const second = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	unsigned dropped = 0;
+	bool const ret = m_rateLimiters[subsystem].allow(second, rateLimit, dropped);
+	if (!ret) ++m_rateLimited;
+	if (dropped) notice(subsystem, "Too many messages, dropped={}.", dropped);
+	return ret;
+}
+
+std::size_t SpdLogger::dropped() {
+	auto pool = spdlog::thread_pool();
+	return m_rateLimited + (pool ? pool->overrun_counter() : 0);
+}
+
 SpdLogger::~SpdLogger() {
-	notice(LogSystem::LOGGER, "More details might be available in {}", PathCache::getLogFilename().u8string());
+	if (std::size_t count = dropped()) notice(LogSystem::LOGGER, "Log messages dropped={} (rate limited or queue full).", count);
+	notice(LogSystem::LOGGER, "More details might be available in {}", m_logFilename.u8string());
 	grabber.reset();
 	spdlog::shutdown();
 }
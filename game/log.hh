@@ -5,6 +5,9 @@
 
 #include <fmt/format.h>
 
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
 #include <shared_mutex>
 #include <stdexcept>
 #include <string>
@@ -53,13 +56,38 @@ struct fmt::formatter<LogSystem> : fmt::formatter<std::string> {
 
 struct StderrGrabber;
 
+/// Lets through at most a given number of messages per second and counts the rest. Lock-free, so that any thread may log.
+class LogRateLimiter {
+  public:
+	/// Return true if a message may be logged during the given second. When a new second begins, dropped is set to the
+	/// number of messages suppressed before it (otherwise to 0).
+	bool allow(std::int64_t second, unsigned limit, unsigned& dropped) {
+		dropped = 0;
+		std::int64_t window = m_window.load(std::memory_order_relaxed);
+		if (window != second && m_window.compare_exchange_strong(window, second, std::memory_order_relaxed)) {
+			m_count.store(0, std::memory_order_relaxed);
+			dropped = m_dropped.exchange(0, std::memory_order_relaxed);
+		}
+		if (m_count.fetch_add(1, std::memory_order_relaxed) < limit) return true;
+		m_dropped.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+  private:
+	std::atomic<std::int64_t> m_window{ 0 };
+	std::atomic<unsigned> m_count{ 0 };
+	std::atomic<unsigned> m_dropped{ 0 };
+};
+
 class SpdLogger {
   public:
-	SpdLogger(spdlog::level::level_enum const& consoleLevel = spdlog::level::info);
+	/// Log files go to logDir, or to the cache folder if empty
+	SpdLogger(spdlog::level::level_enum const& consoleLevel = spdlog::level::info, std::filesystem::path const& logDir = {});
 	~SpdLogger();
 
 	template <typename... Args>
 	static void log(LogSystem::Values subsystem, spdlog::level::level_enum level, Args &&...args) {
+		if (level < m_minLevel.load(std::memory_order_relaxed)) return;  // No sink takes it, don't bother formatting
+		if (level < spdlog::level::warn && !allow(subsystem)) return;  // Notices, warnings and errors are never rate limited
 		LoggerPtr logger;
 		try {
 			logger = getLogger(subsystem);
@@ -95,6 +123,16 @@ class SpdLogger {
 	static void trace(LogSystem::Values subsystem, Args &&...args) { log(subsystem, spdlog::level::trace, std::forward<Args>(args)...); }
 
 	static bool initialized() { return m_defaultLogger != nullptr; }
+	/// Send messages of all subsystems also to the given sink (e.g. to inspect them in tests)
+	static void addSink(spdlog::sink_ptr const& sink) { m_sink->add_sink(sink); }
+	static void removeSink(spdlog::sink_ptr const& sink) { m_sink->remove_sink(sink); }
+	/// Number of messages lost so far, either rate limited or overwritten in the queue before they were written
+	static std::size_t dropped();
+
+	/// Messages of level info and below each subsystem may log per second
+	static constexpr unsigned rateLimit = 200;
+	/// Messages the background thread may lag behind; when full, the oldest are dropped rather than blocking the caller
+	static constexpr std::size_t queueSize = 8192;
 
 	inline static const std::string newLineDec = "             └---"; // new line decorator.
   private:
@@ -107,8 +145,13 @@ class SpdLogger {
 	static LoggerPtr m_defaultLogger;
 	static LoggerPtr m_ProfilerLogger;
 	static void writeLogHeader(spdlog::filename_t filename, std::FILE* fd, std::string header);
-	static void initializeSinks(spdlog::level::level_enum const& consoleLevel = spdlog::level::info);
+	static void initializeSinks(spdlog::level::level_enum const& consoleLevel, std::filesystem::path const& logDir);
+	static std::filesystem::path m_logFilename;
 	static LoggerPtr constructLogger(const LogSystem system);
 	static std::unique_ptr<StderrGrabber> grabber;
+	static bool allow(LogSystem::Values subsystem);
+	static std::atomic<spdlog::level::level_enum> m_minLevel;
+	static LogRateLimiter m_rateLimiters[LogSystem::COUNT];
+	static std::atomic<std::size_t> m_rateLimited;
 
 };
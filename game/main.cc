@@ -4,14 +4,22 @@
 #include "controllers.hh"
 #include "database.hh"
 #include "engine.hh"
+#include "ffmpeg.hh"
+#include "framepacer.hh"
 #include "fs.hh"
 #include "graphic/glutil.hh"
+#include "graphic/glyph_atlas.hh"
 #include "i18n.hh"
 #include "log.hh"
 #include "platform.hh"
 #include "profiler.hh"
+#include "recorder.hh"
+#include "replay.hh"
 #include "screen.hh"
+#include "song.hh"
 #include "songs.hh"
+#include "startup.hh"
+#include "unicode.hh"
 #include "graphic/window.hh"
 #include "webcam.hh"
 #include "webserver.hh"
@@ -35,6 +43,7 @@
 #include <cstdint>
 #include <csignal>
 #include <iostream>
+#include <optional>
 #include <string>
 #include <thread>
 #include <vector>
@@ -44,6 +53,7 @@
 #define EXCEPTION std::exception
 
 bool g_take_screenshot = false;
+bool g_toggle_recording = false;
 
 static void checkEvents(Game& gm, Time eventTime) {
 	Window& window = gm.window();
@@ -64,7 +74,8 @@ static void checkEvents(Game& gm, Time eventTime) {
 				continue; // Already handled here...
 			}
 			if (key == SDL_SCANCODE_PRINTSCREEN || (key == SDL_SCANCODE_F12 && (mod & Platform::shortcutModifier()))) {
-				g_take_screenshot = true;
+				if (mod & KMOD_SHIFT) g_toggle_recording = true;  // Shift+PrintScreen
+				else g_take_screenshot = true;
 				continue; // Already handled here...
 			}
 			if (key == SDL_SCANCODE_F4 && mod & KMOD_ALT) {
@@ -102,68 +113,113 @@ static void checkEvents(Game& gm, Time eventTime) {
 void mainLoop(std::string const& songlist) {
 	Window window{};
 	SpdLogger::info(LogSystem::LOGGER, "Loading assets...");
-	TranslationEngine localization;
-	TextureLoader m_loader;
-	Backgrounds backgrounds;
-	Database database(PathCache::getConfigDir() / "database.xml");
-	Songs songs(database, songlist);
-	loadFonts();
+	// Constructed by the startup stages, destroyed in reverse order when leaving the main loop
+	std::optional<TranslationEngine> localization;
+	std::optional<TextureLoader> m_loader;
+	std::optional<Backgrounds> backgrounds;
+	std::optional<Database> database;
+	std::optional<Songs> songs;
+	std::optional<Game> game;
+	std::optional<WebServer> server;
 
-	window.start();
-	Game gm(window);
-	WebServer server(gm, songs);
-
-	auto& audio = gm.getAudio();
+	using Thread = Startup::Thread;
+	Startup startup;
+	// Sets the global locale, which must not change while other threads may be using it, so every worker waits for it
+	startup.add("translations", Thread::MAIN, {}, [&] { localization.emplace(); });
+	startup.add("textures", Thread::MAIN, {}, [&] { m_loader.emplace(); });
+	startup.add("backgrounds", Thread::WORKER, { "translations" }, [&] { backgrounds.emplace(); });
+	startup.add("database", Thread::WORKER, { "translations" }, [&] { database.emplace(PathCache::getConfigDir() / "database.xml"); });
+	startup.add("songs", Thread::WORKER, { "database", "translations" }, [&] { songs.emplace(*database, songlist); });
+	startup.add("fonts", Thread::WORKER, { "translations" }, [&] { loadFonts(); });
+	startup.add("window", Thread::MAIN, {}, [&] { window.start(); });
+	startup.add("fontmap", Thread::MAIN, { "fonts" }, [&] { selectFontMap(); });
+	startup.add("game", Thread::MAIN, { "translations", "textures", "window", "fontmap" }, [&] { game.emplace(window); });
+	startup.add("webserver", Thread::MAIN, { "game", "songs", "screens" }, [&] { server.emplace(*game, *songs); });
+	startup.add("samples", Thread::WORKER, { "game" }, [&] {
+		game->getAudio().loadSamples({
+			{ "drum bass", findFile("sounds/drum_bass.ogg") },
+			{ "drum snare", findFile("sounds/drum_snare.ogg") },
+			{ "drum hi-hat", findFile("sounds/drum_hi-hat.ogg") },
+			{ "drum tom1", findFile("sounds/drum_tom1.ogg") },
+			{ "drum cymbal", findFile("sounds/drum_cymbal.ogg") },
+			//{ "drum tom2", findFile("sounds/drum_tom2.ogg") },
+			{ "guitar fail1", findFile("sounds/guitar_fail1.ogg") },
+			{ "guitar fail2", findFile("sounds/guitar_fail2.ogg") },
+			{ "guitar fail3", findFile("sounds/guitar_fail3.ogg") },
+			{ "guitar fail4", findFile("sounds/guitar_fail4.ogg") },
+			{ "guitar fail5", findFile("sounds/guitar_fail5.ogg") },
+			{ "guitar fail6", findFile("sounds/guitar_fail6.ogg") },
+			{ "notice.ogg", findFile("notice.ogg") },
+		});
+	});
+	// Screens are only registered here; each is constructed when first used, except those used by other threads
+	startup.add("screens", Thread::MAIN, { "game", "songs", "database", "backgrounds" }, [&] {
+		Game& gm = *game;
+		Audio& audio = gm.getAudio();
+		gm.loading(_("Creating screens..."), 0.7f);
+		gm.addScreen("Intro", [&gm, &audio] { return std::make_unique<ScreenIntro>(gm, "Intro", audio); });
+		gm.addScreen("Songs", [&gm, &audio, &songs, &database] { return std::make_unique<ScreenSongs>(gm, "Songs", audio, *songs, *database); });
+		gm.addScreen("Sing", [&gm, &audio, &database, &backgrounds] { return std::make_unique<ScreenSing>(gm, "Sing", audio, *database, *backgrounds); });
+		gm.addScreen("Practice", [&gm, &audio] { return std::make_unique<ScreenPractice>(gm, "Practice", audio); });
+		gm.addScreen("AudioDevices", [&gm, &audio] { return std::make_unique<ScreenAudioDevices>(gm, "AudioDevices", audio); });
+		gm.addScreen("Paths", [&gm, &audio, &songs] { return std::make_unique<ScreenPaths>(gm, "Paths", audio, *songs); });
+		gm.addScreen("Players", [&gm, &audio, &database] { return std::make_unique<ScreenPlayers>(gm, "Players", audio, *database); });
+		gm.addScreen("Playlist", [&gm, &audio, &songs, &backgrounds] { return std::make_unique<ScreenPlaylist>(gm, "Playlist", audio, *songs, *backgrounds); });
+		// Looked up by the audio (Music::prepare) and the webserver threads, which must not construct them
+		gm.getScreen("Songs");
+		gm.getScreen("Playlist");
+	});
+	startup.add("intro", Thread::MAIN, { "screens", "samples", "webserver" }, [&] {
+		Game& gm = *game;
+		gm.activateScreen("Intro");
+		gm.loading(_("Entering main menu..."), 0.8f);
+		gm.updateScreen();  // exit/enter, any exception is fatal error
+		gm.loading(_("Loading complete!"), 1.0f);
+	});
+	startup.run();
+	Game& gm = *game;
 
-	// Load audio samples
-	gm.loading(_("Loading audio samples..."), 0.5f);
-	audio.loadSample("drum bass", findFile("sounds/drum_bass.ogg"));
-	audio.loadSample("drum snare", findFile("sounds/drum_snare.ogg"));
-	audio.loadSample("drum hi-hat", findFile("sounds/drum_hi-hat.ogg"));
-	audio.loadSample("drum tom1", findFile("sounds/drum_tom1.ogg"));
-	audio.loadSample("drum cymbal", findFile("sounds/drum_cymbal.ogg"));
-	//audio.loadSample("drum tom2", findFile("sounds/drum_tom2.ogg"));
-	audio.loadSample("guitar fail1", findFile("sounds/guitar_fail1.ogg"));
-	audio.loadSample("guitar fail2", findFile("sounds/guitar_fail2.ogg"));
-	audio.loadSample("guitar fail3", findFile("sounds/guitar_fail3.ogg"));
-	audio.loadSample("guitar fail4", findFile("sounds/guitar_fail4.ogg"));
-	audio.loadSample("guitar fail5", findFile("sounds/guitar_fail5.ogg"));
-	audio.loadSample("guitar fail6", findFile("sounds/guitar_fail6.ogg"));
-	audio.loadSample("notice.ogg",findFile("notice.ogg"));
-	// Load screens
-	gm.loading(_("Creating screens..."), 0.7f);
-	gm.addScreen(std::make_unique<ScreenIntro>(gm, "Intro", audio));
-	gm.addScreen(std::make_unique<ScreenSongs>(gm, "Songs", audio, songs, database));
-	gm.addScreen(std::make_unique<ScreenSing>(gm, "Sing", audio, database, backgrounds));
-	gm.addScreen(std::make_unique<ScreenPractice>(gm, "Practice", audio));
-	gm.addScreen(std::make_unique<ScreenAudioDevices>(gm, "AudioDevices", audio));
-	gm.addScreen(std::make_unique<ScreenPaths>(gm, "Paths", audio, songs));
-	gm.addScreen(std::make_unique<ScreenPlayers>(gm, "Players", audio, database));
-	gm.addScreen(std::make_unique<ScreenPlaylist>(gm, "Playlist", audio, songs, backgrounds));
-	gm.activateScreen("Intro");
-	gm.loading(_("Entering main menu..."), 0.8f);
-	gm.updateScreen();  // exit/enter, any exception is fatal error
-	gm.loading(_("Loading complete!"), 1.0f);
 	// Main loop
 	auto time = Clock::now();
 	unsigned frames = 0;
+	FramePacer pacer;
+	int swapInterval = -1;
+	int maxSwapInterval = 0;  // Lowered if the driver rejects swap intervals
+	bool vsyncSupported = true;
+	pacer.begin(time);
 	SpdLogger::info(LogSystem::LOGGER, "Assets loaded, entering main loop.");
 	while (!gm.isFinished()) {
 		Profiler prof("mainloop");
 		bool benchmarking = config["graphic/fps"].b();
-		if (songs.doneLoading == true && songs.displayedAlert == false) {
-			gm.dialog(fmt::format(_("Done Loading!\n Loaded {0} songs."), songs.loadedSongs()));
-			songs.displayedAlert = true;
+		FramePacer::Settings pacing;
+		pacing.refreshRate = window.refreshRate();
+		// Benchmarking measures how fast frames can be drawn, so the swap must not wait for vsync
+		pacing.vsync = vsyncSupported && !benchmarking && config["graphic/vsync"].b();
+		pacing.maxFps = config["graphic/max_fps"].ui();
+		pacing.lateLatch = config["graphic/late_latch"].b();
+		pacing.maxSwapInterval = maxSwapInterval;
+		pacer.configure(pacing);
+		if (pacer.swapInterval() != swapInterval) {
+			swapInterval = pacer.swapInterval();
+			// Without vsync the pacer paces frames by sleeping from the next frame on. If the driver only supports swapping
+			// on every vsync, keep that and let the pacer skip frames by sleeping; without any vsync, swap immediately.
+			if (!window.setSwapInterval(swapInterval)) {
+				if (swapInterval > 1) maxSwapInterval = 1;
+				else if (swapInterval == 1) vsyncSupported = false;
+			}
 		}
-		if (g_take_screenshot) {
+		if (songs->doneLoading == true && songs->displayedAlert == false) {
+			gm.dialog(fmt::format(_("Done Loading!\n Loaded {0} songs."), songs->loadedSongs()));
+			songs->displayedAlert = true;
+		}
+		if (g_toggle_recording) {
 			try {
-				window.screenshot();
-				gm.flashMessage(_("Screenshot taken!"));
+				gm.flashMessage(window.toggleRecording() ? _("Recording started!") : _("Recording stopped!"));
 			} catch (EXCEPTION& e) {
-				SpdLogger::error(LogSystem::IMAGE, "Screenshot failed, exception={}", e.what());
-				gm.flashMessage(_("Screenshot failed!"));
+				SpdLogger::error(LogSystem::IMAGE, "Recording failed, exception={}", e.what());
+				gm.flashMessage(_("Recording failed!"));
 			}
-			g_take_screenshot = false;
+			g_toggle_recording = false;
 		}
 		gm.updateScreen();  // exit/enter, any exception is fatal error
 		if (benchmarking) prof("misc");
@@ -172,24 +228,42 @@ void mainLoop(std::string const& songlist) {
 			// Draw
 			window.render(gm, [&gm]{ gm.drawScreen(); });
 			if (benchmarking) { glFinish(); prof("draw"); }
+			// Queue readback of this frame; encoding happens in the background
+			if (g_take_screenshot) {
+				try {
+					window.screenshot();
+					gm.flashMessage(_("Screenshot taken!"));
+				} catch (EXCEPTION& e) {
+					SpdLogger::error(LogSystem::IMAGE, "Screenshot failed, exception={}", e.what());
+					gm.flashMessage(_("Screenshot failed!"));
+				}
+				g_take_screenshot = false;
+			}
+			window.captureFrame();
+			if (benchmarking) prof("capture");
+			pacer.rendered(Clock::now());
 			// Display (and wait until next frame)
 			window.swap();
 			if (benchmarking) { glFinish(); prof("swap"); }
+			pacer.presented(Clock::now(), gm.getCurrentScreen() ? gm.getCurrentScreen()->getName() : std::string());
+			Startup::interactive();
 			updateTextures();
 			gm.prepareScreen();
 			if (benchmarking) { glFinish(); prof("textures"); }
 			if (benchmarking) {
 				++frames;
 				if (Clock::now() - time > 1s) {
-					gm.flashMessage(fmt::format("{} FPS", frames));
+					gm.flashMessage(fmt::format("{} FPS, {} draw calls per frame, {} glyphs rasterized", frames, glutil::VertexArray::drawCalls() / frames, GlyphAtlas::rasterizations()));
 					time += 1s;
 					frames = 0;
 				}
 			} else {
-				std::this_thread::sleep_until(time + 10ms); // Max 100 FPS
+				// Wait until the next frame is due (with vsync usually not at all, the swap already waited)
+				std::this_thread::sleep_until(pacer.wakeUp(Clock::now()));
 				time = Clock::now();
 				frames = 0;
 			}
+			pacer.begin(Clock::now());
 			if (benchmarking) prof("fpsctrl");
 			// Process events for the next frame
 			auto eventTime = Clock::now();
@@ -201,6 +275,8 @@ void mainLoop(std::string const& songlist) {
 				gm.flashMessage(std::string("ERROR: ") + e.what());
 		}
 	}
+	std::string const frameTimes = pacer.report();
+	if (!frameTimes.empty()) SpdLogger::info(LogSystem::PROFILER, "Frame times per screen:\n{}", frameTimes);
 
 	writeConfig(gm);
 }
@@ -252,6 +328,35 @@ void jstestLoop() {
 	return;
 }
 
+/// Headless replay of recorded mic captures against a song, printing the scores and the time spent per engine stage
+void replayCaptures(fs::path const& songfile, std::vector<std::string> const& captures) {
+	static char const* const mics[] = { "blue", "red", "green", "yellow", "fuchsia", "orange", "purple", "aqua", "white", "gray", "black" };
+	unsigned const rate = 48000;
+	if (captures.empty()) throw std::runtime_error("--replay requires at least one --capture");
+	if (captures.size() > std::size(mics)) throw std::runtime_error("Too many captures for replay");
+	Song song(songfile);
+	song.loadNotes(false);
+	std::vector<ReplayCapture> input;
+	for (auto const& capture: captures) {
+		// Captures are assigned to the vocal tracks in order (duets); any further ones sing the lead vocals
+		auto const idx = static_cast<unsigned>(input.size());
+		VocalTrack& vocal = idx < song.vocalTracks.size() ? song.getVocalTrack(idx) : song.getVocalTrack(TrackName::VOCAL_LEAD);
+		std::vector<float> const stereo = decodeAudio(capture, rate);
+		std::vector<float> mono(stereo.size() / 2);
+		for (size_t i = 0; i < mono.size(); ++i) mono[i] = 0.5f * (stereo[2 * i] + stereo[2 * i + 1]);
+		alignCapture(mono, Recorder::startTime(capture), rate);
+		input.push_back({ mics[idx], &vocal, std::move(mono) });
+	}
+	ReplayResult const result = replay(input, rate);
+	for (size_t i = 0; i < input.size(); ++i) {
+		std::cout << fmt::format("{} ({}, {}): score {}", captures[i], input[i].mic, input[i].vocal->name, result.scores[i]) << std::endl;
+	}
+	std::cout << fmt::format("Replayed {:.2f} s of song in {:.3f} s ({:.0f}x real time), {} steps", result.songTime(), result.elapsed,
+	  result.songTime() / result.elapsed, result.steps) << std::endl;
+	std::cout << fmt::format("  analyze: {}", result.analyze) << std::endl;
+	std::cout << fmt::format("  score:   {}", result.score) << std::endl;
+}
+
 template <typename Container> void confOverride(Container const& c, std::string const& name) {
 	if (c.empty()) return;  // Don't override if no options specified
 	ConfigItem::StringList& sl = config[name].sl();
@@ -282,6 +387,8 @@ int main(int argc, char** argv) {
 	po::options_description opt1("Generic options", 160, 80);
 	std::string songlist;
 	std::string logLevel;
+	std::string replaySong;
+	std::vector<std::string> replayCaptureFiles;
 	opt1.add_options()
 	  ("help,h", "Print this message.")
 	  ("?,?", "Print this message.")
@@ -292,7 +399,9 @@ int main(int argc, char** argv) {
 	opt2.add_options()
 	  ("audio", po::value<std::vector<std::string> >(&devices)->value_name("<device>")->composing(), "Specify a string to match audio devices to use; see audiohelp for details.")
 	  ("audiohelp", "Print audio related information")
-	  ("jstest", "Utility to get joystick button mappings");
+	  ("jstest", "Utility to get joystick button mappings")
+	  ("replay", po::value<std::string>(&replaySong)->value_name("<songfile>"), "Score recorded mic captures (see --capture) against the given song without audio devices, and print the scores and timing")
+	  ("capture", po::value<std::vector<std::string> >(&replayCaptureFiles)->value_name("<file>")->composing(), "Mic capture for --replay, aligned to the song start; one per singer, assigned to the vocal tracks in order");
 	po::options_description opt3("Hidden options");
 	opt3.add_options()
 	  ("songdir", po::value<std::vector<std::string> >(&songdirs)->composing(), "");
@@ -339,6 +448,8 @@ int main(int argc, char** argv) {
 		outputOptionalFeatureStatus();
 
 		readConfig();
+		initGameDifficulty();
+		UnicodeUtil::observeSortingIgnore();
 		SpdLogger::toggleProfilerLogger();
 
 		if (vm.count("audiohelp")) {
@@ -368,6 +479,10 @@ int main(int argc, char** argv) {
 			SpdLogger::info(LogSystem::LOGGER, "Exiting normally.");
 			return EXIT_SUCCESS;
 		}
+		if (vm.count("replay")) {
+			replayCaptures(replaySong, replayCaptureFiles);
+			return EXIT_SUCCESS;
+		}
 		// Run the game init and main loop
 		mainLoop(songlist);
 		SpdLogger::info(LogSystem::LOGGER, "Exiting normally.");
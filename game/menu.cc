@@ -89,7 +89,10 @@ void Menu::action(Game& game, int dir) {
 		}
 		case MenuOption::Type::SET_AND_CLOSE:
 			SpdLogger::debug(LogSystem::LOGGER, "Selected menu option={}", current().getName());
-			if (current().value) *(current().value) = current().newValue;
+			if (current().value) {
+				*(current().value) = current().newValue;
+				current().value->notify();
+			}
 			[[fallthrough]];  // Continuing to CLOSE_SUBMENU is intentional
 		case MenuOption::Type::CLOSE_SUBMENU: {
 			closeSubmenu();
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+/**
+ * Bounded lock-free queue with any number of producers and a single consumer (Vyukov's bounded queue).
+ * Each cell carries a sequence number telling whether it is free for the producer of a given position or
+ * filled for the consumer, so neither side ever waits for a lock. Pushing to a full queue fails instead of blocking.
+ */
+template <typename T> class MpscQueue {
+  public:
+	/// Capacity is rounded up to a power of two
+	explicit MpscQueue(std::size_t capacity): m_mask(roundUp(capacity) - 1), m_cells(std::make_unique<Cell[]>(m_mask + 1)) {
+		for (std::size_t i = 0; i <= m_mask; ++i) m_cells[i].sequence.store(i, std::memory_order_relaxed);
+	}
+	std::size_t capacity() const { return m_mask + 1; }
+	/// Append a value (any thread); returns false if the queue is full
+	bool push(T const& value) {
+		std::size_t pos = m_enqueue.load(std::memory_order_relaxed);
+		Cell* cell;
+		while (true) {
+			cell = &m_cells[pos & m_mask];
+			auto const diff = static_cast<std::intptr_t>(cell->sequence.load(std::memory_order_acquire)) - static_cast<std::intptr_t>(pos);
+			if (diff == 0 && m_enqueue.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;  // Claimed the cell
+			if (diff < 0) return false;  // The consumer has not freed the cell yet: full
+			if (diff > 0) pos = m_enqueue.load(std::memory_order_relaxed);  // Another producer got it first
+		}
+		cell->value = value;
+		cell->sequence.store(pos + 1, std::memory_order_release);
+		return true;
+	}
+	/// Take the oldest value (consumer thread only); returns false if the queue is empty
+	bool pop(T& value) {
+		Cell& cell = m_cells[m_dequeue & m_mask];
+		if (cell.sequence.load(std::memory_order_acquire) != m_dequeue + 1) return false;
+		value = std::move(cell.value);
+		cell.sequence.store(m_dequeue + m_mask + 1, std::memory_order_release);
+		++m_dequeue;
+		return true;
+	}
+
+  private:
+	static std::size_t roundUp(std::size_t n) {
+		std::size_t size = 1;
+		while (size < n) size <<= 1;
+		return size;
+	}
+	struct Cell {
+		std::atomic<std::size_t> sequence;
+		T value;
+	};
+	std::size_t const m_mask;
+	std::unique_ptr<Cell[]> m_cells;
+	alignas(64) std::atomic<std::size_t> m_enqueue{ 0 };
+	alignas(64) std::size_t m_dequeue = 0;
+};
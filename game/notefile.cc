@@ -0,0 +1,180 @@
+#include "notefile.hh"
+
+namespace notefile {
+	namespace {
+		constexpr char magic[8] = { 'P', 'N', 'O', 'T', 'E', 'S', '\r', '\n' };
+		constexpr std::uint32_t byteOrder = 0x01020304;
+	}
+
+	Writer::Writer() {
+		m_data.append(magic, sizeof(magic));
+		put(version);
+		put(byteOrder);
+	}
+
+	void Writer::put(std::string_view str) {
+		put(static_cast<std::uint32_t>(str.size()));
+		m_data.append(str);
+	}
+
+	void Writer::put(Duration const& duration) {
+		put(duration.begin);
+		put(duration.end);
+	}
+
+	void Writer::put(Note const& note) {
+		// Gameplay state (power, stars) is not stored
+		put(note.begin);
+		put(note.end);
+		put(note.phase);
+		put(note.type);
+		put(note.note);
+		put(note.notePrev);
+		put(note.syllable);
+	}
+
+	void Writer::put(VocalTrack const& track) {
+		put(track.name);
+		put(track.notes);
+		put(track.noteMin);
+		put(track.noteMax);
+		put(track.beginTime);
+		put(track.endTime);
+		put(track.m_scoreFactor);
+	}
+
+	void Writer::put(InstrumentTrack const& track) {
+		put(track.name);
+		put(static_cast<std::uint32_t>(track.nm.size()));
+		for (auto const& [fret, durations]: track.nm) {
+			put(fret);
+			put(durations);
+		}
+	}
+
+	void Writer::put(DanceTrack const& track) {
+		put(track.description);
+		put(track.notes);
+	}
+
+	void Writer::put(VocalTracks const& tracks) {
+		put(static_cast<std::uint32_t>(tracks.size()));
+		for (auto const& [name, track]: tracks) {
+			put(name);
+			put(track);
+		}
+	}
+
+	void Writer::put(InstrumentTracks const& tracks) {
+		put(static_cast<std::uint32_t>(tracks.size()));
+		for (auto const& [name, track]: tracks) {
+			put(name);
+			put(track);
+		}
+	}
+
+	void Writer::put(DanceTracks const& tracks) {
+		put(static_cast<std::uint32_t>(tracks.size()));
+		for (auto const& [type, difficulties]: tracks) {
+			put(type);
+			put(static_cast<std::uint32_t>(difficulties.size()));
+			for (auto const& [difficulty, track]: difficulties) {
+				put(difficulty);
+				put(track);
+			}
+		}
+	}
+
+	Reader::Reader(std::string data): m_data(std::move(data)) {
+		if (m_data.size() < sizeof(magic) || std::memcmp(m_data.data(), magic, sizeof(magic)) != 0) throw std::runtime_error("Not a notes file");
+		m_pos = sizeof(magic);
+		std::uint32_t fileVersion, fileByteOrder;
+		get(fileVersion);
+		get(fileByteOrder);
+		if (fileVersion != version) throw std::runtime_error("Unsupported notes file version " + std::to_string(fileVersion));
+		if (fileByteOrder != byteOrder) throw std::runtime_error("Notes file is from a platform with different byte order");
+	}
+
+	char const* Reader::take(std::size_t bytes) {
+		if (m_data.size() - m_pos < bytes) throw std::runtime_error("Truncated notes file");
+		char const* ptr = m_data.data() + m_pos;
+		m_pos += bytes;
+		return ptr;
+	}
+
+	std::uint32_t Reader::count(std::size_t minElementSize) {
+		std::uint32_t size;
+		get(size);
+		if (size > (m_data.size() - m_pos) / minElementSize) throw std::runtime_error("Truncated notes file");
+		return size;
+	}
+
+	void Reader::get(std::string& str) {
+		std::uint32_t const size = count(1);
+		str.assign(take(size), size);
+	}
+
+	void Reader::get(Duration& duration) {
+		get(duration.begin);
+		get(duration.end);
+	}
+
+	void Reader::get(Note& note) {
+		get(note.begin);
+		get(note.end);
+		get(note.phase);
+		get(note.type);
+		get(note.note);
+		get(note.notePrev);
+		get(note.syllable);
+	}
+
+	void Reader::get(VocalTracks& tracks) {
+		tracks.clear();
+		for (std::uint32_t i = 0, size = count(8); i < size; ++i) {
+			std::string key, name;
+			get(key);
+			get(name);
+			VocalTrack& track = tracks.insert_or_assign(key, VocalTrack(name)).first->second;
+			get(track.notes);
+			get(track.noteMin);
+			get(track.noteMax);
+			get(track.beginTime);
+			get(track.endTime);
+			get(track.m_scoreFactor);
+		}
+	}
+
+	void Reader::get(InstrumentTracks& tracks) {
+		tracks.clear();
+		for (std::uint32_t i = 0, size = count(8); i < size; ++i) {
+			std::string key, name;
+			get(key);
+			get(name);
+			InstrumentTrack& track = tracks.insert_or_assign(key, InstrumentTrack(name)).first->second;
+			for (std::uint32_t j = 0, frets = count(8); j < frets; ++j) {
+				unsigned fret;
+				get(fret);
+				get(track.nm[fret]);
+			}
+		}
+	}
+
+	void Reader::get(DanceTracks& tracks) {
+		tracks.clear();
+		for (std::uint32_t i = 0, size = count(8); i < size; ++i) {
+			std::string type;
+			get(type);
+			DanceDifficultyMap& difficulties = tracks[type];
+			for (std::uint32_t j = 0, entries = count(8); j < entries; ++j) {
+				DanceDifficulty difficulty;
+				std::string description;
+				Notes notes;
+				get(difficulty);
+				get(description);
+				get(notes);
+				difficulties.insert_or_assign(difficulty, DanceTrack(description, notes));
+			}
+		}
+	}
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "notes.hh"
+
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * Compact binary serialization of parsed note data, used by the notes cache (see cache::loadNotes).
+ * Values are stored in native byte order; files written on another platform are rejected by the header check.
+ * Bump version whenever the layout or the parsers' output changes, so that old cached files are ignored.
+ */
+namespace notefile {
+	constexpr std::uint32_t version = 1;
+
+	/// Appends values to a byte buffer
+	class Writer {
+	  public:
+		Writer();  ///< Starts with the file header
+		template <typename T, typename = std::enable_if_t<std::is_arithmetic_v<T> || std::is_enum_v<T>>> void put(T value) {
+			m_data.append(reinterpret_cast<char const*>(&value), sizeof(value));
+		}
+		void put(std::string_view str);
+		void put(std::string const& str) { put(std::string_view(str)); }  ///< Not ambiguous with the track constructors
+		void put(Duration const& duration);
+		void put(Note const& note);
+		void put(VocalTrack const& track);
+		void put(InstrumentTrack const& track);
+		void put(DanceTrack const& track);
+		void put(VocalTracks const& tracks);
+		void put(InstrumentTracks const& tracks);
+		void put(DanceTracks const& tracks);
+		template <typename T> void put(std::vector<T> const& values) {
+			put(static_cast<std::uint32_t>(values.size()));
+			for (auto const& value: values) put(value);
+		}
+		template <typename A, typename B> void put(std::pair<A, B> const& pair) { put(pair.first); put(pair.second); }
+		std::string const& data() const { return m_data; }
+
+	  private:
+		std::string m_data;
+	};
+
+	/// Reads values written by Writer from a buffer, throwing std::runtime_error on truncated or invalid data
+	class Reader {
+	  public:
+		explicit Reader(std::string data);  ///< Takes the whole file and checks its header
+		template <typename T, typename = std::enable_if_t<std::is_arithmetic_v<T> || std::is_enum_v<T>>> void get(T& value) {
+			std::memcpy(&value, take(sizeof(value)), sizeof(value));
+		}
+		void get(std::string& str);
+		void get(Duration& duration);
+		void get(Note& note);
+		void get(VocalTracks& tracks);
+		void get(InstrumentTracks& tracks);
+		void get(DanceTracks& tracks);
+		template <typename T> void get(std::vector<T>& values) {
+			std::uint32_t const size = count(sizeof(T) < 8 ? sizeof(T) : 8);
+			values.clear();
+			values.reserve(size);
+			for (std::uint32_t i = 0; i < size; ++i) {
+				values.emplace_back();
+				get(values.back());
+			}
+		}
+		template <typename A, typename B> void get(std::pair<A, B>& pair) { get(pair.first); get(pair.second); }
+		bool done() const { return m_pos == m_data.size(); }
+
+	  private:
+		char const* take(std::size_t bytes);
+		/// Read an element count, rejecting counts that cannot fit in the remaining data
+		std::uint32_t count(std::size_t minElementSize);
+		std::string m_data;
+		std::size_t m_pos = 0;
+	};
+}
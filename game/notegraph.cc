@@ -16,7 +16,7 @@ NoteGraph::NoteGraph(VocalTrack const& vocal, NoteGraphScalerPtr const& scaler):
   m_notebar(findFile("notebar.svg")), m_notebar_hl(findFile("notebar_hi.svg")),
   m_notebarfs(findFile("notebarfs.svg")), m_notebarfs_hl(findFile("notebarfs_hi.svg")),
   m_notebargold(findFile("notebargold.svg")), m_notebargold_hl(findFile("notebargold_hi.svg")),
-  m_notealpha(0.0f), m_nlTop(0.0, 4.0), m_nlBottom(0.0, 4.0), m_time(), m_scaler(scaler)
+  m_notealpha(0.0f), m_nlTop(0.0, 4.0), m_nlBottom(0.0, 4.0), m_time(), m_scaler(scaler), m_pitch("game/pitch")
 {
 	dimensions.stretch(1.0f, 0.5f); // Initial dimensions, probably overridden from somewhere
 	m_nlTop.setTarget(m_vocal.noteMax, true);
@@ -29,40 +29,48 @@ NoteGraph::NoteGraph(VocalTrack const& vocal, NoteGraphScalerPtr const& scaler):
 
 void NoteGraph::reset() {
 	m_songit = m_vocal.notes.begin();
+	m_visibleNotes.reset(m_vocal.notes.begin(), m_vocal.notes.end());
+	m_waves.clear();
 }
 
 namespace {
-	void drawNotebar(Window& window, Texture const& texture, float x, float ybeg, float yend, float w, float h_x, float h_y) {
+	/// Append a notebar to a triangle strip of notebars (that use the same texture)
+	void addNotebar(glutil::VertexArray& bars, float x, float ybeg, float yend, float w, float h_x, float h_y, glmath::vec4 const& c) {
 		glutil::VertexArray va;
-		UseTexture tblock(window, texture);
 
 		// The front cap begins
-		va.texCoord(0.0f, 0.0f).vertex(x, ybeg);
-		va.texCoord(0.0f, 1.0f).vertex(x, ybeg + h_y);
+		va.color(c).texCoord(0.0f, 0.0f).vertex(x, ybeg);
+		va.color(c).texCoord(0.0f, 1.0f).vertex(x, ybeg + h_y);
 		if (w >= 2.0f * h_x) {
 			// Calculate the y coordinates of the middle part
 			float tmp = h_x / w;  // h_x = cap size (because it is a h_x by h_x square)
 			float y1 = (1.0f - tmp) * ybeg + tmp * yend;
 			float y2 = tmp * ybeg + (1.0f - tmp) * yend;
 			// The middle part between caps
-			va.texCoord(0.5f, 0.0f).vertex(x + h_x, y1);
-			va.texCoord(0.5f, 1.0f).vertex(x + h_x, y1 + h_y);
-			va.texCoord(0.5f, 0.0f).vertex(x + w - h_x, y2);
-			va.texCoord(0.5f, 1.0f).vertex(x + w - h_x, y2 + h_y);
+			va.color(c).texCoord(0.5f, 0.0f).vertex(x + h_x, y1);
+			va.color(c).texCoord(0.5f, 1.0f).vertex(x + h_x, y1 + h_y);
+			va.color(c).texCoord(0.5f, 0.0f).vertex(x + w - h_x, y2);
+			va.color(c).texCoord(0.5f, 1.0f).vertex(x + w - h_x, y2 + h_y);
 		} else {
 			// Note is too short to even fit caps, crop to fit.
 			float ymid = 0.5f * (ybeg + yend);
 			float crop = 0.25f * w / h_x;
-			va.texCoord(crop, 0.0f).vertex(x + 0.5f * w, ymid);
-			va.texCoord(crop, 1.0f).vertex(x + 0.5f * w, ymid + h_y);
-			va.texCoord(1.0f - crop, 0.0f).vertex(x + 0.5f * w, ymid);
-			va.texCoord(1.0f - crop, 1.0f).vertex(x + 0.5f * w, ymid + h_y);
+			va.color(c).texCoord(crop, 0.0f).vertex(x + 0.5f * w, ymid);
+			va.color(c).texCoord(crop, 1.0f).vertex(x + 0.5f * w, ymid + h_y);
+			va.color(c).texCoord(1.0f - crop, 0.0f).vertex(x + 0.5f * w, ymid);
+			va.color(c).texCoord(1.0f - crop, 1.0f).vertex(x + 0.5f * w, ymid + h_y);
 		}
 		// The rear cap ends
-		va.texCoord(1.0f, 0.0f).vertex(x + w, yend);
-		va.texCoord(1.0f, 1.0f).vertex(x + w, yend + h_y);
+		va.color(c).texCoord(1.0f, 0.0f).vertex(x + w, yend);
+		va.color(c).texCoord(1.0f, 1.0f).vertex(x + w, yend + h_y);
 
-		va.draw();
+		bars.strip(va);
+	}
+
+	void drawNotebars(Window& window, Texture const& texture, glutil::VertexArray& bars) {
+		if (bars.empty()) return;
+		UseTexture tblock(window, texture);
+		bars.draw();
 	}
 }
 
@@ -70,9 +78,10 @@ const float baseLine = -0.2f;
 const float pixUnit = 0.2f;
 
 void NoteGraph::draw(Window& window, double time, Database const& database, Position position) {
-	if (time < m_time) reset();
 	m_time = time;
-	// Update m_songit (which note to start the rendering from)
+	// Update m_songit (which note to start the rendering from), seeking back if rewound
+	m_visibleNotes.update(time - (baseLine + 0.5f) / pixUnit, time - (baseLine - 0.5f) / pixUnit);
+	m_songit = m_visibleNotes.begin();
 	while (m_songit != m_vocal.notes.end() && (m_songit->type == Note::Type::SLEEP || m_songit->end < time - (baseLine + 0.5f) / pixUnit)) ++m_songit;
 
 	// Automatically zooming notelines
@@ -115,7 +124,7 @@ void NoteGraph::draw(Window& window, double time, Database const& database, Posi
 	ColorTrans c(window, Color::alpha(m_notealpha));
 
 	drawNotes(window);
-	if (config["game/pitch"].b())
+	if (m_pitch)
 		drawWaves(window, database);
 
 	// Draw a star for well sung notes
@@ -146,20 +155,21 @@ void NoteGraph::drawNotes(Window& window) {
 	// Draw note lines
 	m_notelines.draw(window, Dimensions().stretch(dimensions.w(), (m_max - m_min - 13) * m_noteUnit).middle(dimensions.xc()).center(dimensions.yc()), TexCoords(0.0f, (-m_min - 7.0f) / 12.0f, 1.0f, (-m_max + 6.0f) / 12.0f));
 
-	// Draw notes
+	// Draw notes, collecting the bars of each texture into a single strip
+	glutil::VertexArray bars, barsHl, gold, goldHl;
 	for (auto it = m_songit; it != m_vocal.notes.end() && it->begin < m_time - (baseLine - 0.5f) / pixUnit; ++it) {
 		if (it->type == Note::Type::SLEEP) continue;
 		float alpha = it->power;
-		Texture* t1;
-		Texture* t2;
+		glutil::VertexArray* t1;
+		glutil::VertexArray* t2;
 		switch (it->type) {
 			case Note::Type::NORMAL:
 			case Note::Type::SLIDE:
-				t1 = &m_notebar; t2 = &m_notebar_hl;
+				t1 = &bars; t2 = &barsHl;
 			break;
 			case Note::Type::GOLDEN:
 			case Note::Type::GOLDENRAP: //fallthrough
-				t1 = &m_notebargold; t2 = &m_notebargold_hl;
+				t1 = &gold; t2 = &goldHl;
 			break;
 			case Note::Type::FREESTYLE:  // Freestyle notes use custom handling
 			case Note::Type::RAP: //handle RAP notes like freestyle for now
@@ -191,12 +201,13 @@ void NoteGraph::drawNotes(Window& window) {
 		float w = static_cast<float>(it->end - it->begin) * pixUnit - m_noteUnit * 2.0f; // width: including borders on both sides
 		float h_x = -m_noteUnit * 2.0f; // height: 0.5 border + 1.0 bar + 0.5 border = 2.0
 		float h_y = h_x * bar_height; //
-		drawNotebar(window, *t1, x, ybeg, yend, w, h_x, h_y);
-		if (alpha > 0.0f) {
-			ColorTrans c(window, Color::alpha(alpha));
-			drawNotebar(window, *t2, x, ybeg, yend, w, h_x, h_y);
-		}
+		addNotebar(*t1, x, ybeg, yend, w, h_x, h_y, glmath::vec4(1.0f));
+		if (alpha > 0.0f) addNotebar(*t2, x, ybeg, yend, w, h_x, h_y, Color::alpha(alpha).linear());
 	}
+	drawNotebars(window, m_notebar, bars);
+	drawNotebars(window, m_notebargold, gold);
+	drawNotebars(window, m_notebar_hl, barsHl);
+	drawNotebars(window, m_notebargold_hl, goldHl);
 }
 
 float NoteGraph::barHeight() {
@@ -208,8 +219,9 @@ float NoteGraph::waveThickness(){
 }
 
 namespace {
-	void strip(glutil::VertexArray& va) {
-		if (va.size() > 3) va.draw();
+	/// Add a finished wave strip to the ones to be drawn, if it is long enough to show
+	void addStrip(glutil::VertexArray& waves, glutil::VertexArray& va) {
+		if (va.size() > 3) waves.strip(va);
 		va.clear();
 	}
 }
@@ -219,57 +231,33 @@ void NoteGraph::drawWaves(Window& window, Database const& database) {
 	UseTexture tblock(window, m_wave);
 	auto sortedPlayers = std::list<std::reference_wrapper<const Player>>(database.cur.begin(), database.cur.end());
 	sortedPlayers.sort([](const Player& playerOne, const Player& playerTwo) {return playerOne.m_score < playerTwo.m_score; });
+	float const texOffset = static_cast<float>(2.0 * m_time); // Offset for animating the wave texture
+	size_t const beginIdx = static_cast<size_t>(std::max(0.0, m_time - 0.5 / pixUnit) / Engine::TIMESTEP); // At which pitch idx to start displaying the wave
+	glutil::VertexArray waves;
 	for (const Player& player: sortedPlayers) {
 		if (player.m_vocal.name != m_vocal.name)
 			continue;
-		float const texOffset = static_cast<float>(2.0 * m_time); // Offset for animating the wave texture
-		Player::pitch_t const& pitch = player.m_pitch;
-		size_t const beginIdx = static_cast<size_t>(std::max(0.0, m_time - 0.5 / pixUnit) / Engine::TIMESTEP); // At which pitch idx to start displaying the wave
-		size_t const endIdx = player.m_pos;
-		size_t idx = beginIdx;
-		// Go back until silence (NaN freq) to allow proper wave phase to be calculated
-		if (beginIdx < endIdx) while (idx > 0 && pitch[idx].first == pitch[idx].first) --idx;
-		// Start processing
-		float tex = texOffset;
-		double t = static_cast<double>(idx) * Engine::TIMESTEP;
-		double oldval = getNaN();
+		// Only the samples that arrived since the last frame are analyzed, the rest is cached
+		PitchWave& wave = m_waves.try_emplace(&player.m_pitch, m_vocal).first->second;
+		wave.update(player.m_pitch.snapshot(), beginIdx);
 		glutil::VertexArray va;
-		auto noteIt = m_vocal.notes.begin();
 		glmath::vec4 c(player.m_color.r, player.m_color.g, player.m_color.b, 1.0f);
-		for (; idx < endIdx; ++idx, t += Engine::TIMESTEP) {
-			double const freq = pitch[idx].first;
-			// If freq is NaN, we have nothing to process
-			if (freq != freq) { oldval = getNaN(); tex = texOffset; continue; }
-			tex += static_cast<float>(freq * 0.001); // Wave phase (texture coordinate)
-			if (idx < beginIdx) continue; // Skip graphics rendering if out of screen
-			float x = static_cast<float>(-0.2f + (t - m_time) * pixUnit);
-			// Find the currently active note(s)
-			while (noteIt != m_vocal.notes.end() && (noteIt->type == Note::Type::SLEEP || t > noteIt->end)) ++noteIt;
-			auto notePrev = noteIt;
-			while (notePrev != m_vocal.notes.begin() && (notePrev->type == Note::Type::SLEEP || t < notePrev->begin)) --notePrev;
-			bool hasNote = (noteIt != m_vocal.notes.end());
-			bool hasPrev = notePrev->type != Note::Type::SLEEP && t >= notePrev->begin;
-			double val;
-			if (hasNote && hasPrev) val = 0.5 * (noteIt->note + notePrev->note);
-			else if (hasNote) val = noteIt->note;
-			else val = notePrev->note;
-			// Now val contains the active note value. The following calculates note value for current freq:
-			val += Note::diff(val, MusicalScale(m_vocal.scale).setFreq(freq).getNote());
+		for (auto const& point: wave.points()) {
+			if (point.begin) addStrip(waves, va);
 			// Graphics positioning & animation:
-			float y = static_cast<float>(m_baseY + val * m_noteUnit);
-			double thickness = clamp(1.0 + pitch[idx].second / 60.0) + 0.5;
-			thickness *= NoteGraph::waveThickness() * (1.0 + 0.2 * std::sin(tex - 2.0 * texOffset)); // Further animation :)
+			float x = static_cast<float>(-0.2f + (point.t - m_time) * pixUnit);
+			float y = static_cast<float>(m_baseY + point.note * m_noteUnit);
+			float tex = texOffset + point.phase;
+			double thickness = point.thickness * NoteGraph::waveThickness() * (1.0 + 0.2 * std::sin(tex - 2.0 * texOffset)); // Further animation :)
 			thickness *= -m_noteUnit;
-			// If there has been a break or if the pitch change is too fast, terminate and begin a new one
-			if (oldval != oldval || std::abs(oldval - val) > 1) strip(va);
 			// Add a point or a pair of points
 			if (!va.size()) va.texCoord(tex, 0.5f).color(c).vertex(x, y);
 			else {
 				va.texCoord(tex, 0.0f).color(c).vertex(x, y - static_cast<float>(thickness));
 				va.texCoord(tex, 1.0f).color(c).vertex(x, y + static_cast<float>(thickness));
 			}
-			oldval = val;
 		}
-		strip(va);
+		addStrip(waves, va);
 	}
+	if (!waves.empty()) waves.draw();
 }
@@ -2,8 +2,13 @@
 
 #include "animvalue.hh"
 #include "texture.hh"
+#include "configvalue.hh"
 #include "notes.hh"
+#include "notewindow.hh"
 #include "dynamicnotegraphscaler.hh"
+#include "pitchwave.hh"
+
+#include <map>
 
 class Song;
 class Database;
@@ -45,8 +50,11 @@ class NoteGraph {
 	float m_notealpha;
 	AnimValue m_nlTop, m_nlBottom;
 	Notes::const_iterator m_songit;
+	NoteWindow<Notes::const_iterator> m_visibleNotes;  ///< Notes on screen
+	std::map<PitchHistory const*, PitchWave> m_waves;  ///< Pitch waves of the players, by their pitch history
 	double m_time;
 	float m_max, m_min, m_noteUnit, m_baseY, m_baseX;
 	const NoteGraphScalerPtr m_scaler;
+	ConfigValue<bool> m_pitch;  ///< Draw pitch waves
 };
 
@@ -1,8 +1,10 @@
 ﻿#include "notes.hh"
 
 #include "configuration.hh"
+#include "configvalue.hh"
 #include "util.hh"
 #include <cmath>
+#include <memory>
 #include <sstream>
 #include <stdexcept>
 
@@ -42,8 +44,21 @@ double Note::scoreMultiplier() const {
 	return 0.0;
 }
 
+namespace {
+	std::unique_ptr<ConfigValue<unsigned short> const> difficulty;
+}
+
+void initGameDifficulty() {
+	difficulty = std::make_unique<ConfigValue<unsigned short> const>("game/difficulty");
+}
+
+GameDifficulty gameDifficulty() {
+	if (!difficulty) throw std::logic_error("gameDifficulty() called before initGameDifficulty()");
+	return GameDifficulty(difficulty->get());
+}
+
 double thresholdForFullScore() {
-	switch(GameDifficulty(config["game/difficulty"].ui())){
+	switch(gameDifficulty()){
 		case GameDifficulty::PERFECT:
 			return 0.2151;
 		case GameDifficulty::HARD:
@@ -55,7 +70,7 @@ double thresholdForFullScore() {
 }
 
 double thresholdForNonzeroScore() {
-	switch(GameDifficulty(config["game/difficulty"].ui())){
+	switch(gameDifficulty()){
 		case GameDifficulty::PERFECT:
 			return 0.5;
 		case GameDifficulty::HARD:
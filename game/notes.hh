@@ -136,6 +136,11 @@ enum class GameDifficulty {
 	PERFECT
 };
 
+/// Look up the game/difficulty config item; call on the main thread after readConfig, before anything scores notes
+void initGameDifficulty();
+/// The selected difficulty (safe from any thread)
+GameDifficulty gameDifficulty();
+
 enum class DanceDifficulty : int {
 	BEGINNER,
 	EASY,
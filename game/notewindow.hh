@@ -0,0 +1,64 @@
+#pragma once
+
+#include <algorithm>
+#include <iterator>
+#include <limits>
+
+/// How NoteWindow reads the time span of a note. The default works for anything with begin and end members
+/// (Note, GuitarChord) sorted by begin; specialize for other types or sort orders.
+template <typename T> struct NoteSpan {
+	static double key(T const& n) { return n.begin; }  ///< The value the container is sorted by
+	static double begin(T const& n) { return n.begin; }
+	static double end(T const& n) { return n.end; }
+};
+
+/**
+ * A cursor over a time-sorted range of notes that keeps track of the notes visible in a moving time window.
+ *
+ * Moving the window forward only advances the iterators past notes that entered or left the window, so a frame
+ * costs O(visible notes) regardless of the chart length. Moving backwards (e.g. practice mode rewinds) seeks with
+ * a binary search. The window may contain a few notes that are not actually visible (when the chart has notes of
+ * different lengths), so callers still check each note against their exact bounds.
+ *
+ * The iterators are invalidated together with those of the container; call reset() after modifying it.
+ */
+template <typename Iterator, typename Span = NoteSpan<typename std::iterator_traits<Iterator>::value_type>>
+class NoteWindow {
+  public:
+	NoteWindow() = default;
+	NoteWindow(Iterator first, Iterator last) { reset(first, last); }
+	/// Index a new range (sorted by Span::key) and empty the window
+	void reset(Iterator first, Iterator last) {
+		m_first = m_begin = m_last = first;
+		m_end = last;
+		m_before = m_after = 0.0;
+		// How far each note may extend around its sort key, so that the window can be found by key alone
+		for (auto it = first; it != last; ++it) {
+			m_before = std::max(m_before, Span::key(*it) - Span::begin(*it));
+			m_after = std::max(m_after, Span::end(*it) - Span::key(*it));
+		}
+		m_from = m_to = -std::numeric_limits<double>::infinity();
+	}
+	/// Move the window to cover the time range [from, to]
+	void update(double from, double to) {
+		double const lo = from - m_after;  // Notes with smaller key end before from
+		double const hi = to + m_before;  // Notes with larger key begin after to
+		if (from < m_from) m_begin = std::partition_point(m_first, m_begin, [lo](auto const& n) { return Span::key(n) < lo; });
+		else while (m_begin != m_end && Span::key(*m_begin) < lo) ++m_begin;
+		if (to < m_to || m_last < m_begin) m_last = std::partition_point(m_begin, m_end, [hi](auto const& n) { return Span::key(n) <= hi; });
+		else while (m_last != m_end && Span::key(*m_last) <= hi) ++m_last;
+		m_from = from;
+		m_to = to;
+	}
+	/// First note of the window
+	Iterator begin() const { return m_begin; }
+	/// One past the last note of the window
+	Iterator end() const { return m_last; }
+	bool empty() const { return m_begin == m_last; }
+
+  private:
+	Iterator m_first{}, m_end{};  ///< The whole indexed range
+	Iterator m_begin{}, m_last{};  ///< The current window
+	double m_before = 0.0, m_after = 0.0;
+	double m_from = 0.0, m_to = 0.0;
+};
@@ -2,6 +2,7 @@
 
 
 #include "fs.hh"
+#include "graphic/glyph_atlas.hh"
 #include "graphic/text_renderer.hh"
 #include "graphic/lyrics_color_trans.hh"
 #include "graphic/video_driver.hh"
@@ -27,7 +28,9 @@ void loadFonts() {
 
 		// FcConfigSetCurrent increments the refcount of config, thus the local handle on config can be deleted safely.
 	FcConfigSetCurrent(config.get());
+}
 
+void selectFontMap() {
 	// This would all be very useless if pango+cairo didn't use the fontconfig+freetype backend:
 
 	PangoCairoFontMap *map = PANGO_CAIRO_FONT_MAP(pango_cairo_font_map_get_default());
@@ -44,18 +47,21 @@ void loadFonts() {
 	}
 }
 
-OpenGLText::OpenGLText(std::string const& text, std::unique_ptr<Texture>& texture, float width, float height)
-: m_text(text), m_texture(std::move(texture)), m_width(width), m_height(height) {
+OpenGLText::OpenGLText(std::string const& text, std::shared_ptr<GlyphRun> glyphs, float width, float height)
+: m_text(text), m_glyphs(std::move(glyphs)), m_dimensions(width / height), m_width(width), m_height(height) {
+	m_dimensions.fixedWidth(1.0f);
 }
 
 OpenGLText::OpenGLText(OpenGLText&& other)
-: m_text(std::move(other.m_text)), m_texture(std::move(other.m_texture)), m_width(other.m_width), m_height(other.m_height) {
+: m_text(std::move(other.m_text)), m_glyphs(std::move(other.m_glyphs)),
+  m_dimensions(other.m_dimensions), m_width(other.m_width), m_height(other.m_height) {
 	other.m_width = other.m_height = 0.f;
 }
 
 OpenGLText& OpenGLText::operator=(OpenGLText&& other) {
 	m_text = std::move(other.m_text);
-	m_texture = std::move(other.m_texture);
+	m_glyphs = std::move(other.m_glyphs);
+	m_dimensions = other.m_dimensions;
 	m_width = other.m_width;
 	m_height = other.m_height;
 
@@ -65,13 +71,12 @@ OpenGLText& OpenGLText::operator=(OpenGLText&& other) {
 }
 
 void OpenGLText::draw(Window& window) {
-	m_texture->draw(window);
+	m_glyphs->draw(window, m_dimensions);
 }
 
-void OpenGLText::draw(Window& window, Dimensions &_dim, TexCoords &_tex) {
-	m_texture->dimensions = _dim;
-	m_texture->tex = _tex;
-	m_texture->draw(window);
+void OpenGLText::draw(Window& window, Dimensions &_dim, TexCoords &) {
+	m_dimensions = _dim;
+	m_glyphs->draw(window, m_dimensions);  // Glyph atlas text is always drawn whole
 }
 
 namespace {
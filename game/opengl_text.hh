@@ -8,8 +8,12 @@
 #include <string>
 #include <vector>
 
-/// Load custom fonts from current theme and data folders
+class GlyphRun;
+
+/// Load custom fonts from current theme and data folders into fontconfig (may be called from any thread)
 void loadFonts();
+/// Make Pango use the FreeType backend; the default font map is per thread, so call this from the rendering thread
+void selectFontMap();
 
 /// zoomed text
 struct TZoomText {
@@ -58,7 +62,8 @@ struct TextStyle {
  */
 class OpenGLText {
 public:
-	OpenGLText(std::string const& text, std::unique_ptr<Texture>&, float width, float height);
+	/// Text drawn from the glyph atlas of the window
+	OpenGLText(std::string const& text, std::shared_ptr<GlyphRun> glyphs, float width, float height);
 	OpenGLText(OpenGLText&&);
 
 	OpenGLText& operator=(OpenGLText&&);
@@ -70,11 +75,12 @@ public:
 	float getWidth() const { return m_width; }
 	float getHeight() const { return m_height; }
 	/// @returns dimension of texture
-	Dimensions& dimensions() { return m_texture->dimensions; }
+	Dimensions& dimensions() { return m_dimensions; }
 
 private:
 	std::string m_text;
-	std::unique_ptr<Texture> m_texture;
+	std::shared_ptr<GlyphRun> m_glyphs;
+	Dimensions m_dimensions;
 	float m_width;
 	float m_height;
 };
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+/**
+ * The pitch that a player sang on each engine time step, appended by the engine thread and read without locks by the
+ * drawing thread. Space for the whole song is allocated up front, so samples never move; each sample is written before
+ * the size is increased (release), and readers only look at the samples below the size they loaded (acquire).
+ */
+class PitchHistory {
+  public:
+	using Sample = std::pair<double, double>;  ///< Frequency (NaN if no tone was found) and level in dB
+
+	/// The samples published when the snapshot was taken. They never change afterwards.
+	class Snapshot {
+	  public:
+		Snapshot() = default;
+		Snapshot(Sample const* data, std::size_t size): m_data(data), m_size(size) {}
+		std::size_t size() const { return m_size; }
+		bool empty() const { return m_size == 0; }
+		Sample const& operator[](std::size_t i) const { return m_data[i]; }
+		Sample const* begin() const { return m_data; }
+		Sample const* end() const { return m_data + m_size; }
+
+	  private:
+		Sample const* m_data = nullptr;
+		std::size_t m_size = 0;
+	};
+
+	explicit PitchHistory(std::size_t capacity = 0): m_samples(capacity) {}
+	/// Copies the published samples (with the same capacity)
+	PitchHistory(PitchHistory const& other): m_samples(other.capacity()) {
+		Snapshot const pitch = other.snapshot();
+		std::copy(pitch.begin(), pitch.end(), m_samples.begin());
+		m_size.store(pitch.size(), std::memory_order_relaxed);
+	}
+	/// Append a sample. Only one thread may do this. Returns false if the history is full.
+	bool push(double freq, double db) {
+		std::size_t const size = m_size.load(std::memory_order_relaxed);
+		if (size == m_samples.size()) return false;
+		m_samples[size] = Sample(freq, db);
+		m_size.store(size + 1, std::memory_order_release);
+		return true;
+	}
+	std::size_t size() const { return m_size.load(std::memory_order_acquire); }
+	std::size_t capacity() const { return m_samples.size(); }
+	bool full() const { return size() == capacity(); }
+	Snapshot snapshot() const { return Snapshot(m_samples.data(), size()); }
+
+  private:
+	std::vector<Sample> m_samples;
+	std::atomic<std::size_t> m_size{ 0 };
+};
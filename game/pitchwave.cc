@@ -0,0 +1,52 @@
+#include "pitchwave.hh"
+
+#include "engine.hh"
+#include "util.hh"
+
+#include <cmath>
+
+PitchWave::PitchWave(VocalTrack const& vocal): m_vocal(vocal), m_scale(vocal.scale) {
+	reset();
+}
+
+void PitchWave::reset() {
+	m_points.clear();
+	m_beginIdx = m_endIdx = 0;
+	m_noteIt = m_vocal.notes.begin();
+	m_phase = 0.0f;
+	m_oldval = getNaN();
+}
+
+void PitchWave::update(PitchHistory::Snapshot const& pitch, std::size_t beginIdx) {
+	// Rewound past the points already dropped, or a history shorter than what was processed (a new one)
+	if (beginIdx < m_beginIdx || pitch.size() < m_endIdx) reset();
+	m_beginIdx = beginIdx;
+	while (!m_points.empty() && m_points.front().idx < beginIdx) m_points.pop_front();
+	if (m_vocal.notes.empty()) return; // Cannot place points without notes
+	for (std::size_t idx = m_endIdx; idx < pitch.size(); ++idx) {
+		double const freq = pitch[idx].first;
+		// If freq is NaN, we have nothing to process
+		if (freq != freq) { m_oldval = getNaN(); m_phase = 0.0f; continue; }
+		m_phase += static_cast<float>(freq * 0.001); // Wave phase (texture coordinate)
+		if (idx < beginIdx) continue; // Out of screen, only the phase is needed
+		double const t = static_cast<double>(idx) * Engine::TIMESTEP;
+		// Find the currently active note(s)
+		while (m_noteIt != m_vocal.notes.end() && (m_noteIt->type == Note::Type::SLEEP || t > m_noteIt->end)) ++m_noteIt;
+		auto notePrev = m_noteIt;
+		while (notePrev != m_vocal.notes.begin() && (notePrev == m_vocal.notes.end() || notePrev->type == Note::Type::SLEEP || t < notePrev->begin)) --notePrev;
+		bool hasNote = (m_noteIt != m_vocal.notes.end());
+		bool hasPrev = notePrev->type != Note::Type::SLEEP && t >= notePrev->begin;
+		double val;
+		if (hasNote && hasPrev) val = 0.5 * (m_noteIt->note + notePrev->note);
+		else if (hasNote) val = m_noteIt->note;
+		else val = notePrev->note;
+		// Now val contains the active note value. The following calculates note value for current freq:
+		val += Note::diff(val, m_scale.setFreq(freq).getNote());
+		double thickness = clamp(1.0 + pitch[idx].second / 60.0) + 0.5;
+		// If there has been a break or if the pitch change is too fast, terminate and begin a new one
+		bool begin = m_oldval != m_oldval || std::abs(m_oldval - val) > 1;
+		m_points.push_back({ idx, t, val, thickness, m_phase, begin });
+		m_oldval = val;
+	}
+	m_endIdx = pitch.size();
+}
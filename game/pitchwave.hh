@@ -0,0 +1,42 @@
+#pragma once
+
+#include "musicalscale.hh"
+#include "notes.hh"
+#include "pitchhistory.hh"
+
+#include <cstddef>
+#include <deque>
+
+/**
+ * The pitch wave of one player in note space, built incrementally from the player's pitch history: each sample is
+ * matched with the notes and converted to a note value once, when it arrives, and points that scrolled out of view are
+ * dropped. Only the view and the animation (scrolling, zoom, wobble) are left to be applied when drawing.
+ */
+class PitchWave {
+  public:
+	struct Point {
+		std::size_t idx;  ///< Index in the pitch history
+		double t;  ///< Time in seconds
+		double note;  ///< Note value of the sung frequency, in the octave of the active note(s)
+		double thickness;  ///< Relative thickness by the sound level
+		float phase;  ///< Wave phase (texture coordinate) since the beginning of the voiced run
+		bool begin;  ///< Begins a new strip, after silence or a pitch change too fast
+	};
+
+	PitchWave(VocalTrack const& vocal);
+	/// Add the samples that have arrived since the last update and drop the points before beginIdx
+	void update(PitchHistory::Snapshot const& pitch, std::size_t beginIdx);
+	/// Forget everything, e.g. for a new pitch history
+	void reset();
+	std::deque<Point> const& points() const { return m_points; }
+
+  private:
+	VocalTrack const& m_vocal;
+	MusicalScale m_scale;
+	std::deque<Point> m_points;
+	std::size_t m_beginIdx;  ///< Samples before this have been dropped
+	std::size_t m_endIdx;  ///< Samples before this have been processed
+	Notes::const_iterator m_noteIt;  ///< The first note that does not end before the last processed sample
+	float m_phase;
+	double m_oldval;
+};
@@ -6,6 +6,7 @@
 #include <fmt/format.h>
 
 #include <cerrno>
+#include <csignal>
 #include <cstdlib>
 #include <cstring>
 #include <exception>
@@ -93,6 +94,11 @@ Platform::Platform() {
 	setenv("PANGO_SYSCONFDIR", pangoSysConfDir.u8string().c_str(), 1);
 	setenv("GDK_PIXBUF_MODULE_FILE", "", 1);
 #endif
+#if !(BOOST_OS_WINDOWS)
+	// Writing to a pipe whose reader has exited (e.g. a crashed ffmpeg recording) must fail with EPIPE rather than
+	// terminate the game. Set here, before any threads are started.
+	std::signal(SIGPIPE, SIG_IGN);
+#endif
 }
 
 Platform::~Platform() {
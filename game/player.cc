@@ -3,11 +3,12 @@
 #include "analyzer.hh"
 #include "engine.hh" // just for Engine::TIMESTEP
 #include "microphones.hh"
-#include "song.hh"
+#include "util.hh"
+
+#include <cmath>
 
 Player::Player(VocalTrack& vocal, Analyzer& analyzer, size_t frames):
-	  m_vocal(vocal), m_analyzer(analyzer), m_pitch(frames, std::make_pair(getNaN(),
-	  -getInf())), m_pos(), m_score(), m_noteScore(), m_lineScore(), m_maxLineScore(),
+	  m_vocal(vocal), m_analyzer(analyzer), m_pitch(frames), m_score(), m_noteScore(), m_lineScore(), m_maxLineScore(),
 	  m_prevLineScore(-1.0), m_feedbackFader(0.0, 2.0), m_activitytimer(),
 	  m_scoreIt(m_vocal.notes.begin())
 {
@@ -22,18 +23,18 @@ void Player::prepare() {
 }
 
 void Player::update() {
-	if (m_pos == m_pitch.size()) return; // End of song already
-	double beginTime = Engine::TIMESTEP * static_cast<double>(m_pos);
+	if (m_pitch.full()) return; // End of song already
+	double beginTime = Engine::TIMESTEP * static_cast<double>(m_pitch.size());
 	// Get the currently sung tone and store it in player's pitch data (also control inactivity timer)
 	Tone const* t = m_analyzer.findTone();
 	if (t) {
 		m_activitytimer = 1000;
-		m_pitch[m_pos++] = std::make_pair(t->freq, t->stabledb);
+		m_pitch.push(t->freq, t->stabledb);
 	} else {
 		if (m_activitytimer > 0) --m_activitytimer;
-		m_pitch[m_pos++] = std::make_pair(getNaN(), -getInf());
+		m_pitch.push(getNaN(), -getInf());
 	}
-	double endTime = Engine::TIMESTEP * static_cast<double>(m_pos);
+	double endTime = Engine::TIMESTEP * static_cast<double>(m_pitch.size());
 	// Iterate over all the notes that are considered for this timestep
 	while (m_scoreIt != m_vocal.notes.end()) {
 		if (endTime < m_scoreIt->begin) break;  // The note begins later than on this timestep
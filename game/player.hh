@@ -3,6 +3,7 @@
 #include "fs.hh"
 #include "notes.hh"
 #include "animvalue.hh"
+#include "pitchhistory.hh"
 
 #include <optional>
 #include <string>
@@ -20,12 +21,8 @@ struct Player {
 	Analyzer& m_analyzer;
 	/// player color for bars, waves, scores
 	Color m_color;
-	/// typedef for pitch
-	typedef std::vector<std::pair<double, double> > pitch_t;
-	/// player's pitch
-	pitch_t m_pitch;
-	/// current position in pitch vector (first unused spot)
-	size_t m_pos;
+	/// player's pitch on each engine time step so far, written by the engine thread
+	PitchHistory m_pitch;
 	/// score for current song
 	double m_score;
 	/// score for current note
@@ -59,6 +59,8 @@ class Profiler {
 		double t = Seconds(m_time - n).count();
 		m_checkpoints[tag].add(t);
 	}
+	/// Record a value measured elsewhere (e.g. a latency in seconds) under the given tag
+	void add(std::string const& tag, double t) { m_checkpoints[tag].add(t); }
 	/// Dump current stats to log and reset
 	void dump() {
 		if (m_checkpoints.empty()) return;
@@ -0,0 +1,131 @@
+#include "recorder.hh"
+
+#include "analyzer.hh"
+#include "chrono.hh"
+#include "log.hh"
+#include "util.hh"
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+
+namespace {
+	void putLE(std::ostream& os, std::uint32_t value, unsigned bytes) {
+		for (unsigned i = 0; i < bytes; ++i) os.put(static_cast<char>((value >> (8 * i)) & 0xFF));
+	}
+
+	/// RIFF header of a mono IEEE float WAV with the start time chunk; written with zero sizes first and again with the
+	/// final sizes when closing
+	void writeWavHeader(std::ostream& os, std::uint32_t rate, double songTime, std::uint32_t frames) {
+		std::uint32_t const dataSize = frames * 4;
+		os.write("RIFF", 4);
+		putLE(os, 4 + (8 + 18) + (8 + 8) + (8 + dataSize), 4);
+		os.write("WAVEfmt ", 8);
+		putLE(os, 18, 4);  // fmt chunk size
+		putLE(os, 3, 2);  // WAVE_FORMAT_IEEE_FLOAT
+		putLE(os, 1, 2);  // Channels
+		putLE(os, rate, 4);
+		putLE(os, rate * 4, 4);  // Bytes per second
+		putLE(os, 4, 2);  // Block align
+		putLE(os, 32, 2);  // Bits per sample
+		putLE(os, 0, 2);  // No extension
+		os.write("pfst", 4);
+		putLE(os, 8, 4);
+		std::uint64_t bits;
+		std::memcpy(&bits, &songTime, sizeof(bits));
+		putLE(os, static_cast<std::uint32_t>(bits), 4);
+		putLE(os, static_cast<std::uint32_t>(bits >> 32), 4);
+		os.write("data", 4);
+		putLE(os, dataSize, 4);
+	}
+}
+
+struct Recorder::Channel {
+	Analyzer& analyzer;
+	fs::path filename;
+	std::ofstream file;
+	std::uint32_t frames = 0;
+	std::size_t overrunsBefore = 0;
+	Channel(Analyzer& analyzer, fs::path const& filename): analyzer(analyzer), filename(filename), file(filename, std::ios::binary) {}
+};
+
+Recorder::Recorder(std::deque<Analyzer>& analyzers, fs::path const& dir, double songTime): m_songTime(songTime) {
+	try {
+		fs::create_directories(dir);
+	} catch (std::exception const& e) {
+		SpdLogger::warn(LogSystem::AUDIO, "Unable to create recordings folder, mics are not recorded, folder={}, error={}", dir, e.what());
+		return;
+	}
+	auto const now = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch());
+	std::string const prefix = timeFormat(now, "%Y%m%d-%H%M%S");
+	for (Analyzer& analyzer: analyzers) {
+		auto channel = std::make_unique<Channel>(analyzer, dir / (prefix + "-" + analyzer.getId() + ".wav"));
+		if (!channel->file) {
+			SpdLogger::warn(LogSystem::AUDIO, "Unable to record mic={}, file={}", analyzer.getId(), channel->filename);
+			continue;
+		}
+		writeWavHeader(channel->file, static_cast<std::uint32_t>(analyzer.getRate()), m_songTime, 0);
+		analyzer.record(true);
+		channel->overrunsBefore = analyzer.recorded()->overruns();
+		m_channels.push_back(std::move(channel));
+	}
+	m_thread = std::thread(&Recorder::run, this);
+}
+
+Recorder::~Recorder() {
+	for (auto& channel: m_channels) channel->analyzer.record(false);
+	m_quit = true;
+	if (m_thread.joinable()) m_thread.join();
+	flush();
+	for (auto& channel: m_channels) {
+		channel->file.seekp(0);
+		writeWavHeader(channel->file, static_cast<std::uint32_t>(channel->analyzer.getRate()), m_songTime, channel->frames);
+		channel->file.close();
+		auto const overruns = channel->analyzer.recorded()->overruns() - channel->overrunsBefore;
+		if (overruns) SpdLogger::warn(LogSystem::AUDIO, "Mic recording overrun, mic={}, dropped samples={}", channel->analyzer.getId(), overruns);
+		SpdLogger::info(LogSystem::AUDIO, "Recorded mic={}, file={}, duration={:.1f}s", channel->analyzer.getId(), channel->filename,
+		  channel->frames / channel->analyzer.getRate());
+	}
+}
+
+double Recorder::startTime(fs::path const& file) {
+	std::ifstream f(file, std::ios::binary);
+	char header[12];
+	if (!f.read(header, sizeof(header)) || std::memcmp(header, "RIFF", 4) != 0 || std::memcmp(header + 8, "WAVE", 4) != 0) return 0.0;
+	// Walk the chunks up to the samples
+	unsigned char chunk[8];
+	while (f.read(reinterpret_cast<char*>(chunk), sizeof(chunk))) {
+		std::uint32_t size = 0;
+		for (unsigned i = 0; i < 4; ++i) size |= static_cast<std::uint32_t>(chunk[4 + i]) << (8 * i);
+		if (std::memcmp(chunk, "data", 4) == 0) break;
+		if (std::memcmp(chunk, "pfst", 4) == 0 && size == 8) {
+			unsigned char value[8];
+			if (!f.read(reinterpret_cast<char*>(value), sizeof(value))) break;
+			std::uint64_t bits = 0;
+			for (unsigned i = 0; i < 8; ++i) bits |= static_cast<std::uint64_t>(value[i]) << (8 * i);
+			double songTime;
+			std::memcpy(&songTime, &bits, sizeof(songTime));
+			return songTime;
+		}
+		f.seekg(size + (size & 1), std::ios::cur);  // Chunks are padded to even sizes
+	}
+	return 0.0;
+}
+
+void Recorder::flush() {
+	std::vector<float> buf(4096);
+	for (auto& channel: m_channels) {
+		while (std::size_t n = channel->analyzer.recorded()->pop(buf.data(), buf.size())) {
+			// WAV is little endian, as are all platforms that we build for
+			channel->file.write(reinterpret_cast<char const*>(buf.data()), static_cast<std::streamsize>(n * sizeof(float)));
+			channel->frames += static_cast<std::uint32_t>(n);
+		}
+	}
+}
+
+void Recorder::run() {
+	while (!m_quit) {
+		flush();
+		std::this_thread::sleep_for(50ms);
+	}
+}
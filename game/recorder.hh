@@ -0,0 +1,40 @@
+#pragma once
+
+#include "fs.hh"
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <vector>
+
+class Analyzer;
+
+/**
+ * Records the input of mics to WAV files (mono 32-bit float, one file per mic) for later analysis, e.g. with --replay.
+ * The audio callback only copies samples to a wait-free queue of each analyzer; a thread of the recorder writes them to
+ * disk. Recording starts on construction and the files are finalized on destruction.
+ *
+ * Recording starts whenever the engine does, not at the beginning of the song, so the song time of the first sample
+ * is stored in an extra "pfst" chunk of the WAV file (a little endian double, ignored by other readers).
+ */
+class Recorder {
+  public:
+	/// Start recording all analyzers into dir; file names consist of the current time and the mic name.
+	/// songTime is the song position of the samples that arrive next. If dir cannot be created, nothing is recorded.
+	Recorder(std::deque<Analyzer>& analyzers, fs::path const& dir, double songTime);
+	~Recorder();
+	Recorder(Recorder const&) = delete;
+	Recorder& operator=(Recorder const&) = delete;
+	/// Song time of the first sample of a recording made by Recorder (zero for other WAV files)
+	static double startTime(fs::path const& file);
+
+  private:
+	struct Channel;
+	void flush();  ///< Write out everything queued so far
+	void run();
+	double m_songTime;
+	std::vector<std::unique_ptr<Channel>> m_channels;
+	std::atomic<bool> m_quit{ false };
+	std::thread m_thread;
+};
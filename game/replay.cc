@@ -0,0 +1,56 @@
+#include "replay.hh"
+
+#include "analyzer.hh"
+#include "engine.hh"
+#include "player.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <stdexcept>
+
+double ReplayResult::songTime() const {
+	return static_cast<double>(steps) * Engine::TIMESTEP;
+}
+
+void alignCapture(std::vector<float>& samples, double songTime, double rate) {
+	auto const shift = static_cast<std::ptrdiff_t>(std::llround(songTime * rate));
+	if (shift < 0) samples.erase(samples.begin(), samples.begin() + std::min(-shift, static_cast<std::ptrdiff_t>(samples.size())));
+	else samples.insert(samples.begin(), static_cast<size_t>(shift), 0.0f);
+}
+
+ReplayResult replay(std::vector<ReplayCapture> const& captures, double rate) {
+	if (rate <= 0.0) throw std::invalid_argument("Replay requires a positive sample rate");
+	ReplayResult result;
+	std::deque<Analyzer> analyzers;  // Players refer to these, so they must not move
+	std::vector<Player> players;
+	for (auto const& capture: captures) {
+		if (!capture.vocal) throw std::invalid_argument("Replay capture " + capture.mic + " has no vocal track");
+		analyzers.emplace_back(rate, capture.mic);
+		players.emplace_back(*capture.vocal, analyzers.back(), static_cast<size_t>(capture.vocal->endTime / Engine::TIMESTEP));
+	}
+	auto const finished = [&] { return std::all_of(players.begin(), players.end(), [](Player const& p) { return p.m_pitch.full(); }); };
+	size_t fed = 0;  // Samples given to the analyzers so far
+	Time const begin = Clock::now();
+	while (!finished()) {
+		++result.steps;
+		// Samples up to the end of this step, like a running game that has recorded past the engine time
+		size_t const end = static_cast<size_t>(std::llround(result.songTime() * rate));
+		for (size_t i = 0; i < captures.size(); ++i) {
+			auto const& samples = captures[i].samples;
+			auto const position = [&](size_t pos) { return samples.begin() + static_cast<std::ptrdiff_t>(std::min(pos, samples.size())); };
+			analyzers[i].input(position(fed), position(end));
+		}
+		fed = end;
+		Time const t0 = Clock::now();
+		for (Player& player: players) player.prepare();
+		Time const t1 = Clock::now();
+		for (Player& player: players) player.update();
+		Time const t2 = Clock::now();
+		result.analyze.add(Seconds(t1 - t0).count());
+		result.score.add(Seconds(t2 - t1).count());
+	}
+	result.elapsed = Seconds(Clock::now() - begin).count();
+	for (Player const& player: players) result.scores.push_back(player.getScore());
+	return result;
+}
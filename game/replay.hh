@@ -0,0 +1,35 @@
+#pragma once
+
+#include "profiler.hh"
+
+#include <string>
+#include <vector>
+
+class VocalTrack;
+
+/// Mic capture of one singer: mono samples, aligned so that sample 0 is at song time 0 (i.e. round-trip latency already removed)
+struct ReplayCapture {
+	std::string mic; ///< Microphone name (color), as for the analyzer of a real mic
+	VocalTrack* vocal; ///< Track being sung
+	std::vector<float> samples;
+};
+
+/// Make sample 0 of a capture whose first sample was at songTime (seconds) be at song time 0, by dropping or padding
+void alignCapture(std::vector<float>& samples, double songTime, double rate);
+
+/// Final result and per-stage timing of a replay
+struct ReplayResult {
+	std::vector<unsigned> scores; ///< Final score of each capture, as shown at the end of the song (0..10000)
+	ProfCP analyze; ///< Analyzer::process of all players, per engine step
+	ProfCP score; ///< Player::update of all players, per engine step
+	unsigned long steps = 0; ///< Engine steps run
+	double elapsed = 0.0; ///< Wall clock seconds for the whole replay
+	double songTime() const;
+};
+
+/**
+ * Runs recorded mic captures through Analyzer and Player exactly as Engine does during a song, but without audio
+ * devices and as fast as the CPU allows. Each engine step first gives the analyzers the samples of that step, so the
+ * results only depend on the input: the same captures always produce the same scores.
+ */
+ReplayResult replay(std::vector<ReplayCapture> const& captures, double rate);
@@ -153,7 +153,7 @@ void ScreenIntro::draw() {
 		theme->short_comment_bg.dimensions.left(-0.54f).screenBottom(-0.054f);
 		theme->short_comment_bg.draw(window);
 		theme->short_comment.dimensions.left(-0.48f).screenBottom(-0.067f);
-		theme->short_comment.draw(window, _("Ctrl + S to save, Ctrl + R to reset defaults"));
+		theme->short_comment.draw(window, _c("Ctrl + S to save, Ctrl + R to reset defaults"));
 	}
 	// Menu
 	draw_menu_options();
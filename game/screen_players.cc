@@ -19,7 +19,7 @@
 #include <iostream>
 
 ScreenPlayers::ScreenPlayers(Game &game, std::string const& name, Audio& audio, Database& database):
-  Screen(game, name), m_audio(audio), m_database(database), m_players(database.m_players)
+  Screen(game, name), m_audio(audio), m_database(database), m_players(database.m_players), m_covers(name)
 {
 	m_players.setAnimMargins(5.0, 5.0);
 	m_playTimer.setTarget(getInf()); // Using this as a simple timer counting seconds
@@ -106,13 +106,7 @@ void ScreenPlayers::manageEvent(SDL_Event event) {
 }
 
 Texture* ScreenPlayers::loadTextureFromMap(fs::path path) {
-	if(m_covers.find(path) == m_covers.end()) {
-		m_covers.insert({ path, std::make_unique<Texture>(path) });
-	}
-	try {
-		return m_covers.at(path).get();
-	} catch (std::exception const&) {}
-	return nullptr;
+	return m_covers.get(path);
 }
 
 void ScreenPlayers::draw() {
@@ -130,26 +124,26 @@ void ScreenPlayers::draw() {
 	if (m_players.isEmpty()) {
 		// Format the song information text
 		if (m_search.text.empty()) {
-			oss_song = _("No Players found!");
-			oss_order = _("Enter a name to create a new player.");
+			oss_song = _c("No Players found!");
+			oss_order = _c("Enter a name to create a new player.");
 		} else {
-			oss_song = _("Press enter to create player!");
+			oss_song = _c("Press enter to create player!");
 			oss_order = fmt::format("{}\n", m_search.text);
 		}
 	} else if (m_database.scores.empty()) {
-		oss_song = _("No players worth mentioning!");
+		oss_song = _c("No players worth mentioning!");
 	} else {
 		// Format the player information text
 
-		oss_song =  fmt::format("{}\n{}", m_database.scores.front().track, fmt::format(_("You reached {0} points!"), m_database.scores.front().score));
-		oss_order = fmt::format("{}\n{} {}\n", _("Change player with arrow keys."), _("Name:"), m_players.current().name);
+		oss_song =  fmt::format("{}\n{}", m_database.scores.front().track, fmt::format(_c("You reached {0} points!"), m_database.scores.front().score));
+		oss_order = fmt::format("{}\n{} {}\n", _c("Change player with arrow keys."), _c("Name:"), m_players.current().name);
 		//m_database.queryPerPlayerHiscore(oss_order);
 		oss_order.append("\n");
 		if (m_search.text.empty()) {
-			oss_order.append(_("Type text to filter or create a new player."));
+			oss_order.append(_c("Type text to filter or create a new player."));
 		}
 		else {
-			oss_order.append(fmt::format("{} {}\n", _("Search Text:"), m_search.text));
+			oss_order.append(fmt::format("{} {}\n", _c("Search Text:"), m_search.text));
 		}
 		double spos = m_players.currentPosition(); // This needs to be polled to run the animation
 
@@ -174,7 +168,8 @@ void ScreenPlayers::draw() {
 			if (m_players.count() < 3)
 				reposition += 3 - m_players.count();
 
-			Texture& s = !player_display.path.empty() ? *loadTextureFromMap(player_display.path) : *m_emptyCover;
+			Texture* avatar = !player_display.path.empty() ? loadTextureFromMap(player_display.path) : nullptr;
+			Texture& s = avatar ? *avatar : *m_emptyCover;  // Also while the avatar is loading
 			float diff = (reposition == 0 ? static_cast<float>((0.5 - fabs(shift)) * 0.07) : 0.0f);
 			float y = 0.27f + 0.5f * diff;
 			// Draw the avatar
@@ -196,6 +191,8 @@ void ScreenPlayers::draw() {
 		*/
 	}
 
+	m_covers.frame();
+
 	// Draw song and order texts
 	theme->song.draw(window, oss_song);
 	theme->order.draw(window, oss_order);
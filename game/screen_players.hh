@@ -4,7 +4,7 @@
 #include "theme.hh"
 #include "textinput.hh"
 #include "layout_singer.hh"
-#include <unordered_map>
+#include "texture_cache.hh"
 
 class Song;
 class Audio;
@@ -49,7 +49,7 @@ class ScreenPlayers : public Screen {
 	AnimValue m_quitTimer;
 	TextInput m_search;
 	std::unique_ptr<Texture> m_emptyCover;
-	std::unordered_map<fs::path, std::unique_ptr<Texture>, FsPathHash> m_covers;
+	TextureCache m_covers;
 	std::unique_ptr<LayoutSinger> m_layout_singer;
 	bool keyPressed = false;
 };
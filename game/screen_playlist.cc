@@ -9,7 +9,7 @@
 #include <fmt/chrono.h>
 
 ScreenPlaylist::ScreenPlaylist(Game &game, std::string const& name,Audio& audio, Songs& songs, Backgrounds& bgs):
-	Screen(game, name), m_audio(audio), m_songs(songs), m_backgrounds(bgs), keyPressed()
+	Screen(game, name), m_audio(audio), m_songs(songs), m_backgrounds(bgs), m_covers(name), keyPressed()
 {}
 
 void ScreenPlaylist::enter() {
@@ -62,6 +62,7 @@ void ScreenPlaylist::exit() {
 	m_audio.togglePause();
 	m_background.reset();
 	m_cam.reset();
+	m_covers.clear();
 }
 
 
@@ -142,25 +143,20 @@ void ScreenPlaylist::draw() {
 			s.draw(window);
 		}
 	}
+	m_covers.frame();
 }
 
 Texture* ScreenPlaylist::loadTextureFromMap(fs::path path) {
-	if(m_covers.find(path) == m_covers.end()) {
-		m_covers.insert({ path, std::make_unique<Texture>(path) });
-	}
-	try {
-		return m_covers.at(path).get();
-	} catch (std::exception const&) {}
-	return nullptr;
+	return m_covers.get(path);
 }
 
 Texture& ScreenPlaylist::getCover(Song const& song) {
 	Texture* cover = nullptr;
 	// Fetch cover image from cache or try loading it
 	if (!song.cover.empty()) cover = loadTextureFromMap(song.cover);
-	// Fallback to background image as cover if needed
-	if (!cover && !song.background.empty()) cover = loadTextureFromMap(song.background);
-	// Use empty cover
+	// Fallback to background image as cover if there is no cover or it failed to load (but not while it is loading)
+	if (!cover && !song.background.empty() && (song.cover.empty() || m_covers.failed(song.cover))) cover = loadTextureFromMap(song.background);
+	// Use empty cover (also while the real one is still loading)
 	if (!cover) {
 		if(song.hasDance()) {
 			cover = m_danceCover.get();
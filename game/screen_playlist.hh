@@ -9,6 +9,7 @@
 #include "controllers.hh"
 #include "songs.hh"
 #include "texture.hh"
+#include "texture_cache.hh"
 #include "webcam.hh"
 #include "theme.hh"
 #include "configuration.hh"
@@ -51,7 +52,7 @@ private:
 	void createMenuFromPlaylist();
 	Texture* loadTextureFromMap(fs::path path);
 	Backgrounds& m_backgrounds;
-	std::unordered_map<fs::path, std::unique_ptr<Texture>, FsPathHash> m_covers;
+	TextureCache m_covers;
 	std::unique_ptr<ThemeInstrumentMenu> m_menuTheme;
 	std::unique_ptr<ThemePlaylistScreen> theme;
 	std::unique_ptr<Texture> m_background;
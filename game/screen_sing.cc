@@ -609,17 +609,17 @@ void ScreenSing::draw() {
 
 		if (!m_score_window.get() && m_instruments.empty() && !m_layout_singer.empty()) {
 			if (status == Song::Status::INSTRUMENTAL_BREAK) {
-				statustxt += _("   ENTER to skip instrumental break");
+				statustxt += _c("   ENTER to skip instrumental break");
 			}
 			if (status == Song::Status::FINISHED && !config["game/karaoke_mode"].ui()) {
 				if(config["game/autoplay"].b()) {
 					if(m_displayAutoPlay) {
-						statustxt += _("   Autoplay enabled");
+						statustxt += _c("   Autoplay enabled");
 					} else {
 						if(!m_audio.analyzers().empty()) {
-							statustxt += _("   Remember to wait for grading!");
+							statustxt += _c("   Remember to wait for grading!");
 						} else {
-							statustxt += _("   Prepare for the next song!");
+							statustxt += _c("   Prepare for the next song!");
 						}
 					}
 
@@ -629,13 +629,13 @@ void ScreenSing::draw() {
 					}
 				} else {
 					if(!m_audio.analyzers().empty()) {
-						statustxt += _("   Remember to wait for grading!");
+						statustxt += _c("   Remember to wait for grading!");
 					} else {
-						statustxt += _("   Choose your next song!");
+						statustxt += _c("   Choose your next song!");
 					}
 				}
 			} else if(status == Song::Status::FINISHED && config["game/autoplay"].b()) {
-				statustxt += _("   Autoplay enabled");
+				statustxt += _c("   Autoplay enabled");
 			}
 		}
 
@@ -24,7 +24,7 @@
 static const double IDLE_TIMEOUT = 35.0; // seconds
 
 ScreenSongs::ScreenSongs(Game &game, std::string const& name, Audio& audio, Songs& songs, Database& database):
-  Screen(game, name), m_audio(audio), m_songs(songs), m_database(database)
+  Screen(game, name), m_audio(audio), m_songs(songs), m_database(database), m_covers(name)
 {
 	m_songs.setAnimMargins(5.0, 5.0);
 	// Using AnimValues as a simple timers counting seconds
@@ -39,6 +39,7 @@ void ScreenSongs::enter() {
 	m_menuPos = 1;
 	m_infoPos = 0;
 	m_jukebox = false;
+	m_hiscoreSong.reset();
 	reloadGL();
 }
 
@@ -297,26 +298,31 @@ void ScreenSongs::draw() {
 	update();
 	drawMultimedia();
 
-	auto hiscore = std::string{};
 	std::string songText, orderText;
 	// Test if there are no songs
 	if (m_songs.empty()) {
+		m_hiscoreSong.reset();
+		m_hiscoreText.clear();
 		// Format the song information text
 		if (!m_search.text.empty()) {
-			songText = _("Sorry, no songs match the search!");
+			songText = _c("Sorry, no songs match the search!");
 			orderText = m_search.text;
 		} else if (m_songs.typeNum()) {
-			songText = _("Sorry, no songs match the filter!");
+			songText = _c("Sorry, no songs match the filter!");
 			orderText = m_songs.typeDesc();
 		} else {
-			songText = _("No songs found!");
-			orderText = _("Visit performous.org for free songs");
+			songText = _c("No songs found!");
+			orderText = _c("Visit performous.org for free songs");
 		}
 	} else {
 		Song& song = m_songs.current();
 		// Format the song information text
 		songText = fmt::format("{}: {}", song.artist, song.title);
-		hiscore = getHighScoreText();
+		// The hiscores only change while singing, so the text is rebuilt when another song is selected (or on enter)
+		if (auto current = m_songs.currentPtr(); current != m_hiscoreSong) {
+			m_hiscoreText = getHighScoreText();
+			m_hiscoreSong = std::move(current);
+		}
 		// Escaped bytes of UTF-8 must be used here for compatibility with Windows (MSVC, mingw)
 		char const* VERT_ARROW = "\xe2\x86\x95";  // ↕
 		char const* HORIZ_ARROW = "\xe2\x86\x94";  // ↔
@@ -326,14 +332,14 @@ void ScreenSongs::draw() {
 			if (!m_search.text.empty()) orderText.append(m_search.text);
 			else if (m_songs.typeNum()) orderText.append(m_songs.typeDesc());
 			else if (m_songs.sortNum()) orderText.append(m_songs.getSortDescription());
-			else fmt::format_to(std::back_inserter(orderText), "{}   {} {}    {} {}", _("<type in to search>"), HORIZ_ARROW, _("songs"), VERT_ARROW, _("options"));
+			else fmt::format_to(std::back_inserter(orderText), "{}   {} {}    {} {}", _c("<type in to search>"), HORIZ_ARROW, _c("songs"), VERT_ARROW, _c("options"));
 			break;
-		case 2: fmt::format_to(std::back_inserter(orderText), "{} {} {}", HORIZ_ARROW, _("sort order: "), m_songs.getSortDescription()); break;
-		case 3: fmt::format_to(std::back_inserter(orderText), "{} {} {}", HORIZ_ARROW, _("type filter: "), m_songs.typeDesc()); break;
-		case 4: fmt::format_to(std::back_inserter(orderText), "{} {}   {} {}", HORIZ_ARROW, _("hiscores"), ENTER, _("jukebox mode")); break;
+		case 2: fmt::format_to(std::back_inserter(orderText), "{} {} {}", HORIZ_ARROW, _c("sort order: "), m_songs.getSortDescription()); break;
+		case 3: fmt::format_to(std::back_inserter(orderText), "{} {} {}", HORIZ_ARROW, _c("type filter: "), m_songs.typeDesc()); break;
+		case 4: fmt::format_to(std::back_inserter(orderText), "{} {}   {} {}", HORIZ_ARROW, _c("hiscores"), ENTER, _c("jukebox mode")); break;
 		case 0:
 			bool empty = getGame().getCurrentPlayList().isEmpty(); 
-			orderText = fmt::format(fmt::runtime("{} {}"), ENTER, empty ? _("start a playlist with this song!") : _("open the playlist menu"));
+			orderText = fmt::format(fmt::runtime("{} {}"), ENTER, empty ? _c("start a playlist with this song!") : _c("open the playlist menu"));
 			break;
 		}
 	}
@@ -345,10 +351,11 @@ void ScreenSongs::draw() {
 		theme->song.draw(window, songText);
 		theme->order.draw(window, orderText);
 		drawInstruments(Dimensions(1.0f).fixedHeight(0.09f).right(0.45f).screenTop(0.02f));
-		theme->hiscores.draw(window, hiscore);
+		theme->hiscores.draw(window, m_hiscoreText);
 	}
 	// Menus on top of everything
 	if (m_menu.isOpen()) drawMenu();
+	m_covers.frame();
 }
 
 std::string ScreenSongs::getHighScoreText() const {
@@ -470,22 +477,16 @@ void ScreenSongs::drawCovers() {
 }
 
 Texture* ScreenSongs::loadTextureFromMap(fs::path path) {
-	if(m_covers.find(path) == m_covers.end()) {
-		m_covers.insert({ path, std::make_unique<Texture>(path) });
-	}
-	try {
-		return m_covers.at(path).get();
-	} catch (std::exception const&) {}
-	return nullptr;
+	return m_covers.get(path);
 }
 
 Texture& ScreenSongs::getCover(Song const& song) {
 	Texture* cover = nullptr;
 	// Fetch cover image from cache or try loading it
 	if (!song.cover.empty()) cover = loadTextureFromMap(song.cover);
-	// Fallback to background image as cover if needed
-	if (!cover && !song.background.empty()) cover = loadTextureFromMap(song.background);
-	// Use empty cover
+	// Fallback to background image as cover if there is no cover or it failed to load (but not while it is loading)
+	if (!cover && !song.background.empty() && (song.cover.empty() || m_covers.failed(song.cover))) cover = loadTextureFromMap(song.background);
+	// Use empty cover (also while the real one is still loading)
 	if (!cover) {
 		if(song.hasDance()) {
 			cover = m_danceCover.get();
@@ -7,6 +7,7 @@
 #include "song.hh" // for MusicFiles class
 #include "songs.hh"
 #include "textinput.hh"
+#include "texture_cache.hh"
 #include "video.hh"
 #include "playlist.hh"
 #include "menu.hh"
@@ -68,9 +69,11 @@ private:
 	std::unique_ptr<Texture> m_danceCover;
 	std::unique_ptr<Texture> m_instrumentList;
 	std::unique_ptr<ThemeInstrumentMenu> m_menuTheme;
-	std::unordered_map<fs::path, std::unique_ptr<Texture>, FsPathHash> m_covers;
+	TextureCache m_covers;
 	unsigned m_menuPos;
 	int m_infoPos;
 	bool m_jukebox;
 	Menu m_menu;
+	std::shared_ptr<Song> m_hiscoreSong;  ///< The song that m_hiscoreText was made for
+	std::string m_hiscoreText;
 };
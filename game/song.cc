@@ -1,5 +1,6 @@
 #include "song.hh"
 
+#include "cache.hh"
 #include "config.hh"
 #include "ffmpeg.hh"
 #include "log.hh"
@@ -112,8 +113,10 @@ void Song::reload(bool errorIgnore) {
 
 void Song::loadNotes(bool errorIgnore) {
 	if (loadStatus == LoadStatus::FULL) return;
+	if (cache::loadNotes(*this)) return;
 	try { SongParser(*this); }
 	catch (SongParserException const&) { if (!errorIgnore) throw; }
+	if (loadStatus == LoadStatus::FULL) cache::saveNotes(*this);
 }
 
 void Song::dropNotes() {
@@ -133,6 +136,14 @@ void Song::collateUpdate() {
 
 	collateByArtist = collateInfo["artist"] + "__" + collateInfo["title"] + "__" + filename.string();
 	collateByArtistOnly = collateInfo["artist"];
+	sortKeyGeneration = 0;  // Sort keys are computed when next sorting
+}
+
+void Song::updateSortKeys() {
+	if (sortKeyGeneration == UnicodeUtil::sortGeneration()) return;
+	sortKeyByTitle = UnicodeUtil::sortKey(collateByTitle);
+	sortKeyByArtist = UnicodeUtil::sortKey(collateByArtist);
+	sortKeyGeneration = UnicodeUtil::sortGeneration();
 }
 
 Song::Status Song::status(double time, ScreenSing* song) {
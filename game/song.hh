@@ -81,6 +81,9 @@ public:
 	std::string collateByTitleOnly;  ///< String for sorting by title only
 	std::string collateByArtist;  ///< String for sorting by artist, title
 	std::string collateByArtistOnly;  ///< String for sorting by artist only
+	std::string sortKeyByTitle;  ///< Collation key of collateByTitle (compares bytewise), see updateSortKeys
+	std::string sortKeyByArtist;  ///< Collation key of collateByArtist (compares bytewise), see updateSortKeys
+	unsigned sortKeyGeneration = 0;  ///< UnicodeUtil::sortGeneration() that the sort keys were made for
 	double videoGap = 0.0; ///< gap with video
 	double start = 0.0; ///< start of song
 	double end = 0.0; ///< end of song
@@ -129,6 +132,9 @@ public:
 	bool getPrevSection(double pos, SongSection &section);
 	double getPreviewStart();
 
+	/// Recompute the sort keys if the collator or case sorting changed since (main thread, as the collator may change)
+	void updateSortKeys();
+
 	bool isBroken() const;
 	void setBroken(bool broken = true);
 
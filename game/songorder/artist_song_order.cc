@@ -4,14 +4,15 @@
 #include "unicode.hh"
 
 std::string ArtistSongOrder::getDescription() const {
-	return _("sorted by artist");
+	return _c("sorted by artist");
 }
 
-void ArtistSongOrder::prepare(SongCollection const&, Database const&) {
-	UnicodeUtil::m_sortCollator->setStrength(config["game/case-sorting"].b() ? icu::Collator::TERTIARY : icu::Collator::SECONDARY);
+void ArtistSongOrder::prepare(SongCollection const& songs, Database const&) {
+	UnicodeUtil::setCaseSorting(config["game/case-sorting"].b());
+	for (auto const& song: songs) song->updateSortKeys();
 }
 
 bool ArtistSongOrder::operator()(Song const& a, Song const& b) const {
-	return a.collateByArtist < b.collateByArtist;
+	return a.sortKeyByArtist < b.sortKeyByArtist;
 }
 
@@ -4,11 +4,11 @@
 #include "unicode.hh"
 
 std::string CreatorSongOrder::getDescription() const {
-	return _("sorted by creator");
+	return _c("sorted by creator");
 }
 
 void CreatorSongOrder::prepare(SongCollection const&, Database const&) {
-	UnicodeUtil::m_sortCollator->setStrength(config["game/case-sorting"].b() ? icu::Collator::TERTIARY : icu::Collator::SECONDARY);
+	UnicodeUtil::setCaseSorting(config["game/case-sorting"].b());
 }
 
 bool CreatorSongOrder::operator()(Song const& a, Song const& b) const {
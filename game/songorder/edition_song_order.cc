@@ -4,11 +4,11 @@
 #include "unicode.hh"
 
 std::string EditionSongOrder::getDescription() const {
-	return _("sorted by edition");
+	return _c("sorted by edition");
 }
 
 void EditionSongOrder::prepare(SongCollection const&, Database const&) {
-	UnicodeUtil::m_sortCollator->setStrength(config["game/case-sorting"].b() ? icu::Collator::TERTIARY : icu::Collator::SECONDARY);
+	UnicodeUtil::setCaseSorting(config["game/case-sorting"].b());
 }
 
 bool EditionSongOrder::operator()(Song const& a, Song const& b) const {
@@ -14,7 +14,7 @@ namespace {
 }
 
 std::string FileTimeSongOrder::getDescription() const {
-	return _("sort by file time");
+	return _c("sort by file time");
 }
 
 void FileTimeSongOrder::prepare(SongCollection const& songs, Database const&) {
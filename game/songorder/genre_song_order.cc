@@ -4,11 +4,11 @@
 #include "unicode.hh"
 
 std::string GenreSongOrder::getDescription() const {
-	return _("sorted by genre");
+	return _c("sorted by genre");
 }
 
 void GenreSongOrder::prepare(SongCollection const&, Database const&) {
-	UnicodeUtil::m_sortCollator->setStrength(config["game/case-sorting"].b() ? icu::Collator::TERTIARY : icu::Collator::SECONDARY);
+	UnicodeUtil::setCaseSorting(config["game/case-sorting"].b());
 }
 
 bool GenreSongOrder::operator()(Song const& a, Song const& b) const {
@@ -4,11 +4,11 @@
 #include "unicode.hh"
 
 std::string LanguageSongOrder::getDescription() const {
-	return _("sorted by language");
+	return _c("sorted by language");
 }
 
 void LanguageSongOrder::prepare(SongCollection const&, Database const&) {
-	UnicodeUtil::m_sortCollator->setStrength(config["game/case-sorting"].b() ? icu::Collator::TERTIARY : icu::Collator::SECONDARY);
+	UnicodeUtil::setCaseSorting(config["game/case-sorting"].b());
 }
 
 bool LanguageSongOrder::operator()(Song const& a, Song const& b) const {
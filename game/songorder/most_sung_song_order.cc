@@ -3,7 +3,7 @@
 #include "database.hh"
 
 std::string MostSungSongOrder::getDescription() const {
-	return _("sort by most sung");
+	return _c("sort by most sung");
 }
 
 void MostSungSongOrder::prepare(SongCollection const& songs, Database const& database) {
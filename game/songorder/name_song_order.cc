@@ -4,13 +4,14 @@
 #include "unicode.hh"
 
 std::string NameSongOrder::getDescription() const {
-	return _("sorted by song");
+	return _c("sorted by song");
 }
 
-void NameSongOrder::prepare(SongCollection const&, Database const&) {
-	UnicodeUtil::m_sortCollator->setStrength(config["game/case-sorting"].b() ? icu::Collator::TERTIARY : icu::Collator::SECONDARY);
+void NameSongOrder::prepare(SongCollection const& songs, Database const&) {
+	UnicodeUtil::setCaseSorting(config["game/case-sorting"].b());
+	for (auto const& song: songs) song->updateSortKeys();
 }
 
 bool NameSongOrder::operator()(Song const& a, Song const& b) const {
-	return a.collateByTitle < b.collateByTitle;
+	return a.sortKeyByTitle < b.sortKeyByTitle;
 }
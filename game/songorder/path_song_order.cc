@@ -1,7 +1,7 @@
 #include "path_song_order.hh"
 
 std::string PathSongOrder::getDescription() const {
-	return _("sorted by path");
+	return _c("sorted by path");
 }
 
 bool PathSongOrder::operator()(Song const& a, Song const& b) const {
@@ -1,7 +1,7 @@
 #include "random_song_order.hh"
 
 std::string RandomSongOrder::getDescription() const {
-	return _("random order");
+	return _c("random order");
 }
 
 bool RandomSongOrder::operator()(Song const& a, Song const& b) const {
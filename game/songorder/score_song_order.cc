@@ -3,7 +3,7 @@
 #include "database.hh"
 
 std::string ScoreSongOrder::getDescription() const {
-	return _("sorted by score");
+	return _c("sorted by score");
 }
 
 void ScoreSongOrder::prepare(SongCollection const& songs, Database const& database) {
@@ -15,7 +15,7 @@ using namespace SongParserUtil;
 
 /// 'Magick' to check if this file looks like correct format
 bool SongParser::iniCheck(std::string const& data) const {
-	return std::regex_search(data.substr(0,1024), iniCheckHeader);
+	return tokenizer::iniSongSection(std::string_view(data).substr(0, 1024));
 }
 
 /// Parse header data for Songs screen
@@ -23,22 +23,19 @@ void SongParser::iniParseHeader() {
 	Song& s = m_song;
 	if (!m_song.vocalTracks.empty()) { m_song.vocalTracks.clear(); }
 	if (!m_song.instrumentTracks.empty()) { m_song.instrumentTracks.clear(); }
-	std::string line;
-	
+	std::string_view line;
 	while (getline(line)) {
+		line = tokenizer::trim(line);
 		if (line.empty()) continue;
-		if (trim(line)[0] == '[') { // Section header.
-			if (line.find("[song]") != std::string::npos) continue;
+		if (line[0] == '[') { // Section header.
+			if (line.find("[song]") != std::string_view::npos) continue;
 			break; // Keys should be under the correct section.
 		}
-		if ((line[0] == ';' || line[0] == '#') && line[1] == ' ') continue; // Comment. 
-		std::string key;
-		std::string value;
-		std::smatch match;
-		if (std::regex_search(line, match, iniParseLine)) {
-			key = UnicodeUtil::toLower(match[1].str());
-			value = match[2].str();
-		}
+		if ((line[0] == ';' || line[0] == '#') && line.size() > 1 && line[1] == ' ') continue; // Comment.
+		std::string_view keyView, valueView;
+		if (!tokenizer::iniKeyValue(line, keyView, valueView)) continue;
+		std::string const key = tokenizer::toLowerASCII(keyView);  // Keys are plain ASCII
+		std::string value(valueView);
 		// Strip rich-text tags.
 		if (value.find("<") != std::string::npos) {
 			// Step 1: Replace <br> with \n
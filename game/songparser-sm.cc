@@ -29,16 +29,15 @@ reaches value #NOTES.
 - smParseNotes reads the notes into vector called notes which is a vector of structs (Note);
 */
 
-/// Parse header data for Songs screen
-// TODO: This actually parses the whole thing
-// TODO: Songparser drops parsed notes, remove it when smParseHeader is more intelligent
+/// Parse header data for Songs screen (when reloading, smParse calls this to parse everything)
+/// Before the song has been loaded, only the header fields and the names of the note tracks are read.
 void SongParser::smParseHeader() {
 	Song& s = m_song;
-	std::string line;
+	std::string_view line;
 	if (!m_song.danceTracks.empty()) { m_song.danceTracks.clear(); }
-	// Parse the the entire file
 	while (getline(line) && smParseField(line)) {}
 	if (m_song.danceTracks.empty() ) throw std::runtime_error("No note data in the file");
+	if (s.m_bpms.empty()) throw std::runtime_error("BPM data missing");
 	if (s.title.empty() || s.artist.empty()) throw std::runtime_error("Required header fields missing");
 	// Convert stops to the format required in Song
 	s.stops.resize(m_stops.size());
@@ -53,35 +52,33 @@ void SongParser::smParse() {
 	smParseHeader();
 }
 
-bool SongParser::smParseField(std::string line) {
-	trim(line);
+bool SongParser::smParseField(std::string_view line) {
+	line = tokenizer::trim(line);
 	if (line.empty()) return true;
-	if (line.substr(0, 2) == "//") return true; //jump over possible comments
+	if (tokenizer::startsWith(line, "//")) return true; //jump over possible comments
 	if (line[0] == ';') return true; // HACK: Skip ; left over from previous field
 
 	//Here the data contained by the current line is separated in key and value.
 	//However, because of the differing format of notedata the value is analyzed only if key is not NOTES
-	std::string::size_type pos = line.find(':');
-	if (pos == std::string::npos) throw std::runtime_error("Invalid sm format, should be #key:value");
-	std::string key = trim(line.substr(1, pos - 1));
+	std::string_view key, firstValue;
+	if (!tokenizer::keyValue(line, key, firstValue)) throw std::runtime_error("Invalid sm format, should be #key:value");
 	if (key == "NOTES") {
 		/*All remaining data is parsed here.
 			All five lines of note metadata is read first and then smParseNotes is called to read
 			the actual note data.
 			All data is read into m_song.danceTracks map container.
 		*/
+		auto field = [](std::string_view str) { return tokenizer::trim(str.substr(0, str.find(':'))); };
 
 		while (getline(line)) {
 			//<NotesType>:
-			std::string notestype = trim(line.substr(0, line.find_first_of(':')));
-			notestype = UnicodeUtil::toLower(notestype);
+			std::string notestype = toLowerKey(field(line));
 			//<Description>:
 			if(!getline(line)) { throw std::runtime_error("Required note data missing"); }
-			std::string description = trim(line.substr(0, line.find_first_of(':')));
+			std::string description(field(line));
 			//<DifficultyClass>:
 			if(!getline(line)) { throw std::runtime_error("Required note data missing"); }
-			std::string difficultyclass = trim(line.substr(0, line.find_first_of(':')));
-			difficultyclass = UnicodeUtil::toUpper(difficultyclass);
+			std::string difficultyclass = toUpperKey(field(line));
 			DanceDifficulty danceDifficulty = DanceDifficulty::COUNT;
 			if(difficultyclass == "BEGINNER") danceDifficulty = DanceDifficulty::BEGINNER;
 			if(difficultyclass == "EASY") danceDifficulty = DanceDifficulty::EASY;
@@ -94,14 +91,22 @@ bool SongParser::smParseField(std::string line) {
 			if(!getline(line)) { throw std::runtime_error("Required note data missing"); }
 			if(!getline(line)) { throw std::runtime_error("Required note data missing"); }
 
+			// TODO: support other track types. For now all others are simply ignored.
+			bool const supported = notestype == "dance-single" || notestype == "dance-double" || notestype == "dance-solo"
+			  || notestype == "pump-single" || notestype == "ez2-single" || notestype == "ez2-real"
+			  || notestype == "para-single";
+			// The songs screen only needs to know which track types there are; notes are parsed when the song is played
+			if (m_song.loadStatus < Song::LoadStatus::HEADER) {
+				smSkipNotes();
+				if (supported) m_song.danceTracks[notestype];
+				continue;
+			}
+
 			//<NoteData>:
-			Notes notes = smParseNotes(line);
+			Notes notes = smParseNotes();
 
 			//Here all note data from the current track is inserted into containers
-			// TODO: support other track types. For now all others are simply ignored.
-			if (notestype == "dance-single" || notestype == "dance-double" || notestype == "dance-solo"
-			  || notestype == "pump-single" || notestype == "ez2-single" || notestype == "ez2-real"
-			  || notestype == "para-single") {
+			if (supported) {
 				DanceTrack danceTrack(description, notes);
 				if (m_song.danceTracks.find(notestype) == m_song.danceTracks.end() ) {
 					DanceDifficultyMap danceDifficultyMap;
@@ -112,35 +117,35 @@ bool SongParser::smParseField(std::string line) {
 		}
 		return false;
 	}
-	std::string value = trim(line.substr(pos + 1));
+	std::string value(firstValue);
 	//In case the value continues to several lines, all text before the ending character ';' is read to single line.
-	while (value[value.size() -1] != ';') {
-		std::string str;
-		if (!getline (str)) throw std::runtime_error("Invalid format, semicolon missing after value of " + key);
-		value += trim(str);
+	while (value.empty() || value.back() != ';') {
+		std::string_view str;
+		if (!getline (str)) throw std::runtime_error("Invalid format, semicolon missing after value of " + std::string(key));
+		value += tokenizer::trim(str);
 	}
-	value = value.substr(0, value.size() - 1);	//Here the end character(';') is eliminated
+	value.pop_back();	//Here the end character(';') is eliminated
 	if (value.empty()) return true;
 
 	// Parse header data that is stored in SongParser rather than in song (and thus needs to be read every time)
 	if (key == "OFFSET") { assign(m_gap, value); m_gap *= -1; }
 	else if (key == "BPMS"){
-			std::istringstream iss(value);
+			tokenizer::Scanner scan(value);
 			double ts, bpm;
 			char chr;
-			while (iss >> ts >> chr >> bpm) {
+			while (scan >> ts >> chr >> bpm) {
 				if (ts == 0.0) m_bpm = static_cast<float>(bpm);
 				addBPM(ts * 4.0, m_bpm);
-				if (!(iss >> chr)) break;
+				if (!(scan >> chr)) break;
 			}
 	}
 	else if (key == "STOPS"){
-			std::istringstream iss(value);
+			tokenizer::Scanner scan(value);
 			double beat, sec;
 			char chr;
-			while (iss >> beat >> chr >> sec) {
+			while (scan >> beat >> chr >> sec) {
 				m_stops.push_back(std::make_pair(beat * 4.0, sec));
-				if (!(iss >> chr)) break;
+				if (!(scan >> chr)) break;
 			}
 	}
 
@@ -172,7 +177,16 @@ bool SongParser::smParseField(std::string line) {
 
 
 
-Notes SongParser::smParseNotes(std::string line) {
+/// Skip the note data of a track, up to and including the next #NOTES line
+void SongParser::smSkipNotes() {
+	std::string_view line;
+	while (getline(line)) {
+		line = tokenizer::trimLeft(line);
+		if (!line.empty() && line[0] == '#') break;
+	}
+}
+
+Notes SongParser::smParseNotes() {
 	//container for dance songs
 	typedef std::map<unsigned, Note> DanceChord;	//int indicates "arrow" position (cmp. fret in guitar)
 	typedef std::vector<DanceChord> DanceChords;
@@ -185,11 +199,12 @@ Notes SongParser::smParseNotes(std::string line) {
 
 	std::map<unsigned, unsigned> holdMarks; // Keeps track of hold notes not yet terminated
 
+	std::string_view line;
 	while (forceMeasure || getline(line)) {
 		if (forceMeasure) { line = ";"; forceMeasure = false; }
-		trim(line); // Remove whitespace
+		line = tokenizer::trim(line); // Remove whitespace
 		if (line.empty()) continue;
-		if (line.substr(0, 2) == "//") continue;  // Skip comments
+		if (tokenizer::startsWith(line, "//")) continue;  // Skip comments
 		if (line[0] == '#') break;  // HACK: This should read away the next #NOTES: line
 		if (line[0] == ',' || line[0] == ';') {
 			double end = tsTime(measure * 16.0);
@@ -229,9 +244,9 @@ Notes SongParser::smParseNotes(std::string line) {
 		*/
 		DanceChord chord;
 		// Deal with ; or , being on a same line
-		if (line[line.size()-1] == ';' || line[line.size()-1] == ',') {
+		if (line.back() == ';' || line.back() == ',') {
 			forceMeasure = true;
-			line = line.substr(0, line.size()-1);
+			line.remove_suffix(1);
 		}
 		for(unsigned i = 0; i < line.size(); i++) {
 			char notetype = line[i];
@@ -21,7 +21,7 @@ bool SongParser::txtCheck(std::string const& data) const {
 /// Parse header data for Songs screen
 void SongParser::txtParseHeader() {
 	Song& s = m_song;
-	std::string line;
+	std::string_view line;
 	s.insertVocalTrack(TrackName::VOCAL_LEAD, VocalTrack(TrackName::VOCAL_LEAD)); // Dummy note to indicate there is a track
 	while (getline(line) && txtParseField(line)) {}
 	if (s.title.empty() || s.artist.empty()) throw SongParserException(s, "Required header fields missing", 0);
@@ -35,7 +35,7 @@ void SongParser::txtParseHeader() {
 
 /// Parse notes
 void SongParser::txtParse() {
-	std::string line;
+	std::string_view line;
 	m_curSinger = CurrentSinger::P1;
 	if (!m_song.vocalTracks.empty()) { m_song.vocalTracks.clear(); }
 	m_song.insertVocalTrack(TrackName::VOCAL_LEAD, VocalTrack(TrackName::VOCAL_LEAD));
@@ -102,14 +102,14 @@ void SongParser::txtParse() {
 	}
 }
 
-bool SongParser::txtParseField(std::string const& line) {
+bool SongParser::txtParseField(std::string_view line) {
 	if (line.empty()) return true;
 	if (line[0] != '#') return false;
-	std::string::size_type pos = line.find(':');
-	if (pos == std::string::npos) throw SongParserException(m_song, "Invalid txt format, should be #key:value", m_linenum);
-	std::string key = UnicodeUtil::toUpper(trim(line.substr(1, pos - 1)));
-	std::string value = trim(line.substr(pos + 1));
-	if (value.empty()) return true;
+	std::string_view keyView, valueView;
+	if (!tokenizer::keyValue(line, keyView, valueView)) throw SongParserException(m_song, "Invalid txt format, should be #key:value", m_linenum);
+	if (valueView.empty()) return true;
+	std::string const key = toUpperKey(keyView);
+	std::string const value(valueView);
 
 	if (key == "VERSION") m_song.version = value.substr(value.find_first_not_of(" "));
 
@@ -147,19 +147,19 @@ bool SongParser::txtParseField(std::string const& line) {
 	return true;
 }
 
-bool SongParser::txtParseNote(std::string line) {
+bool SongParser::txtParseNote(std::string_view line) {
     const int MAX_STARTBEAT = 262144; // 2^18, about 2 hours on an average song (depends on BPM)
     const int MAX_LENGTH = 2048; // A very long note
 	if (line.empty() || line == "\r") return true;
 	if (line[0] == '#') throw SongParserException(m_song, "Key found in the middle of notes", m_linenum);
-	if (line[line.size() - 1] == '\r') line.erase(line.size() - 1);
+	if (line.back() == '\r') line.remove_suffix(1);
 	if (line[0] == 'E') return false;
-	std::istringstream iss(line);
+	tokenizer::Scanner scan(line);
 	if (line[0] == 'B') {
 		int ts;
 		float bpm;
-		iss.ignore();
-		if (!(iss >> ts >> bpm) || ts < 0 || ts > MAX_STARTBEAT) 
+		scan.ignore();
+		if (!(scan >> ts >> bpm) || ts < 0 || ts > MAX_STARTBEAT) 
         	throw SongParserException(m_song, "Invalid BPM line format", m_linenum);
 		addBPM(static_cast<unsigned int>(ts), bpm);
 		return true;
@@ -180,7 +180,7 @@ bool SongParser::txtParseNote(std::string line) {
 		return true;
 	}
 	Note n;
-	n.type = Note::Type(iss.get());
+	n.type = Note::Type(scan.get());
 	unsigned int ts = m_txt.prevts;
 	switch (n.type) {
 		case Note::Type::NORMAL:
@@ -192,7 +192,7 @@ bool SongParser::txtParseNote(std::string line) {
 			int readTs = 0;  // read as signed int to check for negative values
 			int readLength = 0;
 			unsigned int length = 0;
-			if (!(iss >> readTs >> readLength >> n.note) || readTs < 0 || readTs > MAX_STARTBEAT || readLength < 0 || readLength > MAX_LENGTH) 
+			if (!(scan >> readTs >> readLength >> n.note) || readTs < 0 || readTs > MAX_STARTBEAT || readLength < 0 || readLength > MAX_LENGTH) 
 				throw SongParserException(m_song, "Invalid note line format", m_linenum);
 			ts = static_cast<unsigned int>(readTs);
 			length = static_cast<unsigned int>(readLength);
@@ -202,14 +202,14 @@ bool SongParser::txtParseNote(std::string line) {
 			}
 			n.notePrev = n.note; // No slide notes in TXT yet.
 			if (m_relative) ts += m_txt.relativeShift;
-			if (iss.get() == ' ') std::getline(iss, n.syllable);
+			if (scan.get() == ' ') n.syllable = scan.rest();
 			n.end = tsTime(ts + length);
 		}
 		break;
 		case Note::Type::SLEEP:
 		{
 			unsigned int end;
-			if (!(iss >> ts >> end)) end = ts;
+			if (!(scan >> ts >> end)) end = ts;
 			if (m_relative) {
 				ts += m_txt.relativeShift;
 				end += m_txt.relativeShift;
@@ -26,8 +26,8 @@ void disableXMLLogger() { xmlSetGenericErrorFunc(NULL, xmlLogger); }
 
 struct SSDom: public xmlpp::DomParser {
 	xmlpp::Node::PrefixNsMap nsmap;
-	SSDom(std::stringstream const& _ss) {
-		load(_ss.str());
+	SSDom(std::string const& buf) {
+		load(buf);
 	}
 	void load(std::string const& buf) {
 		set_substitute_entities();
@@ -72,7 +72,7 @@ void SongParser::xmlParseHeader() {
 	Song& s = m_song;
 
 	// Parse notes.xml
-	SSDom dom(m_ss);
+	SSDom dom(m_data);
 	// Extract artist and title from XML comments
 	{
 		xmlpp::const_NodeSet comments;
@@ -131,7 +131,7 @@ void addNoteToTrack(VocalTrack& vocal, const Note& note) {
 /// Parse notes
 void SongParser::xmlParse() {
 	// Parse notes.xml
-	SSDom dom(m_ss);
+	SSDom dom(m_data);
 	Song& s = m_song;
 
 	// Parse each track...
@@ -1,5 +1,6 @@
 #include "songparser.hh"
 #include "unicode.hh"
+#include "utf8.hh"
 #include "util.hh"
 
 #include <boost/algorithm/string.hpp>
@@ -55,28 +56,37 @@ namespace SongParserUtil {
 	void eraseLast(std::string& s, char ch) {
 		if (!s.empty() && (*s.rbegin() == ch)) { s.erase(s.size() - 1); }
 	}
+	std::string toUpperKey(std::string_view str) {
+		return utf8::isASCII(str) ? tokenizer::toUpperASCII(str) : UnicodeUtil::toUpper(str);
+	}
+	std::string toLowerKey(std::string_view str) {
+		return utf8::isASCII(str) ? tokenizer::toLowerASCII(str) : UnicodeUtil::toLower(str);
+	}
 }
 
 SongParser::SongParser(Song& s) : m_song(s) {
 	try {
 		// Read the file, determine the type and do some initial validation checks
-		std::ifstream f(s.filename.string(), std::ios::binary);
+		std::ifstream f(s.filename.string(), std::ios::binary | std::ios::ate);
 		if (!f.is_open()) {
 			throw SongParserException(s, "Could not open song file", 0);
 		}
-		m_ss << f.rdbuf();
-		size_t size = m_ss.str().length();
+		auto const size = static_cast<std::streamoff>(f.tellg());
 		if ((size < 10) || (size > 100000)) {
 			throw SongParserException(s, "Does not look like a song file (wrong size)");
 		}
-		std::string ss = UnicodeUtil::convertToUTF8(m_ss.str(), s.filename.string());
+		m_data.resize(static_cast<std::size_t>(size));
+		f.seekg(0);
+		if (!f.read(m_data.data(), size)) {
+			throw SongParserException(s, "Could not read song file", 0);
+		}
+		// Convert to UTF-8; filename supplied for possible warning messages
+		std::string ss = UnicodeUtil::convertToUTF8(m_data, s.filename.string());
 		if (!isText(ss)) {
 			throw SongParserException(s, "Does not look like a song file (binary)");
 		}
-		// Convert m_ss; filename supplied for possible warning messages
-		if (xmlCheck(m_ss.str())) {
+		if (xmlCheck(m_data)) {
 			s.type = Song::Type::XML; // XMLPP should deal with encoding so we don't have to.
-			ss = m_ss.str();
 		}
 		else {
 			// For determining song type, SM has to come first as it's very similar in structure to the TXT format and thus it's possible for SM songs to be erroneously categorized as TXT songs.
@@ -89,8 +99,9 @@ SongParser::SongParser(Song& s) : m_song(s) {
 			} else {
 				throw SongParserException(s, "Does not look like a song file (wrong header)");
 			}
-			m_ss.str(ss);
+			m_data = std::move(ss);
 		}
+		m_lines = tokenizer::LineReader(m_data);
 		// Header always parsed after this point
 		bool headerAlreadyParsed = s.loadStatus == Song::LoadStatus::HEADER;
 		if (!headerAlreadyParsed) {
@@ -98,9 +109,7 @@ SongParser::SongParser(Song& s) : m_song(s) {
 			if (s.type == Song::Type::TXT) txtParseHeader();
 			else if (s.type == Song::Type::INI) iniParseHeader();
 			else if (s.type == Song::Type::XML) xmlParseHeader();
-			else if (s.type == Song::Type::SM) {
-				smParseHeader(); s.dropNotes();  // Hack: drop notes here (load again when playing the song)
-			}
+			else if (s.type == Song::Type::SM) smParseHeader();
 		}
 
 		guessFiles();
@@ -343,6 +352,7 @@ void SongParser::addBPM(double ts, float bpm) {
 		if (s.m_bpms.back().ts < ts) { throw std::runtime_error("Invalid BPM timestamp"); }
 		s.m_bpms.pop_back();	// Some ITG songs contain repeated BPM definitions...
 	}
+	m_bpmsSorted = s.m_bpms.empty() || (m_bpmsSorted && s.m_bpms.back().ts < ts);
 	s.m_bpms.push_back(Song::BPM(tsTime(ts), ts, bpm));
 }
 
@@ -352,6 +362,11 @@ double SongParser::tsTime(double ts) const {
 		if (ts != 0) { throw std::runtime_error("BPM data missing"); }
 		return m_gap;
 	}
+	if (m_bpmsSorted) {
+		std::size_t i = m_bpmCursor.find(s.m_bpms, ts);
+		if (i != TempoCursor::npos) { return s.m_bpms[i].begin + (ts - s.m_bpms[i].ts) * s.m_bpms[i].step; }
+		throw std::logic_error("INTERNAL ERROR: BPM data invalid");
+	}
 	for (std::vector<Song::BPM>::const_reverse_iterator it = s.m_bpms.rbegin(); it != s.m_bpms.rend(); ++it) {
 		if (it->ts <= ts) { return it->begin + (ts - it->ts) * it->step; }
 	}
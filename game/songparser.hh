@@ -2,8 +2,10 @@
 
 #include "libxml++.hh"
 #include "song.hh"
+#include "tempocursor.hh"
 #include "unicode.hh"
 #include "fs.hh"
+#include "tokenizer.hh"
 
 #include <boost/range/adaptor/reversed.hpp>
 
@@ -14,31 +16,8 @@
 
 namespace SongParserUtil {
 
-#if defined(_MSC_VER)
-	const auto regex_multiline = std::regex_constants::ECMAScript; // MSVC hasn't implemented multiline.
-#else
-	const auto regex_multiline = std::regex::multiline;
-#endif
-
 	// There is some weird bug with std::regex and boost::locale on libc++ that makes regex fail if a global locale with a collation facet has been installed before instantiating patterns.
 
-	const static std::regex iniParseLine(
-		R"(^[^\S^\r\n]*)"                                       // Any number of white-space characters that are neither \n nor \r
-		R"(([a-zA-Z0-9._-]+))"                                  // INI key is one or more characters, letters and numbers, plus '.', '_' and '-'
-		R"([^\S^\r\n]*)"                                        // Any number of white-space characters that are neither \n nor \r
-		R"(=)"                                                  // Delimiter
-		R"([^\S^\r\n]*)"                                        // Any number of white-space characters that are neither \n nor \r
-		R"(([^\n\r]*?))"                                        // Non-greedy matching any character that is neither \r nor \n, and
-		R"((?=[^\S^\r\n]*$))", regex_multiline                  // That is followed by any number of white-space characters that are neither \n nor \r, and the end of the line.
-	);
-
-	const static std::regex iniCheckHeader(
-		R"(^[^\S^\r\n]*)"                                       // Any number of white-space characters that are neither \n nor \r
-		R"(\[song\])"                                           // literal matching of [song]
-		R"([^\S^\r\n]*)"                                        // Any number of white-space characters that are neither \n nor \r
-		R"((?:$|[;#]))", regex_multiline                        // Non-capturing group; match end-of-line or either ';' or '#', which denote a trailing comment.
-	);
-
 	const static std::regex richTags(
 		R"(</?)"                                                // A '<', followed by either 0 or 1 slashes.
 		R"((b|i|u|s|size|font|align|gradient|sub|sup|link))"    // Any one of these tags
@@ -66,6 +45,10 @@ namespace SongParserUtil {
 	void assign(bool& var, std::string const& str);
 	/// Erase last character if it matches
 	void eraseLast(std::string& s, char ch = ' ');
+	/// Convert a header key or keyword to upper case, without ICU for plain ASCII
+	std::string toUpperKey(std::string_view str);
+	/// Convert a header key or keyword to lower case, without ICU for plain ASCII
+	std::string toLowerKey(std::string_view str);
 }
 
 /// Parse a song file; this object is only used while parsing and is discarded once done.
@@ -77,11 +60,14 @@ public:
 private:
 	// Variables and types
 	Song& m_song;
-	std::stringstream m_ss;
+	std::string m_data;  ///< File contents, converted to UTF-8 (except for XML)
+	tokenizer::LineReader m_lines;  ///< Line cursor over m_data
 	unsigned m_linenum = 0;
 	bool m_relative = false;
 	double m_gap = 0.0;
 	float m_bpm = 0.0f;
+	bool m_bpmsSorted = true;  ///< False if a file had BPM timestamps go backwards, which tsTime cannot binary search
+	mutable TempoCursor m_bpmCursor;  ///< Segment of m_song.m_bpms that tsTime found last
 	unsigned m_tsPerBeat = 0;  ///< The ts increment per beat
 	unsigned m_tsEnd = 0;  ///< The ending ts of the song
 	enum class CurrentSinger { P1, P2, BOTH } m_curSinger = CurrentSinger::P1;
@@ -96,15 +82,15 @@ private:
 	void finalize();
 	void vocalsTogether();
 	void guessFiles();
-	bool getline (std::string& line) { ++m_linenum; return (bool) std::getline (m_ss, line); }
+	bool getline (std::string_view& line) { ++m_linenum; return m_lines.next(line); }
 	Song::BPM getBPM(Song const& s, double ts) const;
 	void addBPM(double ts, float bpm);
 	double tsTime(double ts) const;	 ///< Convert a timestamp (beats) into time (seconds)
 	bool txtCheck(std::string const& data) const;
 	void txtParseHeader();
 	void txtParse();
-	bool txtParseField(std::string const& line);
-	bool txtParseNote(std::string line);
+	bool txtParseField(std::string_view line);
+	bool txtParseNote(std::string_view line);
 	void txtResetState();
 	bool iniCheck(std::string const& data) const;
 	void iniParseHeader();
@@ -118,7 +104,8 @@ private:
 	bool smCheck(std::string const& data) const;
 	void smParseHeader();
 	void smParse();
-	bool smParseField(std::string line);
-	Notes smParseNotes(std::string line);
+	bool smParseField(std::string_view line);
+	Notes smParseNotes();
+	void smSkipNotes();
 	std::pair<double, double> smStopConvert(std::pair<double, double> s);
 };
@@ -462,13 +462,13 @@ namespace {
 
 std::string Songs::typeDesc() const {
 	switch (m_type) {
-		case 0: return _("show all songs");
-		case 1: return _("has dance");
-		case 2: return _("has vocals");
-		case 3: return _("has duet");
-		case 4: return _("has guitar");
-		case 5: return _("drums or keytar");
-		case 6: return _("full band");
+		case 0: return _c("show all songs");
+		case 1: return _c("has dance");
+		case 2: return _c("has vocals");
+		case 3: return _c("has duet");
+		case 4: return _c("has guitar");
+		case 5: return _c("drums or keytar");
+		case 6: return _c("full band");
 	}
 	throw std::logic_error("Internal error: unknown type filter in Songs::typeDesc");
 }
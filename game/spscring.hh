@@ -0,0 +1,58 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+/**
+ * Wait-free single producer, single consumer queue of samples, for handing data out of the audio callback.
+ * Unlike RingBuffer, a full queue never touches the consumer's position: samples that do not fit are dropped and counted.
+ */
+class SpscRing {
+  public:
+	/// Capacity is rounded up to a power of two
+	explicit SpscRing(std::size_t capacity): m_buf(roundUp(capacity)), m_mask(m_buf.size() - 1) {}
+	std::size_t capacity() const { return m_buf.size(); }
+	/// Producer: append samples, returns the number of samples stored (the rest are counted as overrun)
+	template <typename InIt> std::size_t push(InIt begin, InIt end);
+	/// Consumer: move up to max samples to out, returns the number of samples taken
+	std::size_t pop(float* out, std::size_t max);
+	/// Consumer: drop everything queued so far
+	void clear() { m_read.store(m_write.load(std::memory_order_acquire), std::memory_order_release); }
+	/// Samples dropped because the queue was full
+	std::size_t overruns() const { return m_overruns.load(std::memory_order_relaxed); }
+
+  private:
+	static std::size_t roundUp(std::size_t n) {
+		std::size_t size = 1;
+		while (size < n) size <<= 1;
+		return size;
+	}
+	std::vector<float> m_buf;
+	std::size_t const m_mask;
+	// Ever increasing positions, only written by their own side
+	alignas(64) std::atomic<std::size_t> m_write{ 0 };
+	alignas(64) std::atomic<std::size_t> m_read{ 0 };
+	std::atomic<std::size_t> m_overruns{ 0 };
+};
+
+template <typename InIt> std::size_t SpscRing::push(InIt begin, InIt end) {
+	std::size_t const w = m_write.load(std::memory_order_relaxed);
+	std::size_t const space = m_buf.size() - (w - m_read.load(std::memory_order_acquire));
+	std::size_t count = 0;
+	for (; begin != end && count < space; ++begin, ++count) m_buf[(w + count) & m_mask] = *begin;
+	m_write.store(w + count, std::memory_order_release);
+	std::size_t dropped = 0;
+	for (; begin != end; ++begin) ++dropped;  // Input iterators may be strided (interleaved channels)
+	if (dropped) m_overruns.fetch_add(dropped, std::memory_order_relaxed);
+	return count;
+}
+
+inline std::size_t SpscRing::pop(float* out, std::size_t max) {
+	std::size_t const r = m_read.load(std::memory_order_relaxed);
+	std::size_t const count = std::min(max, m_write.load(std::memory_order_acquire) - r);
+	for (std::size_t i = 0; i < count; ++i) out[i] = m_buf[(r + i) & m_mask];
+	m_read.store(r + count, std::memory_order_release);
+	return count;
+}
@@ -0,0 +1,83 @@
+#include "startup.hh"
+
+#include "chrono.hh"
+#include "log.hh"
+
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+	// Initialized during static initialization, i.e. before main()
+	Time const processStart = Clock::now();
+}
+
+void Startup::add(std::string const& name, Thread thread, std::vector<std::string> const& dependencies, std::function<void()> func) {
+	Stage stage{ name, thread, {}, std::move(func) };
+	for (auto const& dependency: dependencies) {
+		auto it = std::find_if(m_stages.begin(), m_stages.end(), [&](Stage const& s) { return s.name == dependency; });
+		if (it == m_stages.end()) throw std::logic_error("Startup stage " + name + " depends on unknown stage " + dependency);
+		stage.dependencies.push_back(static_cast<std::size_t>(it - m_stages.begin()));
+	}
+	m_stages.push_back(std::move(stage));
+}
+
+bool Startup::ready(Stage const& stage) const {
+	return std::all_of(stage.dependencies.begin(), stage.dependencies.end(), [this](std::size_t i) { return m_stages[i].state == State::DONE; });
+}
+
+void Startup::execute(Stage& stage) {
+	double const begin = elapsed();
+	std::exception_ptr error;
+	try {
+		stage.func();
+	} catch (...) {
+		error = std::current_exception();
+	}
+	double const end = elapsed();
+	SpdLogger::info(LogSystem::LOGGER, "Startup stage={}, thread={}, start={:.3f}s, duration={:.3f}s{}", stage.name,
+	  stage.thread == Thread::MAIN ? "main" : "worker", begin, end - begin, error ? ", failed" : "");
+	std::lock_guard<std::mutex> l(m_mutex);
+	if (error && !m_error) m_error = error;
+	stage.state = error ? State::FAILED : State::DONE;
+	m_condition.notify_all();
+}
+
+void Startup::run() {
+	std::vector<std::thread> workers;
+	std::unique_lock<std::mutex> l(m_mutex);
+	while (true) {
+		Stage* mainStage = nullptr;
+		for (auto& stage: m_stages) {
+			if (stage.state != State::WAITING || m_error || !ready(stage)) continue;
+			if (stage.thread == Thread::WORKER) {
+				stage.state = State::RUNNING;
+				workers.emplace_back([this, &stage] { execute(stage); });
+			}
+			else if (!mainStage) mainStage = &stage;
+		}
+		if (mainStage) {
+			mainStage->state = State::RUNNING;
+			l.unlock();
+			execute(*mainStage);
+			l.lock();
+			continue;
+		}
+		// Done when nothing is running: either all stages have completed or one has failed
+		if (std::none_of(m_stages.begin(), m_stages.end(), [](Stage const& s) { return s.state == State::RUNNING; })) break;
+		m_condition.wait(l);
+	}
+	l.unlock();
+	for (auto& worker: workers) worker.join();
+	if (m_error) std::rethrow_exception(m_error);
+	SpdLogger::info(LogSystem::LOGGER, "Startup finished, elapsed={:.3f}s", elapsed());
+}
+
+double Startup::elapsed() {
+	return Seconds(Clock::now() - processStart).count();
+}
+
+void Startup::interactive() {
+	static std::once_flag once;
+	std::call_once(once, [] { SpdLogger::info(LogSystem::LOGGER, "Time to interactive={:.3f}s", elapsed()); });
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * Runs the startup of the game as a dependency graph of stages. A stage starts as soon as all its dependencies are done:
+ * worker stages on threads of their own, main stages (anything that touches SDL or OpenGL) on the thread calling run().
+ * The start time and duration of every stage are logged relative to process start, giving a startup timeline.
+ */
+class Startup {
+  public:
+	enum class Thread { MAIN, WORKER };
+	/// Add a stage; dependencies refer to stages added earlier (so that there cannot be cycles)
+	void add(std::string const& name, Thread thread, std::vector<std::string> const& dependencies, std::function<void()> func);
+	/// Run all stages. If any of them throws, no further stages are started and the first exception is rethrown.
+	void run();
+	/// Seconds since the process started
+	static double elapsed();
+	/// Log time to interactive, to be called once the first frame of the main menu has been displayed (later calls do nothing)
+	static void interactive();
+
+  private:
+	enum class State { WAITING, RUNNING, DONE, FAILED };
+	struct Stage {
+		std::string name;
+		Thread thread;
+		std::vector<std::size_t> dependencies;
+		std::function<void()> func;
+		State state = State::WAITING;
+	};
+	bool ready(Stage const& stage) const;
+	void execute(Stage& stage);
+	std::vector<Stage> m_stages;
+	std::mutex m_mutex;
+	std::condition_variable m_condition;
+	std::exception_ptr m_error;
+};
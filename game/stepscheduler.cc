@@ -0,0 +1,19 @@
+#include "stepscheduler.hh"
+
+#include <algorithm>
+
+StepScheduler::Batch StepScheduler::take(double now) {
+	Batch batch;
+	if (std::isnan(now) || now < next()) return batch;
+	// Steps that have begun by now: [m_steps, last]
+	auto const last = std::max(m_steps, static_cast<unsigned long>(std::floor(now / m_timestep)));  // Guard against rounding
+	batch.steps = static_cast<unsigned>(last + 1 - m_steps);
+	batch.lag = now - next();
+	m_steps = last + 1;
+	return batch;
+}
+
+double StepScheduler::wait(double now) const {
+	if (std::isnan(now)) return m_timestep;
+	return std::clamp(next() - now, 0.0, m_timestep);
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cmath>
+
+/**
+ * Paces fixed time steps by an external clock (for Engine: the audio position minus round-trip latency).
+ * A step is due as soon as the clock reaches its begin time. A caller that has fallen behind gets all overdue steps in
+ * one batch, so that it catches up without waiting in between.
+ */
+class StepScheduler {
+  public:
+	struct Batch {
+		unsigned steps = 0; ///< Number of steps to run now
+		double lag = 0.0; ///< How far the clock is past the begin of the first of these steps (seconds)
+	};
+	explicit StepScheduler(double timestep): m_timestep(timestep) {}
+	/// Steps due at clock time now, which are then considered done. A clock that is not running (NaN) has no steps due.
+	Batch take(double now);
+	/// Clock time at which the next step becomes due
+	double next() const { return static_cast<double>(m_steps) * m_timestep; }
+	/// Time until the next step is due at clock time now (between zero and one step; one step if the clock is not running)
+	double wait(double now) const;
+	/// Number of steps taken so far
+	unsigned long steps() const { return m_steps; }
+
+  private:
+	double const m_timestep;
+	unsigned long m_steps = 0;
+};
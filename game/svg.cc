@@ -16,7 +16,7 @@
 
 void loadSVG(Bitmap& bitmap, fs::path const& filename) {
 	float factor = config["graphic/svg_lod"].f();
-	// Try to load a cached PNG instead
+	// Try to load a cached bitmap instead
 	if (cache::loadSVG(bitmap, filename, factor)) return;
 	SpdLogger::debug(LogSystem::IMAGE, "Loading SVG file, path={}.", filename);
 	// Open the SVG file in librsvg
@@ -57,15 +57,8 @@ void loadSVG(Bitmap& bitmap, fs::path const& filename) {
 	rsvg_handle_render_cairo(svgHandle.get(), dc.get());
 #endif
 	// Change byte order from BGRA to RGBA
-	for (std::uint32_t *ptr = reinterpret_cast<std::uint32_t*>(bitmap.buf.data()), *end = ptr + bitmap.buf.size() / 4; ptr < end; ++ptr) {
-		std::uint8_t* pixel = reinterpret_cast<std::uint8_t*>(ptr);
-		std::uint8_t r = pixel[2], g = pixel[1], b = pixel[0], a = pixel[3];
-		pixel[0] = r; pixel[1] = g; pixel[2] = b; pixel[3] = a;
-	}
+	argbToRgba(bitmap.buf.data(), bitmap.buf.size() / 4);
 	bitmap.fmt = pix::Format::CHAR_RGBA;
 	// Write to cache so that it can be loaded faster the next time
-	fs::path cache_filename = cache::constructSVGCacheFileName(filename, factor);
-	fs::create_directories(cache_filename.parent_path());
-	writePNG(cache_filename, bitmap);
-
+	cache::saveSVG(bitmap, filename, factor);
 }
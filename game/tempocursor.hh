@@ -0,0 +1,28 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+/**
+ * Finds the tempo segment that a timestamp falls into, i.e. the last segment whose ts is at or before it, in a table of
+ * segments with strictly increasing ts. Parsers mostly convert timestamps in order, so the segment found previously and
+ * the one after it are tried first; anything else is a binary search instead of a scan over the whole table.
+ */
+class TempoCursor {
+  public:
+	static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+	/// Index of the segment of ts, or npos if ts is before the first segment (or NaN)
+	template <typename Segment> std::size_t find(std::vector<Segment> const& segments, double ts) {
+		if (segments.empty() || !(segments.front().ts <= ts)) return npos;
+		auto const covers = [&](std::size_t i) { return segments[i].ts <= ts && (i + 1 == segments.size() || ts < segments[i + 1].ts); };
+		std::size_t i = std::min(m_index, segments.size() - 1);
+		if (covers(i)) return m_index = i;
+		if (i + 1 < segments.size() && covers(i + 1)) return m_index = i + 1;
+		auto it = std::upper_bound(segments.begin(), segments.end(), ts, [](double ts, Segment const& s) { return ts < s.ts; });
+		return m_index = static_cast<std::size_t>(it - segments.begin()) - 1;
+	}
+
+  private:
+	std::size_t m_index = 0;
+};
@@ -1,5 +1,6 @@
 #include "texture.hh"
 
+#include "cache.hh"
 #include "configuration.hh"
 #include "game.hh"
 #include "graphic/video_driver.hh"
@@ -34,32 +35,35 @@ struct Job {
 	typedef std::function<void (Bitmap& bitmap)> ApplyFunc;
 	ApplyFunc apply;
 	Bitmap bitmap;
+	unsigned thumbnailSize = 0;  ///< Maximum width/height of the loaded image, 0 for full resolution
 	Job() {}
-	Job(fs::path const& n, ApplyFunc const& a): name(n), apply(a) {}
+	Job(fs::path const& n, ApplyFunc const& a, unsigned t = 0): name(n), apply(a), thumbnailSize(t) {}
 };
 
 class TextureLoader::Impl {
 	/// Load a file from disk into a buffer
-	static void load(Bitmap& bitmap, fs::path const& name) {
+	static void load(Bitmap& bitmap, fs::path const& name, unsigned thumbnailSize) {
 		try {
-			auto const ext = toLower(name.extension().string());
 			if (!fs::is_regular_file(name))
 			{
 				throw std::runtime_error("File not found: " + name.string());
 			}
+			// Use a previously downscaled copy if there is one
+			if (thumbnailSize && cache::loadThumbnail(bitmap, name, thumbnailSize)) return;
+			const ImageType image_type{getImageType(name.string())};
+			if (image_type == ImageType::SVG)
+				loadSVG(bitmap, name);
+			else if (image_type == ImageType::JPEG)
+				loadJPEG(bitmap, name);
+			else if (image_type == ImageType::PNG)
+				loadPNG(bitmap, name);
+			else if (image_type == ImageType::WEBP)
+				loadWEBP(bitmap, name);
 			else
-			{
-				const ImageType image_type{getImageType(name.string())};
-				if (image_type == ImageType::SVG)
-					loadSVG(bitmap, name);
-				else if (image_type == ImageType::JPEG)
-					loadJPEG(bitmap, name);
-				else if (image_type == ImageType::PNG)
-					loadPNG(bitmap, name);
-				else if (image_type == ImageType::WEBP)
-					loadWEBP(bitmap, name);
-				else
-					throw std::runtime_error("Unknown image file format: " + name.string());
+				throw std::runtime_error("Unknown image file format: " + name.string());
+			if (thumbnailSize) {
+				bitmap.downscale(thumbnailSize);
+				cache::saveThumbnail(bitmap, name, thumbnailSize);
 			}
 		}
 		catch (std::exception& e) {
@@ -80,12 +84,14 @@ public:
 		while (!m_quit) {
 			void const* target = nullptr;
 			fs::path name;
+			unsigned thumbnailSize = 0;
 			{
 				// Poll for jobs to be done
 				std::unique_lock<std::mutex> l(m_mutex);
 				for (auto& job: m_jobs) {
 					if (job.second.name.empty()) continue;  // Job already done
 					name = job.second.name;
+					thumbnailSize = job.second.thumbnailSize;
 					target = job.first;
 					break;
 				}
@@ -97,7 +103,7 @@ public:
 			}
 			// Load image file into buffer
 			Bitmap bitmap;
-			load(bitmap, name);
+			load(bitmap, name, thumbnailSize);
 			// Store the result
 			std::lock_guard<std::mutex> l(m_mutex);
 			auto it = m_jobs.find(target);
@@ -142,17 +148,17 @@ TextureLoader::~TextureLoader() { ldr.reset(); }
 
 void updateTextures() { ldr->apply(); }
 
-template <typename T> void loader(T* target, fs::path const& name) {
+template <typename T> void loader(T* target, fs::path const& name, unsigned thumbnailSize) {
 	// Temporarily add 1x1 pixel black texture
 	Bitmap bitmap;
 	bitmap.fmt = pix::Format::RGB;
 	bitmap.resize(1, 1);
 	target->load(bitmap);
 	// Ask the loader to retrieve the image
-	ldr->push(target, Job(name, [target](Bitmap& bitmap){ target->load(bitmap); }));
+	ldr->push(target, Job(name, [target](Bitmap& bitmap){ target->load(bitmap); target->m_ready = true; }, thumbnailSize));
 }
 
-Texture::Texture(fs::path const& filename) { loader(this, filename); }
+Texture::Texture(fs::path const& filename, unsigned thumbnailSize) { loader(this, filename, thumbnailSize); }
 Texture::~Texture() { ldr->remove(this); }
 
 // Stuff for converting pix::Format into OpenGL enum values & other flags
@@ -218,10 +218,11 @@ public:
 	/// texture coordinates
 	TexCoords tex;
 	Texture() = default;
-	/// creates texture from file
-	Texture(fs::path const& filename);
+	/// creates texture from file, optionally as a cached thumbnail no larger than thumbnailSize pixels
+	Texture(fs::path const& filename, unsigned thumbnailSize = 0);
 	~Texture();
 	bool empty() const { return m_width * m_height == 0.f; } ///< Test if the loading has failed
+	bool ready() const { return m_ready; } ///< Test if the file has been loaded (until then a placeholder pixel is shown)
 	/// draws texture
 	void draw(Window&) const;
 	void draw(Window&, glmath::mat3 const&) const;
@@ -232,9 +233,11 @@ public:
 	float width() const { return m_width; }
 	float height() const { return m_height; }
 private:
+	template <typename T> friend void loader(T* target, fs::path const& name, unsigned thumbnailSize);
 	float m_width = 0.f;
 	float m_height = 0.f;
 	bool m_premultiplied = true;
+	bool m_ready = false;
 	OpenGLTexture<GL_TEXTURE_2D> m_texture;
 };
 
@@ -0,0 +1,76 @@
+#include "texture_cache.hh"
+
+#include "configuration.hh"
+#include "log.hh"
+#include "texture.hh"
+
+#include <algorithm>
+#include <vector>
+
+namespace {
+	/// Estimated GPU memory of a texture: RGBA pixels plus the mipmap chain (1/3 extra).
+	std::size_t textureMemory(Texture const& texture) {
+		auto const pixels = static_cast<std::size_t>(texture.width()) * static_cast<std::size_t>(texture.height());
+		return pixels * 4 * 4 / 3;
+	}
+}
+
+TextureCache::TextureCache(std::string const& name): m_name(name) {}
+
+TextureCache::~TextureCache() = default;
+
+Texture* TextureCache::get(fs::path const& path) {
+	auto it = m_textures.find(path);
+	if (it == m_textures.end()) {
+		Entry entry;
+		entry.texture = std::make_unique<Texture>(path, config["graphic/cover_thumbnail_size"].ui());
+		it = m_textures.emplace(path, std::move(entry)).first;
+	}
+	Entry& entry = it->second;
+	entry.lastUsed = m_frame;
+	if (!entry.texture->ready() || entry.texture->empty()) return nullptr;
+	return entry.texture.get();
+}
+
+bool TextureCache::failed(fs::path const& path) const {
+	auto it = m_textures.find(path);
+	return it != m_textures.end() && it->second.texture->ready() && it->second.texture->empty();
+}
+
+void TextureCache::frame() {
+	m_memory = 0;
+	for (auto const& [path, entry]: m_textures) {
+		if (entry.texture->ready()) m_memory += textureMemory(*entry.texture);
+	}
+	std::size_t const budget = std::size_t(config["graphic/texture_cache_size"].ui()) << 20;
+	if (m_memory > budget) evict(budget);
+	// Report at most every few seconds, and only when something has changed
+	if (m_evictions != m_loggedEvictions && m_frame % 300 == 0) {
+		SpdLogger::debug(LogSystem::PROFILER, "TextureCache {}: textures={}, memory={:.1f} MiB, budget={} MiB, evictions={}.",
+		  m_name, m_textures.size(), double(m_memory) / (1 << 20), budget >> 20, m_evictions);
+		m_loggedEvictions = m_evictions;
+	}
+	++m_frame;
+}
+
+void TextureCache::evict(std::size_t budget) {
+	// Oldest first; anything used during the current frame is kept even if that exceeds the budget
+	using Iterator = decltype(m_textures)::iterator;
+	std::vector<Iterator> candidates;
+	for (auto it = m_textures.begin(); it != m_textures.end(); ++it) {
+		if (it->second.lastUsed < m_frame) candidates.push_back(it);
+	}
+	std::sort(candidates.begin(), candidates.end(), [](Iterator a, Iterator b) { return a->second.lastUsed < b->second.lastUsed; });
+	for (auto it: candidates) {
+		if (m_memory <= budget) break;
+		Texture const& texture = *it->second.texture;
+		if (texture.ready()) m_memory -= textureMemory(texture);
+		m_textures.erase(it);
+		++m_evictions;
+	}
+}
+
+void TextureCache::clear() {
+	m_textures.clear();
+	m_memory = 0;
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "fs.hh"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+class Texture;
+
+/// A memory-bounded set of textures loaded from files (e.g. song covers).
+/// Textures are loaded as thumbnails and the least recently drawn ones are evicted when over budget.
+class TextureCache {
+public:
+	/// The name is only used for profiler logging.
+	TextureCache(std::string const& name);
+	~TextureCache();
+	/// Get the texture of the given file, starting to load it if needed.
+	/// Returns nullptr while the file is loading or if it could not be loaded; callers should draw a placeholder.
+	Texture* get(fs::path const& path);
+	/// Test if the given file was requested and could not be loaded (so that callers may try another one).
+	bool failed(fs::path const& path) const;
+	/// Call once per frame after drawing to advance the frame counter and evict textures over budget.
+	void frame();
+	/// Drop all textures.
+	void clear();
+	/// Estimated texture memory (in bytes) used by the loaded textures.
+	std::size_t memory() const { return m_memory; }
+	/// Number of textures evicted so far.
+	unsigned evictions() const { return m_evictions; }
+
+private:
+	struct Entry {
+		std::unique_ptr<Texture> texture;
+		std::uint64_t lastUsed = 0;  ///< Frame number of the last get()
+	};
+	void evict(std::size_t budget);
+	std::string m_name;
+	std::unordered_map<fs::path, Entry, FsPathHash> m_textures;
+	std::uint64_t m_frame = 0;
+	std::size_t m_memory = 0;
+	unsigned m_evictions = 0;
+	unsigned m_loggedEvictions = 0;
+};
@@ -0,0 +1,208 @@
+#pragma once
+
+#include <charconv>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+/// Allocation free tokenizing of song files (TXT, SM and INI), operating on views of the file buffer
+namespace tokenizer {
+	/// ASCII whitespace (as std::isspace in the C locale)
+	inline bool isSpace(char c) { return c == ' ' || (c >= '\t' && c <= '\r'); }
+
+	inline std::string_view trimLeft(std::string_view str) {
+		while (!str.empty() && isSpace(str.front())) str.remove_prefix(1);
+		return str;
+	}
+
+	inline std::string_view trimRight(std::string_view str) {
+		while (!str.empty() && isSpace(str.back())) str.remove_suffix(1);
+		return str;
+	}
+
+	inline std::string_view trim(std::string_view str) { return trimRight(trimLeft(str)); }
+
+	inline bool startsWith(std::string_view str, std::string_view prefix) { return str.substr(0, prefix.size()) == prefix; }
+
+	/// Splits text into lines exactly like std::getline: '\n' is removed, '\r' is kept, no empty line after the last '\n'
+	class LineReader {
+	  public:
+		explicit LineReader(std::string_view text = {}): m_rest(text) {}
+		bool next(std::string_view& line) {
+			if (m_rest.empty()) return false;
+			auto const pos = m_rest.find('\n');
+			line = m_rest.substr(0, pos);
+			m_rest.remove_prefix(pos == std::string_view::npos ? m_rest.size() : pos + 1);
+			return true;
+		}
+
+	  private:
+		std::string_view m_rest;
+	};
+
+	/**
+	 * Reads values from a line with the rules of std::istream extraction: leading whitespace is skipped, a malformed
+	 * value stores zero (or the limit on overflow) and fails all further reads. Replaces std::istringstream in the parsers.
+	 */
+	class Scanner {
+	  public:
+		explicit Scanner(std::string_view text): m_rest(text) {}
+		explicit operator bool() const { return !m_fail; }
+		/// Next character, or -1 at the end (like std::istream::get)
+		int get() {
+			if (m_fail || m_rest.empty()) { m_fail = true; return -1; }
+			char const c = m_rest.front();
+			m_rest.remove_prefix(1);
+			return static_cast<unsigned char>(c);
+		}
+		void ignore() { if (!m_rest.empty()) m_rest.remove_prefix(1); }
+		/// Everything not yet read
+		std::string_view rest() const { return m_rest; }
+
+		Scanner& operator>>(char& c) {
+			if (skip()) { c = m_rest.front(); m_rest.remove_prefix(1); }
+			return *this;
+		}
+		Scanner& operator>>(int& value) { return integer(value); }
+		Scanner& operator>>(unsigned& value) { return integer(value); }
+		Scanner& operator>>(float& value) { return floating(value); }
+		Scanner& operator>>(double& value) { return floating(value); }
+
+	  private:
+		/// Skip whitespace before a value; fails (leaving the value untouched) if nothing is left
+		bool skip() {
+			if (m_fail) return false;
+			m_rest = trimLeft(m_rest);
+			if (m_rest.empty()) m_fail = true;
+			return !m_fail;
+		}
+		template <typename T> Scanner& integer(T& value) {
+			if (!skip()) return *this;
+			char const* begin = m_rest.data();
+			char const* end = begin + m_rest.size();
+			bool const negative = *begin == '-';
+			if (*begin == '+' || *begin == '-') ++begin;
+			// Parse the magnitude as unsigned, so that "-1" read into unsigned wraps around like strtoul does
+			unsigned long long magnitude = 0;
+			auto const [ptr, error] = std::from_chars(begin, end, magnitude);
+			if (ptr == begin) { value = 0; m_fail = true; return *this; }
+			m_rest.remove_prefix(static_cast<std::size_t>(ptr - m_rest.data()));
+			using Limits = std::numeric_limits<T>;
+			if constexpr (std::is_signed_v<T>) {
+				auto const limit = static_cast<unsigned long long>(Limits::max()) + (negative ? 1u : 0u);
+				if (error != std::errc() || magnitude > limit) { value = negative ? Limits::min() : Limits::max(); m_fail = true; }
+				else value = negative ? static_cast<T>(-static_cast<long long>(magnitude)) : static_cast<T>(magnitude);
+			} else {
+				if (error != std::errc() || magnitude > Limits::max()) { value = Limits::max(); m_fail = true; }
+				else value = negative ? static_cast<T>(-magnitude) : static_cast<T>(magnitude);
+			}
+			return *this;
+		}
+		template <typename T> Scanner& floating(T& value) {
+			if (!skip()) return *this;
+			// Collect the characters std::num_get would accept: [sign] digits [. digits] [e [sign] digits]
+			auto digits = [&](std::size_t pos) { while (pos < m_rest.size() && m_rest[pos] >= '0' && m_rest[pos] <= '9') ++pos; return pos; };
+			std::size_t len = 0;
+			if (m_rest[len] == '+' || m_rest[len] == '-') ++len;
+			len = digits(len);
+			if (len < m_rest.size() && m_rest[len] == '.') len = digits(len + 1);
+			if (len < m_rest.size() && (m_rest[len] == 'e' || m_rest[len] == 'E')) {
+				++len;
+				if (len < m_rest.size() && (m_rest[len] == '+' || m_rest[len] == '-')) ++len;
+				len = digits(len);
+			}
+			if (len == 0) { value = 0; m_fail = true; return *this; }
+			// Unlike strtod, std::from_chars ignores the locale (no decimal comma) but does not accept a plus sign
+			char const* begin = m_rest.data();
+			char const* end = begin + len;
+			bool const negative = *begin == '-';
+			if (*begin == '+') ++begin;
+			double result = 0.0;
+			auto const [ptr, error] = std::from_chars(begin, end, result);
+			m_rest.remove_prefix(len);
+			if (ptr != end) { value = 0; m_fail = true; }  // Such as a lone sign or an exponent without digits
+			else if (error != std::errc() || result > std::numeric_limits<T>::max() || result < std::numeric_limits<T>::lowest()) {
+				value = negative ? std::numeric_limits<T>::lowest() : std::numeric_limits<T>::max();
+				m_fail = true;
+			}
+			else value = static_cast<T>(result);
+			return *this;
+		}
+
+		std::string_view m_rest;
+		bool m_fail = false;
+	};
+
+	/// Splits "#KEY:VALUE" into trimmed key and value, returns false if there is no ':'
+	inline bool keyValue(std::string_view line, std::string_view& key, std::string_view& value) {
+		auto const pos = line.find(':');
+		if (pos == std::string_view::npos) return false;
+		key = trim(line.substr(1, pos - 1));
+		value = trim(line.substr(pos + 1));
+		return true;
+	}
+
+	inline std::string toUpperASCII(std::string_view str) {
+		std::string result(str);
+		for (char& c: result) if (c >= 'a' && c <= 'z') c = static_cast<char>(c - 'a' + 'A');
+		return result;
+	}
+
+	inline std::string toLowerASCII(std::string_view str) {
+		std::string result(str);
+		for (char& c: result) if (c >= 'A' && c <= 'Z') c = static_cast<char>(c - 'A' + 'a');
+		return result;
+	}
+
+	namespace detail {
+		inline bool isLineBreak(char c) { return c == '\n' || c == '\r'; }
+		/// Whitespace within a line
+		inline bool isBlank(char c) { return isSpace(c) && !isLineBreak(c); }
+		inline std::size_t skipBlank(std::string_view str, std::size_t pos) {
+			while (pos < str.size() && isBlank(str[pos])) ++pos;
+			return pos;
+		}
+		/// Calls match(pos) at the start of each line (after '\n' or '\r'), until it returns true
+		template <typename Match> bool anyLine(std::string_view str, Match match) {
+			for (std::size_t pos = 0;; ++pos) {
+				if (match(pos)) return true;
+				pos = str.find_first_of("\n\r", pos);
+				if (pos == std::string_view::npos) return false;
+			}
+		}
+	}
+
+	/// Finds "key = value" in an INI line; the value ends at a line break and has trailing whitespace removed
+	inline bool iniKeyValue(std::string_view line, std::string_view& key, std::string_view& value) {
+		using namespace detail;
+		auto keyChar = [](char c) { return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '.' || c == '_' || c == '-'; };
+		return anyLine(line, [&](std::size_t pos) {
+			std::size_t const keyBegin = skipBlank(line, pos);
+			std::size_t keyEnd = keyBegin;
+			while (keyEnd < line.size() && keyChar(line[keyEnd])) ++keyEnd;
+			if (keyEnd == keyBegin) return false;
+			std::size_t const eq = skipBlank(line, keyEnd);
+			if (eq == line.size() || line[eq] != '=') return false;
+			std::size_t const valueBegin = skipBlank(line, eq + 1);
+			std::size_t valueEnd = valueBegin;
+			while (valueEnd < line.size() && !isLineBreak(line[valueEnd])) ++valueEnd;
+			while (valueEnd > valueBegin && isBlank(line[valueEnd - 1])) --valueEnd;
+			key = line.substr(keyBegin, keyEnd - keyBegin);
+			value = line.substr(valueBegin, valueEnd - valueBegin);
+			return true;
+		});
+	}
+
+	/// True if a line of data is a "[song]" section header, optionally followed by a comment
+	inline bool iniSongSection(std::string_view data) {
+		using namespace detail;
+		constexpr std::string_view header = "[song]";
+		return anyLine(data, [&](std::size_t pos) {
+			pos = skipBlank(data, pos);
+			if (data.compare(pos, header.size(), header) != 0) return false;
+			pos = skipBlank(data, pos + header.size());
+			return pos == data.size() || isLineBreak(data[pos]) || data[pos] == ';' || data[pos] == '#';
+		});
+	}
+}
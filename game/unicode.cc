@@ -3,8 +3,11 @@
 #include "configuration.hh"
 #include "game.hh"
 #include "log.hh"
+#include "utf8.hh"
+#include "util.hh"
 
-#include <regex>
+#include <algorithm>
+#include <atomic>
 #include <stdexcept>
 #include <unicode/unistr.h>
 #include <unicode/ustream.h>
@@ -13,6 +16,7 @@
 
 std::unique_ptr<icu::RuleBasedCollator> UnicodeUtil::m_searchCollator;
 std::unique_ptr<icu::RuleBasedCollator> UnicodeUtil::m_sortCollator;
+unsigned UnicodeUtil::m_sortGeneration = 1;
 
 std::map<std::string, Converter> UnicodeUtil::m_converters{};
 std::mutex UnicodeUtil::m_convertersMutex;
@@ -36,12 +40,16 @@ icu::UnicodeString Converter::convertToUTF16(std::string_view sv) {
 
 Converter& UnicodeUtil::getConverter(std::string const& s) {
 	std::scoped_lock l{m_convertersMutex};
-	return m_converters.try_emplace(s, Converter(s)).first->second;
+	return m_converters.try_emplace(s, s).first->second;  // Only opens a new ICU converter the first time
 }
 
 std::string UnicodeUtil::getCharset (std::string_view& str) {
 	if (removeUTF8BOM(str)) 
 		return "UTF-8";
+	// Valid UTF-8 is taken as is, without running the (slow) detector. Escape characters are excluded because
+	// ISO-2022 encodings are 7-bit and would otherwise pass as ASCII.
+	if (utf8::isValid(str) && str.find('\x1B') == std::string_view::npos)
+		return "UTF-8";
 
 	int bytes_consumed;
 	bool is_reliable;
@@ -124,6 +132,11 @@ bool UnicodeUtil::removeUTF8BOM(std::string& str) {
 
 bool UnicodeUtil::caseEqual (std::string_view lhs, std::string_view rhs, bool assumeUTF8) {
 	if (lhs == rhs) return true; // Early return
+	if (utf8::isASCII(lhs) && utf8::isASCII(rhs)) {
+		// Simple case folding is all there is for ASCII
+		auto fold = [](char c) { return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c; };
+		return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), [&fold](char l, char r) { return fold(l) == fold(r); });
+	}
 	std::string lhsCharset = UnicodeUtil::getCharset(lhs);
 	std::string rhsCharset = UnicodeUtil::getCharset(rhs);;
 	icu::UnicodeString lhsUniString;
@@ -179,21 +192,42 @@ std::string UnicodeUtil::toTitle (std::string_view str) {
 	return convertToUTF8 (str, "", CaseMapping::TITLE);
 }
 
+namespace {
+	/// Snapshot of game/sorting_ignore, replaced by an observer when the setting changes (collate runs for every song
+	/// while loading, on the loader threads)
+	std::shared_ptr<ConfigItem::StringList const> sortingIgnore = std::make_shared<ConfigItem::StringList const>();
+}
+
+void UnicodeUtil::observeSortingIgnore() {
+	auto const update = [](ConfigItem const& item) {
+		std::atomic_store(&sortingIgnore, std::make_shared<ConfigItem::StringList const>(std::get<ConfigItem::StringList>(item.value())));
+		return true;
+	};
+	ConfigItem& item = config["game/sorting_ignore"];
+	update(item);
+	item.observe(update);
+}
+
 void UnicodeUtil::collate (songMetadata& stringmap) {
-	for (auto const& [key, value]: stringmap) { 
-		ConfigItem::StringList termsToCollate = config["game/sorting_ignore"].sl();
-		std::string pattern = std::string ("^((");
-		for (auto term : termsToCollate) {
-			if (term != termsToCollate.front()) {
-				pattern += std::string("|");
-			}
-			pattern += term;
-			if (term == termsToCollate.back()) {
-				pattern += std::string(")\\s(.+))$");
-			}
-		}
-		std::string collatedString = regex_replace(convertToUTF8(value),
-		std::regex(pattern, std::regex_constants::icase), "$3,$2");
-		stringmap[key] = collatedString;
+	auto const terms = std::atomic_load(&sortingIgnore);
+	for (auto& [key, value]: stringmap) value = moveLeadingWord(convertToUTF8(value), *terms);
+}
+
+void UnicodeUtil::setCaseSorting(bool caseSensitive) {
+	auto const strength = caseSensitive ? icu::Collator::TERTIARY : icu::Collator::SECONDARY;
+	if (m_sortCollator->getStrength() == strength) return;
+	m_sortCollator->setStrength(strength);
+	++m_sortGeneration;
+}
+
+std::string UnicodeUtil::sortKey(std::string_view str) {
+	icu::UnicodeString ustring = icu::UnicodeString::fromUTF8(icu::StringPiece(str.data(), static_cast<int32_t>(str.size())));
+	std::string key(str.size() * 2 + 16, '\0');
+	auto length = m_sortCollator->getSortKey(ustring, reinterpret_cast<uint8_t*>(key.data()), static_cast<int32_t>(key.size()));
+	if (static_cast<std::size_t>(length) > key.size()) {
+		key.resize(static_cast<std::size_t>(length));
+		length = m_sortCollator->getSortKey(ustring, reinterpret_cast<uint8_t*>(key.data()), length);
 	}
+	key.resize(length > 0 ? static_cast<std::size_t>(length) - 1 : 0);  // Drop the terminating zero byte
+	return key;
 }
@@ -45,6 +45,14 @@ class UnicodeUtil {
 	UnicodeUtil() = delete;
 	~UnicodeUtil() = delete;
 	static void collate (songMetadata& stringmap);
+	/// Follow game/sorting_ignore for collate; call on the main thread after readConfig
+	static void observeSortingIgnore();
+	/// Binary ICU sort key for UTF-8 str using m_sortCollator; keys compare with plain < in collation order
+	static std::string sortKey (std::string_view str);
+	/// Set the strength of m_sortCollator for game/case-sorting (main thread)
+	static void setCaseSorting(bool caseSensitive);
+	/// Changes whenever sort keys made before become invalid (another collator or case sorting)
+	static unsigned sortGeneration() { return m_sortGeneration; }
 	static std::string convertToUTF8 (std::string_view str, std::string _filename = std::string(), CaseMapping toCase = CaseMapping::NONE, bool assumeUTF8 = false);
 	static bool caseEqual (std::string_view lhs, std::string_view rhs, bool assumeUTF8 = false);
 	static bool isRTL(std::string_view str); ///< FIXME: This won't be used for now, but it might be useful if we eventually implement RTL translations. As-is, at least on my mac, Performous is refusing to render Arabic text, although it might be a font issue.
@@ -54,5 +62,6 @@ class UnicodeUtil {
 
 	static std::unique_ptr<icu::RuleBasedCollator> m_searchCollator;
 	static std::unique_ptr<icu::RuleBasedCollator> m_sortCollator;
+	static unsigned m_sortGeneration;  ///< Incremented when m_sortCollator is replaced or its strength changes
 	static std::mutex m_convertersMutex;
 };
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+/// Fast UTF-8 checks, used to skip charset detection for text that is already UTF-8 (almost all of it)
+namespace utf8 {
+	namespace detail {
+		constexpr std::uint64_t highBits = 0x8080808080808080ull;
+
+		/// Length of the 7-bit ASCII prefix of [begin, end), scanning eight bytes at a time
+		inline std::size_t asciiLength(unsigned char const* begin, unsigned char const* end) {
+			unsigned char const* it = begin;
+			for (std::uint64_t word; end - it >= 8; it += 8) {
+				std::memcpy(&word, it, 8);  // Unaligned load, compiles to a single instruction
+				if (word & highBits) break;
+			}
+			while (it != end && *it < 0x80) ++it;
+			return static_cast<std::size_t>(it - begin);
+		}
+
+		inline bool continuation(unsigned char c) { return (c & 0xC0) == 0x80; }
+	}
+
+	/// Returns true if all bytes are 7-bit ASCII (which is also valid UTF-8)
+	inline bool isASCII(std::string_view str) {
+		auto const* begin = reinterpret_cast<unsigned char const*>(str.data());
+		return detail::asciiLength(begin, begin + str.size()) == str.size();
+	}
+
+	/// Returns true if str is well-formed UTF-8: no stray or missing continuation bytes, overlong forms,
+	/// surrogates or code points above U+10FFFF. Text in legacy 8-bit encodings practically never passes.
+	inline bool isValid(std::string_view str) {
+		auto const* it = reinterpret_cast<unsigned char const*>(str.data());
+		auto const* end = it + str.size();
+		while (true) {
+			it += detail::asciiLength(it, end);
+			if (it == end) return true;
+			unsigned char const c = *it;
+			std::size_t const left = static_cast<std::size_t>(end - it);
+			// Allowed range of the second byte per lead byte (Unicode Standard, table 3-7)
+			if (c >= 0xC2 && c <= 0xDF) {
+				if (left < 2 || !detail::continuation(it[1])) return false;
+				it += 2;
+			} else if (c >= 0xE0 && c <= 0xEF) {
+				unsigned char const lo = (c == 0xE0) ? 0xA0 : 0x80;
+				unsigned char const hi = (c == 0xED) ? 0x9F : 0xBF;
+				if (left < 3 || it[1] < lo || it[1] > hi || !detail::continuation(it[2])) return false;
+				it += 3;
+			} else if (c >= 0xF0 && c <= 0xF4) {
+				unsigned char const lo = (c == 0xF0) ? 0x90 : 0x80;
+				unsigned char const hi = (c == 0xF4) ? 0x8F : 0xBF;
+				if (left < 4 || it[1] < lo || it[1] > hi || !detail::continuation(it[2]) || !detail::continuation(it[3])) return false;
+				it += 4;
+			} else {
+				return false;  // Continuation byte without a lead, or a lead byte that is never valid
+			}
+		}
+	}
+}
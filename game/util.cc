@@ -81,6 +81,20 @@ bool isASCII(char c) {
 	return static_cast<unsigned char>(c) >= 32 || std::isspace(static_cast<unsigned char>(c));
 }
 
+std::string moveLeadingWord(std::string const& s, std::vector<std::string> const& words) {
+	auto const lower = [](char c) { return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c; };
+	auto const space = [](char c) { return c == ' ' || (c >= '\t' && c <= '\r'); };
+	for (auto const& word: words) {
+		auto const size = word.size();
+		// Need the word, one whitespace character and a non-empty single line remainder
+		if (word.empty() || s.size() < size + 2 || !space(s[size])) continue;
+		if (!std::equal(word.begin(), word.end(), s.begin(), [&](char a, char b) { return lower(a) == lower(b); })) continue;
+		if (s.find_first_of("\n\r", size + 1) != std::string::npos) continue;
+		return s.substr(size + 1) + "," + s.substr(0, size);
+	}
+	return s;
+}
+
 bool isText(const std::string& text, size_t bytesToCheck) {
 	bytesToCheck = std::min(bytesToCheck, text.size());
 	for (size_t i = 0; i < bytesToCheck; ++i) {
@@ -54,6 +54,9 @@ struct UnlockGuard {
 std::uint32_t stou(std::string const & str, size_t * idx = nullptr, int base = 10);
 std::string timeFormat(std::chrono::seconds const& unixtime, std::string const& format, bool utc = false);
 std::string replaceFirst(std::string const& s, std::string const& from, std::string const& toB);
+/// Move a leading word (such as an article) to the end for sorting: "The Beatles" becomes "Beatles,The".
+/// Words are matched literally and ASCII case-insensitively and must be followed by whitespace and more text.
+std::string moveLeadingWord(std::string const& s, std::vector<std::string> const& words);
 
 bool isText(std::string const& s, size_t bytesToCheck = 32);
 
@@ -0,0 +1,101 @@
+#include "common.hh"
+
+#include "game/configvalue.hh"
+
+
+namespace {
+	ConfigItem makeVolume(unsigned short value) {
+		ConfigItem item(value);
+		item.m_min = static_cast<unsigned short>(0);
+		item.m_max = static_cast<unsigned short>(100);
+		item.m_step = static_cast<unsigned short>(1);
+		item.setDefaultValue(static_cast<unsigned short>(70));
+		return item;
+	}
+
+	/// A map with roughly as many items as the real config schema
+	ConfigItemMap makeItems() {
+		ConfigItemMap items;
+		for (auto const& group: { "audio", "game", "graphic", "paths", "system", "webserver" }) {
+			for (unsigned i = 0; i < 15; ++i) items[std::string(group) + "/setting_" + std::to_string(i)] = ConfigItem(static_cast<int>(i));
+		}
+		items["audio/music_volume"] = makeVolume(70);
+		items["audio/pass-through"] = ConfigItem(false);
+		items["audio/pass-through_ratio"] = ConfigItem(1.0f);
+		return items;
+	}
+}
+
+TEST(UnitTest_ConfigValue, reads_current_value) {
+	auto items = makeItems();
+	ConfigValue<unsigned short> volume("audio/music_volume", items);
+	ConfigValue<float> ratio("audio/pass-through_ratio", items);
+	EXPECT_EQ(70, volume.get());
+	EXPECT_EQ(1.0f, ratio);
+	EXPECT_EQ(&items["audio/music_volume"], &volume.item());
+}
+
+TEST(UnitTest_ConfigValue, follows_changes) {
+	auto items = makeItems();
+	ConfigValue<unsigned short> volume("audio/music_volume", items);
+	ConfigValue<bool> passThrough("audio/pass-through", items);
+	ConfigItem& item = items["audio/music_volume"];
+
+	++item;
+	EXPECT_EQ(71, volume.get());
+	--item;
+	--item;
+	EXPECT_EQ(69, volume.get());
+	item.setValue(static_cast<unsigned short>(30));
+	EXPECT_EQ(30, volume.get());
+	item.reset();
+	EXPECT_EQ(70, volume.get());
+	++items["audio/pass-through"];
+	EXPECT_TRUE(passThrough);
+
+	// Writing through a reference needs an explicit notification
+	item.ui() = 10;
+	EXPECT_EQ(70, volume.get());
+	item.notify();
+	EXPECT_EQ(10, volume.get());
+
+	// Assigning a whole item (as the menu does) keeps the observers
+	item = makeVolume(55);
+	item.notify();
+	EXPECT_EQ(55, volume.get());
+}
+
+TEST(UnitTest_ConfigValue, outlived_by_item) {
+	auto items = makeItems();
+	{
+		ConfigValue<unsigned short> volume("audio/music_volume", items);
+	}
+	ConfigValue<unsigned short> volume("audio/music_volume", items);
+	EXPECT_NO_THROW(++items["audio/music_volume"]);
+	EXPECT_EQ(71, volume.get());
+}
+
+TEST(UnitTest_ConfigValue, expired_observers_pruned_without_changes) {
+	auto items = makeItems();
+	auto& item = items["audio/music_volume"];
+	auto const tracker = std::make_shared<int>();
+	{
+		auto owner = std::make_shared<int>();
+		item.observe([tracker](ConfigItem const&) { return true; }, owner);
+		EXPECT_EQ(2, tracker.use_count());
+	}
+	// Registering another observer drops the expired one, although the value never changed
+	ConfigValue<unsigned short> volume("audio/music_volume", items);
+	EXPECT_EQ(1, tracker.use_count());
+	// Observers without an owner stay until they unregister themselves
+	item.observe([tracker](ConfigItem const&) { return true; });
+	ConfigValue<unsigned short> other("audio/music_volume", items);
+	EXPECT_EQ(2, tracker.use_count());
+}
+
+TEST(UnitTest_ConfigValue, errors) {
+	auto items = makeItems();
+	EXPECT_THROW(ConfigValue<bool>("audio/no_such_setting", items), std::logic_error);
+	EXPECT_THROW(ConfigValue<float>("audio/music_volume", items), std::logic_error);
+	EXPECT_THROW(ConfigValue<int>("audio/pass-through", items), std::logic_error);
+}
@@ -0,0 +1,92 @@
+#include "common.hh"
+#include "offscreengl.hh"
+
+#include "game/configuration.hh"
+#include "game/graphic/frame_capture.hh"
+
+#include <fmt/format.h>
+
+#include <chrono>
+#include <fstream>
+#include <thread>
+
+namespace {
+	unsigned const width = 64;
+	unsigned const height = 32;
+
+	struct UnitTest_FrameCapture : public testing::Test {
+		void SetUp() override {
+			if (!gl.ok()) GTEST_SKIP() << "No OpenGL context: " << gl.error();
+			if (config.find("graphic/capture_fps") == config.end()) config["graphic/capture_fps"] = ConfigItem(static_cast<unsigned short>(30));
+			if (config.find("graphic/capture_ffmpeg") == config.end()) config["graphic/capture_ffmpeg"] = ConfigItem(false);
+			fs::remove_all(folder);
+			fs::create_directories(folder);
+		}
+		void TearDown() override { fs::remove_all(folder); }
+		/// Fill the bottom half with bottom and the top half with top, as one rendered frame
+		void render(unsigned char bottom, unsigned char top) {
+			glEnable(GL_SCISSOR_TEST);
+			GLsizei const w = width, h = height / 2;
+			glScissor(0, 0, w, h);
+			glClearColor(bottom / 255.0f, 0.0f, 0.0f, 1.0f);
+			glClear(GL_COLOR_BUFFER_BIT);
+			glScissor(0, h, w, h);
+			glClearColor(top / 255.0f, 0.0f, 0.0f, 1.0f);
+			glClear(GL_COLOR_BUFFER_BIT);
+			glDisable(GL_SCISSOR_TEST);
+		}
+		/// Red channel of the first pixel of the top and of the bottom row of a PNG file
+		static std::pair<unsigned, unsigned> topAndBottom(fs::path const& file) {
+			Bitmap bitmap;
+			loadPNG(bitmap, file);
+			EXPECT_EQ(width, bitmap.width);
+			EXPECT_EQ(height, bitmap.height);
+			std::size_t const row = bitmap.buf.size() / height;
+			return { bitmap.data()[0], bitmap.data()[(height - 1) * row] };
+		}
+		OffscreenGL gl{ width, height };
+		fs::path const folder = fs::temp_directory_path() / "performous_framecapturetest";
+	};
+}
+
+TEST_F(UnitTest_FrameCapture, screenshot) {
+	std::ofstream(folder / "Performous_7.mp4");  // Numbering continues after files already there
+	{
+		FrameCapture capture(folder);
+		render(10, 200);
+		capture.screenshot();
+		capture.frame(width, height);
+		render(50, 50);
+		capture.frame(width, height);  // Only the frame after screenshot() is saved
+	}
+	ASSERT_TRUE(fs::exists(folder / "Performous_8.png"));
+	EXPECT_FALSE(fs::exists(folder / "Performous_9.png"));
+	auto const [top, bottom] = topAndBottom(folder / "Performous_8.png");
+	EXPECT_EQ(200u, top);  // The image is stored top row first
+	EXPECT_EQ(10u, bottom);
+}
+
+TEST_F(UnitTest_FrameCapture, recording_image_sequence) {
+	config["graphic/capture_fps"].ui() = 1000;
+	config["graphic/capture_ffmpeg"].b() = false;
+	unsigned const frames = 6;
+	{
+		FrameCapture capture(folder);
+		EXPECT_TRUE(capture.toggleRecording());
+		for (unsigned i = 0; i < frames; ++i) {
+			render(static_cast<unsigned char>(20 * i), static_cast<unsigned char>(20 * i + 10));
+			glFinish();  // Readbacks complete before the next frame, so none are dropped for busy buffers
+			capture.frame(width, height);
+			std::this_thread::sleep_for(std::chrono::milliseconds(2));  // Due at 1000 FPS
+		}
+		EXPECT_FALSE(capture.toggleRecording());
+	}
+	fs::path const sequence = folder / "Performous_1";
+	ASSERT_TRUE(fs::is_directory(sequence));
+	for (unsigned i = 0; i < frames; ++i) {
+		auto const [top, bottom] = topAndBottom(sequence / fmt::format("frame_{:06}.png", i + 1));
+		EXPECT_EQ(20 * i + 10, top) << i;
+		EXPECT_EQ(20 * i, bottom) << i;
+	}
+	EXPECT_FALSE(fs::exists(sequence / fmt::format("frame_{:06}.png", frames + 1)));
+}
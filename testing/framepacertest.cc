@@ -0,0 +1,154 @@
+#include "common.hh"
+
+#include "game/framepacer.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace {
+	/// A clock that only advances when told to
+	struct FakeClock {
+		Time now{};
+		void advance(double seconds) { now += clockDur(Seconds(seconds)); }
+		void sleepUntil(Time t) { if (t > now) now = t; }
+	};
+
+	double ms(Clock::duration d) { return Seconds(d).count() * 1000.0; }
+
+	FramePacer::Settings settings(double refreshRate, bool vsync, double maxFps = 0.0, bool lateLatch = false, int maxSwapInterval = 0) {
+		FramePacer::Settings s;
+		s.refreshRate = refreshRate;
+		s.vsync = vsync;
+		s.maxFps = maxFps;
+		s.lateLatch = lateLatch;
+		s.maxSwapInterval = maxSwapInterval;
+		return s;
+	}
+
+	/// A display that shows a new frame on each vsync; a swap waits for the first vsync after the frame is done
+	struct FakeDisplay {
+		FakeClock& clock;
+		double refreshRate;
+		int swapInterval = 1;
+		long lastVsync = 0;
+		void swap() {
+			long vsync = static_cast<long>(std::ceil(Seconds(clock.now.time_since_epoch()).count() * refreshRate - 1e-6));
+			vsync = std::max(vsync, lastVsync + swapInterval);
+			clock.sleepUntil(Time(clockDur(Seconds(static_cast<double>(vsync) / refreshRate))));
+			lastVsync = vsync;
+		}
+	};
+}
+
+TEST(UnitTest_FrameHistogram, percentiles) {
+	FrameHistogram histogram;
+	EXPECT_EQ(0.0, histogram.percentile(0.5));
+	for (int i = 0; i < 98; ++i) histogram.add(0.0166, false);
+	histogram.add(0.0333, true);
+	histogram.add(1.0, true);  // Longer than the histogram, counted in the last bin
+	EXPECT_EQ(100u, histogram.frames());
+	EXPECT_EQ(2u, histogram.missed());
+	EXPECT_NEAR(0.0166, histogram.percentile(0.50), 0.00025);
+	EXPECT_NEAR(0.0166, histogram.percentile(0.95), 0.00025);
+	EXPECT_NEAR(0.0333, histogram.percentile(0.99), 0.00025);
+	EXPECT_NEAR(0.1, histogram.percentile(1.0), 0.00025);
+}
+
+TEST(UnitTest_FramePacer, swap_interval) {
+	EXPECT_EQ(0, FramePacer(settings(60.0, false)).swapInterval());
+	EXPECT_EQ(1, FramePacer(settings(60.0, true)).swapInterval());
+	EXPECT_EQ(1, FramePacer(settings(60.0, true, 100.0)).swapInterval());  // Limited by the display
+	EXPECT_EQ(2, FramePacer(settings(120.0, true, 60.0)).swapInterval());
+	EXPECT_EQ(3, FramePacer(settings(144.0, true, 48.0)).swapInterval());
+	EXPECT_EQ(1, FramePacer(settings(144.0, true, 100.0)).swapInterval());  // Paced by sleeping instead
+	EXPECT_DOUBLE_EQ(1.0 / 60.0, FramePacer(settings(120.0, true, 60.0)).period());
+	EXPECT_DOUBLE_EQ(1.0 / 100.0, FramePacer(settings(144.0, true, 100.0)).period());
+}
+
+/// A driver that only swaps on every vsync still reaches a lower target rate, the pacer skips vsyncs by sleeping
+TEST(UnitTest_FramePacer, swap_interval_not_supported) {
+	FakeClock clock;
+	FakeDisplay display{ clock, 120.0 };
+	FramePacer pacer(settings(120.0, true, 60.0, false, 1));
+	EXPECT_EQ(1, pacer.swapInterval());
+	EXPECT_DOUBLE_EQ(1.0 / 60.0, pacer.period());
+	for (int i = 0; i < 100; ++i) {
+		clock.sleepUntil(pacer.wakeUp(clock.now));
+		pacer.begin(clock.now);
+		clock.advance(0.003);
+		pacer.rendered(clock.now);
+		display.swap();
+		pacer.presented(clock.now, "Test");
+	}
+	auto const& histogram = pacer.histogram("Test");
+	EXPECT_EQ(0u, histogram.missed());
+	EXPECT_NEAR(1.0 / 60.0, histogram.percentile(0.50), 0.0005);
+	EXPECT_NEAR(1.0 / 60.0, histogram.percentile(0.99), 0.0005);
+}
+
+/// Without vsync, frames start on a fixed grid whatever their processing takes, and a stall does not cause a burst
+TEST(UnitTest_FramePacer, fixed_rate_without_vsync) {
+	FakeClock clock;
+	FramePacer pacer(settings(60.0, false, 100.0));
+	std::vector<Time> starts;
+	for (int i = 0; i < 100; ++i) {
+		clock.sleepUntil(pacer.wakeUp(clock.now));
+		pacer.begin(clock.now);
+		starts.push_back(clock.now);
+		clock.advance(i == 50 ? 0.035 : 0.002 + 0.001 * (i % 5));  // One frame stalls
+		pacer.rendered(clock.now);
+		pacer.presented(clock.now, "Test");
+	}
+	for (std::size_t i = 1; i < starts.size(); ++i) {
+		if (i == 51) EXPECT_NEAR(35.0, ms(starts[i] - starts[i - 1]), 0.01);
+		else EXPECT_NEAR(10.0, ms(starts[i] - starts[i - 1]), 0.01) << i;
+	}
+	auto const& histogram = pacer.histogram("Test");
+	EXPECT_EQ(99u, histogram.frames());
+	EXPECT_EQ(1u, histogram.missed());
+	// Presents jitter by as much as the processing time varies
+	EXPECT_NEAR(0.010, histogram.percentile(0.50), 0.0015);
+	EXPECT_LT(histogram.percentile(0.95), 0.015);
+}
+
+/// With vsync the swap paces the frames; late latching starts them as late as recent frames allow without missing any
+TEST(UnitTest_FramePacer, late_latching_with_vsync) {
+	for (bool lateLatch: { false, true }) {
+		FakeClock clock;
+		FakeDisplay display{ clock, 60.0 };
+		FramePacer pacer(settings(60.0, true, 0.0, lateLatch));
+		double latency = 0.0;  // From the start of a frame (reading the audio clock) until it is shown
+		for (int i = 0; i < 200; ++i) {
+			clock.sleepUntil(pacer.wakeUp(clock.now));
+			pacer.begin(clock.now);
+			Time const start = clock.now;
+			clock.advance(0.004 + 0.0005 * (i % 3));
+			pacer.rendered(clock.now);
+			display.swap();
+			pacer.presented(clock.now, "Sing");
+			if (i >= 100) latency = std::max(latency, Seconds(clock.now - start).count());
+		}
+		auto const& histogram = pacer.histogram("Sing");
+		EXPECT_EQ(0u, histogram.missed());
+		EXPECT_NEAR(1.0 / 60.0, histogram.percentile(0.99), 0.0005);
+		if (lateLatch) EXPECT_LT(latency, 0.007);
+		else EXPECT_GT(latency, 0.016);
+	}
+}
+
+TEST(UnitTest_FramePacer, report_per_screen) {
+	FakeClock clock;
+	FramePacer pacer(settings(60.0, false));
+	for (int i = 0; i < 10; ++i) {
+		clock.advance(i < 5 ? 0.0101 : 0.0501);
+		pacer.presented(clock.now, i < 5 ? "Songs" : "Sing");
+	}
+	EXPECT_EQ(4u, pacer.histogram("Songs").frames());
+	EXPECT_EQ(0u, pacer.histogram("Songs").missed());
+	EXPECT_EQ(5u, pacer.histogram("Sing").frames());
+	EXPECT_EQ(5u, pacer.histogram("Sing").missed());
+	// Percentiles are rounded up to the quarter millisecond
+	EXPECT_EQ("Sing: frames=5, p50=50.25 ms, p95=50.25 ms, p99=50.25 ms, missed=5\n"
+	  "Songs: frames=4, p50=10.25 ms, p95=10.25 ms, p99=10.25 ms, missed=0\n", pacer.report());
+}
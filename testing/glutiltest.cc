@@ -0,0 +1,192 @@
+#include "common.hh"
+#include "offscreengl.hh"
+
+#include "game/graphic/glutil.hh"
+#include "game/graphic/window.hh"
+
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+namespace {
+	/// A triangle strip of n vertices zigzagging to the right from x0, all of its triangles with the same winding
+	glutil::VertexArray zigzag(unsigned n, float x0) {
+		glutil::VertexArray va;
+		for (unsigned i = 0; i < n; ++i) va.vertex(x0 + static_cast<float>(i), i % 2 ? 1.0f : 0.0f);
+		return va;
+	}
+
+	/// Signed areas of the triangles of a strip as OpenGL draws them: every other triangle has its first two vertices
+	/// swapped, so that all triangles of a strip have the same winding
+	std::vector<float> triangles(glutil::VertexArray const& va) {
+		std::vector<float> areas;
+		auto const* v = va.data();
+		for (GLsizei i = 0; i + 2 < va.size(); ++i) {
+			auto const& a = v[i % 2 ? i + 1 : i].vertPos;
+			auto const& b = v[i % 2 ? i : i + 1].vertPos;
+			auto const& c = v[i + 2].vertPos;
+			areas.push_back((b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x));
+		}
+		return areas;
+	}
+
+	/// The buffers of the window and a shader that draws both ways, like the texture and texture_instanced shaders
+	/// (the instance attributes are disabled without instancing, so that each vertex gets the same default instance)
+	struct UnitTest_DrawCalls : public testing::Test {
+		static constexpr unsigned size = 64;
+		static constexpr unsigned grid = 8;  ///< Quads per row and column
+		void SetUp() override {
+			if (!gl.ok()) GTEST_SKIP() << "No OpenGL context: " << gl.error();
+			Window::initBuffers();
+			char const* vertex = "#version 330 core\n"
+			  "layout(location = 0) in vec3 vertPos;\n"
+			  "layout(location = 3) in vec4 vertColor;\n"
+			  "layout(location = 4) in vec4 instPosition;\n"
+			  "layout(location = 5) in vec4 instColor;\n"
+			  "out vec4 color;\n"
+			  "void main() { gl_Position = vec4(instPosition.xyz + instPosition.w * vertPos, 1.0); color = vertColor * instColor; }\n";
+			char const* fragment = "#version 330 core\n"
+			  "in vec4 color;\n"
+			  "out vec4 fragColor;\n"
+			  "void main() { fragColor = color; }\n";
+			program = glCreateProgram();
+			for (auto [type, source]: { std::pair{ GLenum(GL_VERTEX_SHADER), vertex }, std::pair{ GLenum(GL_FRAGMENT_SHADER), fragment } }) {
+				GLuint shader = glCreateShader(type);
+				glShaderSource(shader, 1, &source, nullptr);
+				glCompileShader(shader);
+				glAttachShader(program, shader);
+				glDeleteShader(shader);
+			}
+			glLinkProgram(program);
+			GLint linked = GL_FALSE;
+			glGetProgramiv(program, GL_LINK_STATUS, &linked);
+			ASSERT_EQ(GL_TRUE, linked);
+			glUseProgram(program);
+			glVertexAttrib4f(Window::instancePosition, 0.0f, 0.0f, 0.0f, 1.0f);
+			glVertexAttrib4f(Window::instanceColor, 1.0f, 1.0f, 1.0f, 1.0f);
+			glutil::VertexArray::drawCalls();  // Reset the counter
+		}
+		void TearDown() override {
+			if (!gl.ok()) return;
+			glDeleteProgram(program);
+			Window::deleteBuffers();
+		}
+		/// Position (lower left corner) and color of quad i of the grid
+		static glmath::vec2 corner(unsigned i) {
+			float const step = 2.0f / grid;
+			return glmath::vec2(-1.0f + step * static_cast<float>(i % grid), -1.0f + step * static_cast<float>(i / grid));
+		}
+		static glmath::vec4 color(unsigned i) {
+			return glmath::vec4(static_cast<float>(i % grid) / grid, static_cast<float>(i / grid) / grid, 1.0f, 1.0f);
+		}
+		/// Unit square at (x, y) scaled by s
+		static glutil::VertexArray quad(float x = 0.0f, float y = 0.0f, float s = 1.0f, glmath::vec4 const& c = glmath::vec4(1.0f)) {
+			glutil::VertexArray va;
+			va.color(c).vertex(x, y);
+			va.color(c).vertex(x + s, y);
+			va.color(c).vertex(x, y + s);
+			va.color(c).vertex(x + s, y + s);
+			return va;
+		}
+		std::vector<unsigned char> pixels() {
+			std::vector<unsigned char> rgba(size * size * 4);
+			glReadPixels(0, 0, size, size, GL_RGBA, GL_UNSIGNED_BYTE, rgba.data());
+			return rgba;
+		}
+		OffscreenGL gl{ size, size };
+		GLuint program = 0;
+	};
+}
+
+TEST(UnitTest_VertexArray, strip_joins_with_degenerate_triangles) {
+	float const winding = triangles(zigzag(3, 0.0f)).front();
+	ASSERT_NE(0.0f, winding);
+	for (unsigned first: { 3u, 4u, 5u, 6u }) {
+		for (unsigned second: { 3u, 4u, 7u }) {
+			glutil::VertexArray joined = zigzag(first, 0.0f);
+			joined.strip(zigzag(second, 100.0f));
+			// Two repeated vertices, and a third one after an odd length
+			EXPECT_EQ(static_cast<GLsizei>(first + second + (first % 2 ? 3 : 2)), joined.size()) << first << "+" << second;
+			unsigned visible = 0;
+			for (float area: triangles(joined)) {
+				if (area == 0.0f) continue;  // Degenerate, not drawn
+				++visible;
+				EXPECT_EQ(winding, area) << first << "+" << second;  // Facing the same way as in the separate strips
+			}
+			EXPECT_EQ(first - 2 + second - 2, visible) << first << "+" << second;
+		}
+	}
+}
+
+TEST(UnitTest_VertexArray, strip_of_many_and_empty) {
+	glutil::VertexArray joined;
+	joined.strip(glutil::VertexArray());
+	EXPECT_TRUE(joined.empty());
+	joined.strip(zigzag(5, 0.0f));
+	EXPECT_EQ(5, joined.size());  // Nothing to join to
+	joined.strip(glutil::VertexArray());
+	EXPECT_EQ(5, joined.size());
+	for (unsigned i = 1; i <= 10; ++i) joined.strip(zigzag(3 + i % 4, 10.0f * static_cast<float>(i)));
+	float const winding = triangles(zigzag(3, 0.0f)).front();
+	unsigned visible = 0, expected = 3;
+	for (unsigned i = 1; i <= 10; ++i) expected += 1 + i % 4;
+	for (float area: triangles(joined)) {
+		if (area == 0.0f) continue;
+		++visible;
+		EXPECT_EQ(winding, area);
+	}
+	EXPECT_EQ(expected, visible);
+}
+
+TEST(UnitTest_InstanceArray, packing) {
+	// Four vec4 attributes per instance, tightly packed in the order of locations 4 to 7 of instanced.vert
+	EXPECT_EQ(static_cast<GLsizei>(16 * sizeof(float)), glutil::InstanceArray::stride());
+	EXPECT_EQ(0u, offsetof(glutil::InstanceInfo, instPosition));
+	EXPECT_EQ(4 * sizeof(float), offsetof(glutil::InstanceInfo, instColor));
+	EXPECT_EQ(8 * sizeof(float), offsetof(glutil::InstanceInfo, instTexRect));
+	EXPECT_EQ(12 * sizeof(float), offsetof(glutil::InstanceInfo, instParams));
+	glutil::InstanceArray instances;
+	EXPECT_TRUE(instances.empty());
+	instances.add(1.0f, 2.0f);
+	auto& second = instances.add(3.0f, 4.0f, 5.0f, 0.5f);
+	second.instColor = glmath::vec4(0.25f);
+	second.instTexRect = glmath::vec4(0.5f, 0.0f, 0.5f, 1.0f);
+	second.instParams.x = 1.5f;
+	ASSERT_EQ(2, instances.size());
+	// As the GPU reads the buffer
+	std::vector<float> buffer(static_cast<std::size_t>(instances.size() * glutil::InstanceArray::stride()) / sizeof(float));
+	std::memcpy(buffer.data(), instances.data(), buffer.size() * sizeof(float));
+	EXPECT_THAT(buffer, testing::ElementsAreArray({
+	  1.0f, 2.0f, 0.0f, 1.0f,  1.0f, 1.0f, 1.0f, 1.0f,  0.0f, 0.0f, 1.0f, 1.0f,  0.0f, 0.0f, 0.0f, 0.0f,
+	  3.0f, 4.0f, 5.0f, 0.5f,  0.25f, 0.25f, 0.25f, 0.25f,  0.5f, 0.0f, 0.5f, 1.0f,  1.5f, 0.0f, 0.0f, 0.0f }));
+	instances.clear();
+	EXPECT_TRUE(instances.empty());
+}
+
+TEST_F(UnitTest_DrawCalls, instanced_draws_the_same_in_one_call) {
+	float const step = 2.0f / grid;
+	glClear(GL_COLOR_BUFFER_BIT);
+	for (unsigned i = 0; i < grid * grid; ++i) quad(corner(i).x, corner(i).y, step, color(i)).draw();
+	EXPECT_EQ(grid * grid, glutil::VertexArray::drawCalls());
+	auto const separate = pixels();
+
+	glClear(GL_COLOR_BUFFER_BIT);
+	glutil::InstanceArray instances;
+	for (unsigned i = 0; i < grid * grid; ++i) instances.add(corner(i).x, corner(i).y, 0.0f, step).instColor = color(i);
+	quad().draw(instances);
+	EXPECT_EQ(1u, glutil::VertexArray::drawCalls());
+	auto const instanced = pixels();
+
+	EXPECT_EQ(static_cast<GLenum>(GL_NO_ERROR), glGetError());
+	// The last quad is at the top right corner
+	std::size_t const topRight = (size * size - 1) * 4;
+	EXPECT_EQ(255, separate[topRight + 2]);
+	EXPECT_EQ(separate, instanced);
+}
+
+TEST_F(UnitTest_DrawCalls, nothing_to_draw) {
+	glutil::VertexArray().draw();
+	glutil::InstanceArray instances;
+	quad().draw(instances);
+	EXPECT_EQ(0u, glutil::VertexArray::drawCalls());
+}
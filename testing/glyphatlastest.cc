@@ -0,0 +1,63 @@
+#include "common.hh"
+
+#include "game/graphic/glyph_atlas.hh"
+
+#include <cmath>
+#include <random>
+
+namespace {
+	PangoRectangle ink(float x, float y, float width, float height) {
+		auto const units = [](float pixels) { return static_cast<int>(pixels * PANGO_SCALE); };
+		return { units(x), units(y), units(width), units(height) };
+	}
+}
+
+TEST(UnitTest_GlyphAtlas, bounds) {
+	// A glyph 8 px wide rising 10 px above the baseline, one pixel of margin for antialiasing
+	auto cell = GlyphAtlas::bounds(ink(0.0f, -10.0f, 8.0f, 10.0f), 0.0f);
+	EXPECT_EQ(-1.0f, cell.left);
+	EXPECT_EQ(-11.0f, cell.top);
+	EXPECT_EQ(10.0f, cell.w);
+	EXPECT_EQ(12.0f, cell.h);
+	// Half of a 3 px outline is outside of the ink
+	cell = GlyphAtlas::bounds(ink(0.0f, -10.0f, 8.0f, 10.0f), 3.0f);
+	EXPECT_EQ(-3.0f, cell.left);
+	EXPECT_EQ(-13.0f, cell.top);
+	EXPECT_EQ(14.0f, cell.w);
+	EXPECT_EQ(16.0f, cell.h);
+	// Whole pixels around ink that is not pixel aligned
+	cell = GlyphAtlas::bounds(ink(0.5f, 0.25f, 1.0f, 1.0f), 0.0f);
+	EXPECT_EQ(-1.0f, cell.left);
+	EXPECT_EQ(-1.0f, cell.top);
+	EXPECT_EQ(4.0f, cell.w);
+	EXPECT_EQ(4.0f, cell.h);
+}
+
+TEST(UnitTest_GlyphAtlas, bounds_of_nothing_to_draw) {
+	auto const cell = GlyphAtlas::bounds(ink(3.0f, 0.0f, 0.0f, 0.0f), 2.0f);  // A space
+	EXPECT_EQ(0.0f, cell.w);
+	EXPECT_EQ(0.0f, cell.h);
+}
+
+TEST(UnitTest_GlyphAtlas, bounds_cover_ink_and_outline) {
+	std::mt19937 random(1);
+	std::uniform_int_distribution<int> position(-40 * PANGO_SCALE, 40 * PANGO_SCALE), size(1, 40 * PANGO_SCALE);
+	std::uniform_real_distribution<float> outline(0.0f, 6.0f);
+	for (int i = 0; i < 1000; ++i) {
+		PangoRectangle const rect{ position(random), position(random), size(random), size(random) };
+		float const width = outline(random);
+		auto const cell = GlyphAtlas::bounds(rect, width);
+		float const margin = 0.5f * width + 1.0f;
+		float const x1 = static_cast<float>(rect.x) / PANGO_SCALE, x2 = static_cast<float>(rect.x + rect.width) / PANGO_SCALE;
+		float const y1 = static_cast<float>(rect.y) / PANGO_SCALE, y2 = static_cast<float>(rect.y + rect.height) / PANGO_SCALE;
+		// Whole pixels, covering the ink and the margin but not more than one extra pixel on each side
+		EXPECT_EQ(std::floor(cell.left), cell.left);
+		EXPECT_EQ(std::floor(cell.w), cell.w);
+		EXPECT_LE(cell.left, x1 - margin);
+		EXPECT_GT(cell.left, x1 - margin - 1.0f);
+		EXPECT_GE(cell.left + cell.w, x2 + margin);
+		EXPECT_LT(cell.left + cell.w, x2 + margin + 1.0f);
+		EXPECT_LE(cell.top, y1 - margin);
+		EXPECT_GE(cell.top + cell.h, y2 + margin);
+	}
+}
@@ -0,0 +1,116 @@
+#include "common.hh"
+
+#include "game/image.hh"
+
+#include <cstring>
+
+namespace {
+	fs::path tempFile(std::string const& name) {
+		return fs::temp_directory_path() / ("performous-unittest-" + name);
+	}
+
+	/// A premultiplied test image resembling a rasterized theme SVG
+	Bitmap makeBitmap(unsigned width, unsigned height) {
+		Bitmap bitmap;
+		bitmap.fmt = pix::Format::CHAR_RGBA;
+		bitmap.linearPremul = true;
+		bitmap.resize(width, height);
+		for (unsigned y = 0; y < height; ++y) {
+			for (unsigned x = 0; x < width; ++x) {
+				unsigned char* p = &bitmap.buf[(y * width + x) * 4];
+				p[3] = static_cast<unsigned char>((x ^ y) & 0xFF);
+				p[0] = static_cast<unsigned char>(x * p[3] / 255 % 256);
+				p[1] = static_cast<unsigned char>(y * p[3] / 255 % 256);
+				p[2] = static_cast<unsigned char>(p[3] / 2);
+			}
+		}
+		return bitmap;
+	}
+}
+
+TEST(UnitTest_Image, argbToRgba) {
+	// Cairo ARGB32 pixels are stored as native-endian 32-bit integers
+	std::uint32_t const argb[] = { 0x80112233u, 0xFF000000u, 0x00FFFFFFu, 0x12345678u, 0xAABBCCDDu };
+	std::vector<unsigned char> data(sizeof(argb));
+	std::memcpy(data.data(), argb, sizeof(argb));
+
+	argbToRgba(data.data(), 5);
+
+	EXPECT_THAT(data, ElementsAre(
+		0x11, 0x22, 0x33, 0x80,
+		0x00, 0x00, 0x00, 0xFF,
+		0xFF, 0xFF, 0xFF, 0x00,
+		0x34, 0x56, 0x78, 0x12,
+		0xBB, 0xCC, 0xDD, 0xAA));
+}
+
+TEST(UnitTest_Image, raw_roundtrip) {
+	auto const filename = tempFile("roundtrip.raw");
+	Bitmap const original = makeBitmap(37, 11);
+
+	writeRAW(filename, original, 1234567890123);
+	Bitmap loaded;
+	EXPECT_EQ(1234567890123, loadRAW(loaded, filename));
+
+	EXPECT_EQ(original.width, loaded.width);
+	EXPECT_EQ(original.height, loaded.height);
+	EXPECT_EQ(original.fmt, loaded.fmt);
+	EXPECT_TRUE(loaded.linearPremul);
+	EXPECT_FLOAT_EQ(original.ar, loaded.ar);
+	EXPECT_NE(nullptr, loaded.ptr);
+	EXPECT_EQ(0, std::memcmp(original.data(), loaded.data(), original.buf.size()));
+
+	// The mapping must survive being swapped into another bitmap (as done by the texture loader)
+	Bitmap target;
+	target.swap(loaded);
+	EXPECT_EQ(0, std::memcmp(original.data(), target.data(), original.buf.size()));
+	target = Bitmap();
+	fs::remove(filename);
+}
+
+TEST(UnitTest_Image, raw_truncated) {
+	auto const filename = tempFile("truncated.raw");
+	writeRAW(filename, makeBitmap(16, 16));
+	fs::resize_file(filename, fs::file_size(filename) - 1);
+
+	Bitmap loaded;
+	EXPECT_THROW(loadRAW(loaded, filename), std::runtime_error);
+	fs::remove(filename);
+}
+
+/// SVGs come from the memory-mapped RAW cache when they are loaded as cover thumbnails
+TEST(UnitTest_Image, svg_thumbnail_from_raw_cache) {
+	auto const filename = tempFile("thumbnail.raw");
+	Bitmap original = makeBitmap(64, 32);
+	writeRAW(filename, original);
+	Bitmap loaded;
+	loadRAW(loaded, filename);
+	ASSERT_NE(nullptr, loaded.ptr);
+
+	loaded.downscale(16);
+	original.downscale(16);
+	EXPECT_EQ(nullptr, loaded.ptr);
+	EXPECT_EQ(16u, loaded.width);
+	EXPECT_EQ(8u, loaded.height);
+	EXPECT_FLOAT_EQ(2.0f, loaded.ar);
+	ASSERT_EQ(original.buf.size(), loaded.buf.size());
+	EXPECT_EQ(0, std::memcmp(original.data(), loaded.data(), original.buf.size()));
+	fs::remove(filename);  // The thumbnail no longer refers to the file
+	EXPECT_EQ(original.buf, loaded.buf);
+}
+
+TEST(UnitTest_Image, png_and_raw_cache_load_the_same) {
+	Bitmap const original = makeBitmap(192, 108);
+	auto const png = tempFile("cache.premul.png");
+	auto const raw = tempFile("cache.premul.raw");
+	writePNG(png, original);
+	writeRAW(raw, original);
+	Bitmap fromPNG, fromRAW;
+	loadPNG(fromPNG, png);
+	loadRAW(fromRAW, raw);
+	EXPECT_EQ(original.buf, fromPNG.buf);
+	ASSERT_NE(nullptr, fromRAW.ptr);
+	EXPECT_EQ(0, std::memcmp(original.data(), fromRAW.data(), original.buf.size()));
+	fs::remove(png);
+	fs::remove(raw);
+}
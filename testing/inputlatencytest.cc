@@ -0,0 +1,156 @@
+#include "common.hh"
+
+#include "game/controllers.hh"
+#include "game/mpscqueue.hh"
+#include "game/profiler.hh"
+
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+TEST(UnitTest_MpscQueue, fifo_and_full) {
+	MpscQueue<int> queue(3);
+	EXPECT_EQ(4u, queue.capacity());
+	int value = 0;
+	EXPECT_FALSE(queue.pop(value));
+	for (int i = 0; i < 4; ++i) EXPECT_TRUE(queue.push(i));
+	EXPECT_FALSE(queue.push(4));
+	for (int i = 0; i < 4; ++i) {
+		ASSERT_TRUE(queue.pop(value));
+		EXPECT_EQ(i, value);
+	}
+	EXPECT_FALSE(queue.pop(value));
+	EXPECT_TRUE(queue.push(5));  // Wrapped around
+	ASSERT_TRUE(queue.pop(value));
+	EXPECT_EQ(5, value);
+}
+
+TEST(UnitTest_MpscQueue, many_producers_keep_their_order) {
+	unsigned const producers = 4;
+	std::uint64_t const perProducer = 50000;
+	MpscQueue<std::uint64_t> queue(256);
+	std::vector<std::thread> threads;
+	for (std::uint64_t p = 0; p < producers; ++p) {
+		threads.emplace_back([&queue, p, perProducer] {
+			for (std::uint64_t i = 0; i < perProducer; ++i) while (!queue.push(p << 32 | i)) std::this_thread::yield();
+		});
+	}
+	std::vector<std::uint64_t> next(producers);
+	std::uint64_t received = 0;
+	while (received < producers * perProducer) {
+		std::uint64_t value;
+		if (!queue.pop(value)) { std::this_thread::yield(); continue; }
+		auto const p = value >> 32;
+		ASSERT_LT(p, producers);
+		ASSERT_EQ(next[p], value & 0xFFFFFFFF);
+		++next[p];
+		++received;
+	}
+	for (auto& t: threads) t.join();
+	EXPECT_THAT(next, testing::Each(perProducer));
+}
+
+TEST(UnitTest_InputLatency, capture_song_time) {
+	Time const frame = Clock::now();
+	input::Event ev;
+	EXPECT_DOUBLE_EQ(10.0, input::captureSongTime(ev, 10.0, frame));  // Not stamped
+	ev.time = frame - 12ms;
+	EXPECT_NEAR(9.988, input::captureSongTime(ev, 10.0, frame), 1e-9);
+	ev.time = frame + 3ms;  // Clock read after the frame
+	EXPECT_DOUBLE_EQ(10.0, input::captureSongTime(ev, 10.0, frame));
+	ev.time = frame - 2s;
+	EXPECT_NEAR(10.0 - input::maxEventAge.count(), input::captureSongTime(ev, 10.0, frame), 1e-9);
+}
+
+namespace {
+	/// A drum kit backend reading hits on a thread of its own, like the MIDI backend: it hits a cymbal at random moments,
+	/// stamps each event when it is captured and pushes it to the queue of Controllers. The events are numbered in hw.
+	struct FakeDrums: input::Hardware {
+		static input::SourceId source() { return input::SourceId(input::SourceType::MIDI, 0, 10); }
+		FakeDrums(input::EventQueue& queue, unsigned hits): captured(hits), m_thread([this, &queue] {
+			std::mt19937 random(42);
+			std::uniform_int_distribution<int> pause(1, 30);
+			for (unsigned i = 0; i < captured.size(); ++i) {
+				std::this_thread::sleep_for(std::chrono::milliseconds(pause(random)));
+				input::Event ev;
+				ev.source = source();
+				ev.hw = i;
+				ev.button = input::ButtonId::DRUMS_YELLOW_CYMBAL;
+				ev.devType = input::DevType::DRUMS;
+				ev.value = i % 2 ? 0.0 : 1.0;  // Hit and release, repeated values would be filtered out
+				ev.time = captured[i] = Clock::now();
+				while (!queue.push(ev)) std::this_thread::yield();
+			}
+		}) {}
+		~FakeDrums() override { m_thread.join(); }
+		std::vector<Time> captured;  ///< When each event was captured
+		std::thread m_thread;
+	};
+}
+
+/// Hits from a backend thread go through Controllers while the game loop runs at 60 FPS, and are judged as GuitarGraph
+/// does. Judging by the frame time is off by up to a frame, judging by capture time is exact.
+TEST(UnitTest_InputLatency, harness_capture_time_vs_frame_time) {
+	unsigned const hits = 40;
+	FakeDrums* drums = nullptr;  // Owned by controllers
+	input::Controllers controllers({ { input::SourceType::MIDI, [&drums, hits](input::EventQueue& queue) {
+		auto ptr = std::make_shared<FakeDrums>(queue, hits);
+		drums = ptr.get();
+		return ptr;
+	} } });
+	ASSERT_NE(nullptr, drums);
+	controllers.enableEvents(true);
+	Time const songStart = Clock::now();
+	auto const songTime = [songStart](Time t) { return Seconds(t - songStart).count(); };  // Fake audio clock
+	input::DevicePtr dev;
+	unsigned received = 0;
+	for (unsigned frame = 0; received < hits && frame < 600; ++frame) {
+		std::this_thread::sleep_for(std::chrono::microseconds(16667));
+		controllers.process(Clock::now());
+		if (!dev) dev = controllers.registerDevice(FakeDrums::source());
+		if (!dev) continue;
+		// As in GuitarGraph::engine, which reads the clock after the controllers have been processed
+		Time const frameTime = Clock::now();
+		double const frameSongTime = songTime(frameTime);
+		for (input::Event ev; dev->getEvent(ev); ++received) {
+			ASSERT_EQ(received, ev.hw);  // All events arrive, in order
+			EXPECT_EQ(input::ButtonId::DRUMS_YELLOW_CYMBAL, ev.button.id);
+			Time const captured = drums->captured[ev.hw];
+			double const truth = songTime(captured);
+			double const hitTime = input::captureSongTime(ev, frameSongTime, frameTime);
+			// Exact, unless this frame came so late that the event is older than hits are ever judged
+			if (frameTime - captured <= input::maxEventAge) EXPECT_NEAR(truth, hitTime, 1e-9) << ev.hw;
+			else EXPECT_NEAR(frameSongTime - input::maxEventAge.count(), hitTime, 1e-9) << ev.hw;
+		}
+	}
+	EXPECT_EQ(hits, received);
+}
+
+TEST(UnitTest_InputLatency, device_time) {
+	Time const now = Clock::now();
+	EXPECT_EQ(now - 5ms, input::deviceTime(1000, 1005, now));
+	EXPECT_EQ(now - 7ms, input::deviceTime(0xFFFFFFFEu, 5, now));  // Device clock wrapped
+	EXPECT_EQ(now, input::deviceTime(1010, 1005, now));  // From the future
+	EXPECT_EQ(now, input::deviceTime(0, 5000, now));  // Too old
+}
+
+/// A 32nd-note roll at 200 BPM (a hit every 37.5 ms) played on a MIDI drum kit, simulated on a virtual clock: the device
+/// stamps each hit in whole milliseconds, the reader thread wakes up every millisecond and the game runs at 60 FPS.
+TEST(UnitTest_InputLatency, midi_roll_device_time_vs_frame_time) {
+	using us = std::chrono::microseconds;
+	Time const start = Clock::now();
+	auto const ms = [](us t) { return static_cast<std::uint32_t>(t.count() / 1000); };  // Device clock
+	auto const next = [](us t, us period) { return (t / period + 1) * period; };  // First tick after t
+	ProfCP frameError, deviceError;
+	for (unsigned i = 0; i < 107; ++i) {
+		us const hit = us(37500 * i + 300);
+		us const poll = next(hit, 1000us);  // Reader thread reads the batch with this hit
+		us const frame = next(poll, 16667us);  // First frame to see it in the queue
+		Time const captured = input::deviceTime(ms(hit), ms(poll), start + poll);
+		frameError.add(Seconds(frame - hit).count());
+		deviceError.add(std::abs(Seconds(captured - (start + hit)).count()));
+	}
+	EXPECT_LT(deviceError.peak, 0.001);
+	EXPECT_GT(frameError.avg, 0.005);
+}
@@ -0,0 +1,81 @@
+#include "common.hh"
+
+#include "game/chrono.hh"
+#include "game/log.hh"
+
+#include <spdlog/sinks/base_sink.h>
+
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <mutex>
+
+TEST(UnitTest_Log, rate_limiter_counts_what_it_drops) {
+	LogRateLimiter limiter;
+	unsigned dropped = 0;
+	for (unsigned i = 0; i < 3; ++i) EXPECT_TRUE(limiter.allow(7, 3, dropped));
+	EXPECT_FALSE(limiter.allow(7, 3, dropped));
+	EXPECT_FALSE(limiter.allow(7, 3, dropped));
+	EXPECT_EQ(0u, dropped);
+	EXPECT_TRUE(limiter.allow(8, 3, dropped));  // A new second
+	EXPECT_EQ(2u, dropped);
+	EXPECT_TRUE(limiter.allow(8, 3, dropped));
+	EXPECT_EQ(0u, dropped);
+}
+
+namespace {
+	std::int64_t second() { return std::chrono::duration_cast<std::chrono::seconds>(Clock::now().time_since_epoch()).count(); }
+
+	/// A sink that holds the logging thread until released, like a disk that cannot keep up
+	class StuckSink: public spdlog::sinks::base_sink<std::mutex> {
+	  public:
+		std::future<void> entered() { return m_entered.get_future(); }
+		void release() { m_release.set_value(); }
+	  protected:
+		void sink_it_(spdlog::details::log_msg const&) override {
+			if (m_stuck) {
+				m_stuck = false;
+				m_entered.set_value();
+				m_released.wait();
+			}
+		}
+		void flush_() override {}
+	  private:
+		bool m_stuck = true;
+		std::promise<void> m_entered, m_release;
+		std::shared_future<void> m_released{ m_release.get_future() };
+	};
+}
+
+/// Debug messages beyond the rate limit of a subsystem are counted and dropped, not queued
+TEST(UnitTest_Log, flood_is_rate_limited) {
+	unsigned const messages = 5000;
+	std::size_t const before = SpdLogger::dropped();
+	std::int64_t const begin = second();
+	for (unsigned i = 0; i < messages; ++i) SpdLogger::debug(LogSystem::CONTROLLERS, "Processing controller event button={}.", i);
+	auto const seconds = static_cast<unsigned>(second() - begin + 1);
+	EXPECT_GE(SpdLogger::dropped() - before, messages - seconds * SpdLogger::rateLimit);
+}
+
+/// When the log cannot be written as fast as messages come, the oldest queued messages are lost instead of callers waiting
+TEST(UnitTest_Log, full_queue_does_not_block_callers) {
+	auto const sink = std::make_shared<StuckSink>();
+	SpdLogger::addSink(sink);
+	auto entered = sink->entered();
+	SpdLogger::notice(LogSystem::LOGGER, "Sink test started.");
+	entered.wait();  // The logging thread is now stuck
+	std::size_t const before = SpdLogger::dropped();
+	unsigned const messages = 3 * SpdLogger::queueSize;  // Notices are not rate limited
+	auto flood = std::async(std::launch::async, [&] {
+		for (unsigned i = 0; i < messages; ++i) SpdLogger::notice(LogSystem::CONTROLLERS, "Queue test message={}.", i);
+	});
+	// A generous timeout only so that a regression fails instead of hanging
+	bool const finished = flood.wait_for(std::chrono::seconds(60)) == std::future_status::ready;
+	std::size_t const overrun = SpdLogger::dropped() - before;
+	sink->release();
+	flood.wait();
+	SpdLogger::removeSink(sink);
+	EXPECT_TRUE(finished);
+	EXPECT_GE(overrun, messages - SpdLogger::queueSize);
+}
@@ -2,8 +2,13 @@
 
 #include <gtest/gtest.h>
 
+#include <filesystem>
+
 int main(int argc, char** argv) {
-	SpdLogger spdLogger(spdlog::level::critical);
+	// Keep the log files of test runs out of the working directory
+	auto const logDir = std::filesystem::temp_directory_path() / "performous-tests";
+	std::filesystem::create_directories(logDir);
+	SpdLogger spdLogger(spdlog::level::critical, logDir);
 	testing::InitGoogleTest(&argc, argv);
 	return RUN_ALL_TESTS();
 }
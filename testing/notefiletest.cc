@@ -0,0 +1,149 @@
+#include "common.hh"
+
+#include "game/notefile.hh"
+
+#include <random>
+
+namespace {
+	Note makeNote(Note::Type type, double begin, double end, float pitch, std::string syllable = {}) {
+		Note n;
+		n.type = type;
+		n.begin = begin;
+		n.end = end;
+		n.phase = 0.25;
+		n.note = n.notePrev = pitch;
+		n.syllable = std::move(syllable);
+		return n;
+	}
+
+	/// Tracks like those of a full band song: duet vocals, guitars and drums from MIDI, and dance charts
+	struct Tracks {
+		VocalTracks vocal;
+		InstrumentTracks instrument;
+		DanceTracks dance;
+	};
+
+	Tracks makeTracks(unsigned notesPerTrack) {
+		std::mt19937 random(3);
+		std::uniform_real_distribution<double> length(0.1, 1.0);
+		Tracks tracks;
+		for (std::string const name: { "Vocals", "Duet singer" }) {
+			VocalTrack track(name == "Vocals" ? "Lead" : "Backing");
+			double t = 1.0;
+			for (unsigned i = 0; i < notesPerTrack; ++i) {
+				Note::Type const type = (i % 8 == 7) ? Note::Type::SLEEP : (i % 5 == 0) ? Note::Type::GOLDEN : Note::Type::NORMAL;
+				double const end = type == Note::Type::SLEEP ? t : t + length(random);
+				track.notes.push_back(makeNote(type, t, end, static_cast<float>(60 + i % 12), type == Note::Type::SLEEP ? "" : "syl\xC3\xA9" + std::to_string(i)));
+				t = end + 0.05;
+			}
+			track.noteMin = 60.0f;
+			track.noteMax = 71.0f;
+			track.beginTime = track.notes.front().begin;
+			track.endTime = track.notes.back().end;
+			track.m_scoreFactor = 1.0 / 1234.5;
+			tracks.vocal.insert_or_assign(name, track);
+		}
+		for (std::string const name: { "Guitar", "Bass", "Drums", "Keyboard" }) {
+			InstrumentTrack track(name);
+			for (unsigned fret = 0; fret < 5; ++fret) {
+				for (unsigned i = 0; i < notesPerTrack; ++i) track.nm[fret].push_back(Duration(i * 0.5 + fret * 0.01, i * 0.5 + fret * 0.01 + (i % 7 == 0 ? 1.0 : 0.0)));
+			}
+			tracks.instrument.insert_or_assign(name, track);
+		}
+		for (std::string const type: { "dance-single", "dance-double" }) {
+			for (auto difficulty: { DanceDifficulty::EASY, DanceDifficulty::HARD }) {
+				std::string description = "Chart by someone";
+				Notes notes;
+				for (unsigned i = 0; i < notesPerTrack; ++i) notes.push_back(makeNote(i % 9 == 0 ? Note::Type::HOLDBEGIN : Note::Type::TAP, i * 0.25, i * 0.25 + (i % 9 == 0 ? 0.75 : 0.0), static_cast<float>(i % 4)));
+				tracks.dance[type].insert_or_assign(difficulty, DanceTrack(description, notes));
+			}
+		}
+		return tracks;
+	}
+
+	std::string encode(Tracks const& tracks) {
+		notefile::Writer out;
+		out.put(tracks.vocal);
+		out.put(tracks.instrument);
+		out.put(tracks.dance);
+		return out.data();
+	}
+
+	Tracks decode(std::string data) {
+		notefile::Reader in(std::move(data));
+		Tracks tracks;
+		in.get(tracks.vocal);
+		in.get(tracks.instrument);
+		in.get(tracks.dance);
+		EXPECT_TRUE(in.done());
+		return tracks;
+	}
+
+	void expectEqual(Notes const& a, Notes const& b) {
+		ASSERT_EQ(a.size(), b.size());
+		for (std::size_t i = 0; i < a.size(); ++i) {
+			EXPECT_EQ(a[i].begin, b[i].begin);
+			EXPECT_EQ(a[i].end, b[i].end);
+			EXPECT_EQ(a[i].phase, b[i].phase);
+			EXPECT_EQ(a[i].type, b[i].type);
+			EXPECT_EQ(a[i].note, b[i].note);
+			EXPECT_EQ(a[i].notePrev, b[i].notePrev);
+			EXPECT_EQ(a[i].syllable, b[i].syllable);
+		}
+	}
+
+	void expectEqual(Tracks const& a, Tracks const& b) {
+		ASSERT_EQ(a.vocal.size(), b.vocal.size());
+		for (auto const& [name, track]: a.vocal) {
+			VocalTrack const& other = b.vocal.at(name);
+			EXPECT_EQ(track.name, other.name);
+			EXPECT_EQ(track.noteMin, other.noteMin);
+			EXPECT_EQ(track.noteMax, other.noteMax);
+			EXPECT_EQ(track.beginTime, other.beginTime);
+			EXPECT_EQ(track.endTime, other.endTime);
+			EXPECT_EQ(track.m_scoreFactor, other.m_scoreFactor);
+			expectEqual(track.notes, other.notes);
+		}
+		ASSERT_EQ(a.instrument.size(), b.instrument.size());
+		for (auto const& [name, track]: a.instrument) {
+			InstrumentTrack const& other = b.instrument.at(name);
+			EXPECT_EQ(track.name, other.name);
+			ASSERT_EQ(track.nm.size(), other.nm.size());
+			for (auto const& [fret, durations]: track.nm) {
+				auto const& otherDurations = other.nm.at(fret);
+				ASSERT_EQ(durations.size(), otherDurations.size());
+				for (std::size_t i = 0; i < durations.size(); ++i) {
+					EXPECT_EQ(durations[i].begin, otherDurations[i].begin);
+					EXPECT_EQ(durations[i].end, otherDurations[i].end);
+				}
+			}
+		}
+		ASSERT_EQ(a.dance.size(), b.dance.size());
+		for (auto const& [type, difficulties]: a.dance) {
+			ASSERT_EQ(difficulties.size(), b.dance.at(type).size());
+			for (auto const& [difficulty, track]: difficulties) {
+				DanceTrack const& other = b.dance.at(type).at(difficulty);
+				EXPECT_EQ(track.description, other.description);
+				expectEqual(track.notes, other.notes);
+			}
+		}
+	}
+}
+
+TEST(UnitTest_NoteFile, round_trip) {
+	Tracks const tracks = makeTracks(200);
+	expectEqual(tracks, decode(encode(tracks)));
+	expectEqual(Tracks(), decode(encode(Tracks())));
+}
+
+TEST(UnitTest_NoteFile, rejects_damaged_files) {
+	std::string const data = encode(makeTracks(20));
+	for (std::size_t size = 0; size < data.size(); size += 7) {
+		EXPECT_THROW(decode(data.substr(0, size)), std::runtime_error) << size;
+	}
+	std::string otherVersion = data;
+	otherVersion[8] = static_cast<char>(notefile::version + 1);
+	EXPECT_THROW(notefile::Reader{otherVersion}, std::runtime_error);
+	std::string hugeCount = notefile::Writer().data() + std::string(4, '\xFF');
+	EXPECT_THROW(decode(hugeCount), std::runtime_error);
+}
@@ -0,0 +1,133 @@
+#include "common.hh"
+
+#include "game/notes.hh"
+#include "game/notewindow.hh"
+
+#include <algorithm>
+#include <random>
+#include <utility>
+
+namespace {
+	/// Like DanceNote, sorted by end time and with holds of varying length
+	struct Arrow {
+		double begin, end;
+	};
+}
+
+template <> struct NoteSpan<Arrow> {
+	static double key(Arrow const& n) { return n.end; }
+	static double begin(Arrow const& n) { return n.begin; }
+	static double end(Arrow const& n) { return n.end; }
+};
+
+namespace {
+	/// Vocal track: back to back notes sorted by begin
+	Notes makeVocals(unsigned count) {
+		std::mt19937 random(1);
+		std::uniform_real_distribution<double> length(0.05, 2.0);
+		Notes notes;
+		double t = 0.0;
+		for (unsigned i = 0; i < count; ++i) {
+			Note n;
+			n.type = (i % 10 == 9) ? Note::Type::SLEEP : Note::Type::NORMAL;
+			n.begin = t;
+			n.end = n.type == Note::Type::SLEEP ? t : t + length(random);
+			t = n.end + 0.05;
+			notes.push_back(n);
+		}
+		return notes;
+	}
+
+	/// Dance chart of a long SM song: steady arrows with an occasional long hold
+	std::vector<Arrow> makeArrows(unsigned count, double duration) {
+		std::mt19937 random(2);
+		std::uniform_real_distribution<double> hold(0.5, 8.0);
+		std::vector<Arrow> arrows;
+		for (unsigned i = 0; i < count; ++i) {
+			double const begin = duration * i / count;
+			arrows.push_back({ begin, begin + (i % 50 == 0 ? hold(random) : 0.0) });
+		}
+		std::sort(arrows.begin(), arrows.end(), [](Arrow const& a, Arrow const& b) { return a.end < b.end; });
+		return arrows;
+	}
+
+	/// Check that every note overlapping [from, to] is within the window
+	template <typename Container, typename Window>
+	void expectVisible(Container const& notes, Window const& window, double from, double to) {
+		using Span = NoteSpan<typename Container::value_type>;
+		for (auto it = notes.begin(); it != notes.end(); ++it) {
+			if (Span::end(*it) < from || Span::begin(*it) > to) continue;
+			EXPECT_TRUE(it >= window.begin() && it < window.end()) << "note " << (it - notes.begin()) << " missing at " << from;
+		}
+	}
+}
+
+TEST(UnitTest_NoteWindow, empty) {
+	Notes const notes;
+	NoteWindow<Notes::const_iterator> window(notes.begin(), notes.end());
+	window.update(0.0, 10.0);
+	EXPECT_TRUE(window.empty());
+}
+
+TEST(UnitTest_NoteWindow, vocals_forward_and_rewind) {
+	Notes const notes = makeVocals(500);
+	NoteWindow<Notes::const_iterator> window(notes.begin(), notes.end());
+	double const duration = notes.back().end;
+	for (unsigned frame = 0; frame * 0.1 < duration + 4.0; ++frame) {
+		double const t = frame * 0.1 - 2.0;
+		window.update(t - 1.5, t + 3.5);
+		expectVisible(notes, window, t - 1.5, t + 3.5);
+		if (frame % 300 == 299) {
+			// Practice mode rewind
+			window.update(t - 11.5, t - 6.5);
+			expectVisible(notes, window, t - 11.5, t - 6.5);
+			window.update(t - 1.5, t + 3.5);
+		}
+	}
+}
+
+TEST(UnitTest_NoteWindow, holds_sorted_by_end) {
+	auto const arrows = makeArrows(2000, 300.0);
+	NoteWindow<std::vector<Arrow>::const_iterator> window(arrows.begin(), arrows.end());
+	for (double t = 0.0; t < 310.0; t += 0.25) {
+		window.update(t - 0.3, t + 2.0);
+		expectVisible(arrows, window, t - 0.3, t + 2.0);
+	}
+	// Seeking far back and forth
+	for (double t: { 250.0, 10.0, 150.0, 149.0, 0.0, 300.0 }) {
+		window.update(t - 0.3, t + 2.0);
+		expectVisible(arrows, window, t - 0.3, t + 2.0);
+	}
+}
+
+TEST(UnitTest_NoteWindow, long_chart_visits_few_notes) {
+	// A six minute SM chart with thousands of arrows, drawn at 60 FPS
+	double const duration = 360.0;
+	auto const arrows = makeArrows(6000, duration);
+	double const past = -0.3, future = 2.0;
+	auto count = [&](auto visit) {
+		std::size_t visited = 0, drawn = 0;
+		for (double time = 0.0; time < duration; time += 1.0 / 60.0) visit(time, visited, drawn);
+		return std::make_pair(visited, drawn);
+	};
+	auto const [scanVisited, scanDrawn] = count([&](double time, std::size_t& visited, std::size_t& drawn) {
+		for (auto& n: arrows) {
+			++visited;
+			if (n.end - time < past) continue;
+			if (n.begin - time > future) continue;
+			++drawn;
+		}
+	});
+	NoteWindow<std::vector<Arrow>::const_iterator> window(arrows.begin(), arrows.end());
+	auto const [windowVisited, windowDrawn] = count([&](double time, std::size_t& visited, std::size_t& drawn) {
+		window.update(time + past, time + future);
+		for (auto& n: window) {
+			++visited;
+			if (n.end - time < past) continue;
+			if (n.begin - time > future) continue;
+			++drawn;
+		}
+	});
+	EXPECT_EQ(scanDrawn, windowDrawn);
+	EXPECT_LT(windowVisited * 10, scanVisited);
+}
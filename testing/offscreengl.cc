@@ -0,0 +1,46 @@
+#include "offscreengl.hh"
+
+#include <SDL_video.h>
+
+OffscreenGL::OffscreenGL(unsigned width, unsigned height) {
+	for (char const* driver: { static_cast<char const*>(nullptr), "offscreen" }) {
+		if (SDL_VideoInit(driver) != 0) {
+			m_error = SDL_GetError();
+			continue;
+		}
+		SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 3);
+		SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 3);
+		SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_CORE);
+		m_window = SDL_CreateWindow("Performous test", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, 1, 1, SDL_WINDOW_OPENGL | SDL_WINDOW_HIDDEN);
+		if (m_window) m_context = SDL_GL_CreateContext(m_window);
+		if (m_context) break;
+		m_error = SDL_GetError();
+		if (m_window) SDL_DestroyWindow(m_window);
+		m_window = nullptr;
+		SDL_VideoQuit();
+	}
+	if (!m_context) return;
+	glGenRenderbuffers(1, &m_renderbuffer);
+	glBindRenderbuffer(GL_RENDERBUFFER, m_renderbuffer);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, static_cast<GLsizei>(width), static_cast<GLsizei>(height));
+	glGenFramebuffers(1, &m_framebuffer);
+	glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_renderbuffer);
+	glViewport(0, 0, static_cast<GLsizei>(width), static_cast<GLsizei>(height));
+	if (glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE) return;
+	m_error = "Incomplete framebuffer";
+	SDL_GL_DeleteContext(m_context);
+	m_context = nullptr;
+}
+
+OffscreenGL::~OffscreenGL() {
+	if (m_context) {
+		glDeleteFramebuffers(1, &m_framebuffer);
+		glDeleteRenderbuffers(1, &m_renderbuffer);
+		SDL_GL_DeleteContext(m_context);
+	}
+	if (m_window) {
+		SDL_DestroyWindow(m_window);
+		SDL_VideoQuit();
+	}
+}
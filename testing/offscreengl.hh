@@ -0,0 +1,27 @@
+#pragma once
+
+#include <epoxy/gl.h>
+
+#include <string>
+
+struct SDL_Window;
+
+/// OpenGL 3.3 core context without a visible window, for tests of GL code. Rendering goes to a framebuffer object of
+/// the given size, which is bound for both drawing and reading. Uses the desktop if there is one, otherwise SDL's
+/// offscreen driver (EGL, e.g. Mesa's software renderer). Tests should skip themselves when ok() is false.
+class OffscreenGL {
+  public:
+	OffscreenGL(unsigned width, unsigned height);
+	~OffscreenGL();
+	OffscreenGL(OffscreenGL const&) = delete;
+	OffscreenGL& operator=(OffscreenGL const&) = delete;
+	bool ok() const { return m_context != nullptr; }
+	std::string const& error() const { return m_error; }  ///< Why no context could be created
+
+  private:
+	SDL_Window* m_window = nullptr;
+	void* m_context = nullptr;
+	GLuint m_framebuffer = 0;
+	GLuint m_renderbuffer = 0;
+	std::string m_error;
+};
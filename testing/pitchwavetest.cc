@@ -0,0 +1,149 @@
+#include "common.hh"
+
+#include "game/engine.hh"
+#include "game/pitchwave.hh"
+#include "game/util.hh"
+
+#include <algorithm>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+	/// A song of short notes with a pause (sleep note) after every eight
+	VocalTrack makeTrack(double length) {
+		VocalTrack track("Vocals");
+		std::mt19937 random(5);
+		std::uniform_int_distribution<int> pitch(50, 70);
+		double t = 1.0;
+		for (unsigned i = 0; t < length; ++i) {
+			Note n;
+			n.type = (i % 9 == 8 ? Note::Type::SLEEP : Note::Type::NORMAL);
+			n.begin = t;
+			n.end = (n.type == Note::Type::SLEEP ? t : t + 0.5);
+			n.note = n.notePrev = static_cast<float>(pitch(random));
+			track.notes.push_back(n);
+			t += 0.6;
+		}
+		track.beginTime = track.notes.front().begin;
+		track.endTime = t;
+		return track;
+	}
+
+	/// Singing slightly off the notes, with some silence
+	PitchHistory sing(VocalTrack const& track) {
+		PitchHistory pitch(static_cast<std::size_t>(track.endTime / Engine::TIMESTEP));
+		std::mt19937 random(9);
+		std::normal_distribution<double> off(0.0, 0.7);
+		auto it = track.notes.begin();
+		for (std::size_t i = 0; i < pitch.capacity(); ++i) {
+			double const t = static_cast<double>(i) * Engine::TIMESTEP;
+			while (it != track.notes.end() && t > it->end) ++it;
+			if (it == track.notes.end() || it->type == Note::Type::SLEEP || t < it->begin) pitch.push(getNaN(), -getInf());
+			else pitch.push(MusicalScale().setNote(it->note + 12.0 + off(random)).getFreq(), -20.0);
+		}
+		return pitch;
+	}
+
+	/// The wave points of the visible samples, computed from scratch like NoteGraph::drawWaves did on every frame
+	std::vector<PitchWave::Point> rebuild(VocalTrack const& vocal, PitchHistory::Snapshot const& pitch, std::size_t beginIdx) {
+		std::vector<PitchWave::Point> points;
+		std::size_t idx = beginIdx;
+		// Go back until silence (NaN freq) to allow proper wave phase to be calculated
+		if (beginIdx < pitch.size()) while (idx > 0 && pitch[idx].first == pitch[idx].first) --idx;
+		float phase = 0.0f;
+		double oldval = getNaN();
+		// Notes before this end before the first wave point drawn
+		auto noteIt = std::partition_point(vocal.notes.begin(), vocal.notes.end(), [&](Note const& n) { return n.end < (static_cast<double>(beginIdx) - 1.0) * Engine::TIMESTEP; });
+		for (; idx < pitch.size(); ++idx) {
+			double const freq = pitch[idx].first;
+			if (freq != freq) { oldval = getNaN(); phase = 0.0f; continue; }
+			phase += static_cast<float>(freq * 0.001);
+			if (idx < beginIdx) continue;
+			double const t = static_cast<double>(idx) * Engine::TIMESTEP;
+			while (noteIt != vocal.notes.end() && (noteIt->type == Note::Type::SLEEP || t > noteIt->end)) ++noteIt;
+			auto notePrev = noteIt;
+			while (notePrev != vocal.notes.begin() && (notePrev == vocal.notes.end() || notePrev->type == Note::Type::SLEEP || t < notePrev->begin)) --notePrev;
+			bool hasNote = (noteIt != vocal.notes.end());
+			bool hasPrev = notePrev->type != Note::Type::SLEEP && t >= notePrev->begin;
+			double val;
+			if (hasNote && hasPrev) val = 0.5 * (noteIt->note + notePrev->note);
+			else if (hasNote) val = noteIt->note;
+			else val = notePrev->note;
+			val += Note::diff(val, MusicalScale(vocal.scale).setFreq(freq).getNote());
+			points.push_back({ idx, t, val, clamp(1.0 + pitch[idx].second / 60.0) + 0.5, phase, oldval != oldval || std::abs(oldval - val) > 1 });
+			oldval = val;
+		}
+		return points;
+	}
+
+	/// The history as the drawing thread sees it at the given time
+	PitchHistory::Snapshot until(PitchHistory const& pitch, double time) {
+		auto const all = pitch.snapshot();
+		return PitchHistory::Snapshot(all.begin(), std::min(all.size(), static_cast<std::size_t>(time / Engine::TIMESTEP)));
+	}
+
+	std::size_t visibleFrom(double time) { return static_cast<std::size_t>(std::max(0.0, time - 2.5) / Engine::TIMESTEP); }
+}
+
+TEST(UnitTest_PitchHistory, snapshots_see_only_complete_samples) {
+	PitchHistory pitch(200000);
+	std::thread engine([&] {
+		for (std::size_t i = 0; i < pitch.capacity(); ++i) pitch.push(static_cast<double>(i), -static_cast<double>(i));
+	});
+	std::size_t checked = 0;
+	while (checked < pitch.capacity()) {
+		auto const snapshot = pitch.snapshot();
+		for (std::size_t i = checked; i < snapshot.size(); ++i) {
+			ASSERT_EQ(static_cast<double>(i), snapshot[i].first);
+			ASSERT_EQ(-static_cast<double>(i), snapshot[i].second);
+		}
+		checked = snapshot.size();
+	}
+	engine.join();
+	EXPECT_TRUE(pitch.full());
+	EXPECT_FALSE(pitch.push(0.0, 0.0));
+	PitchHistory copy(pitch);
+	EXPECT_EQ(pitch.size(), copy.size());
+	EXPECT_EQ(pitch.snapshot()[1234], copy.snapshot()[1234]);
+}
+
+TEST(UnitTest_PitchWave, same_points_as_rebuilding) {
+	VocalTrack const track = makeTrack(60.0);
+	PitchHistory const pitch = sing(track);
+	PitchWave wave(track);
+	auto const check = [&](double time) {
+		auto const snapshot = until(pitch, time);
+		std::size_t const beginIdx = visibleFrom(time);
+		wave.update(snapshot, beginIdx);
+		auto const expected = rebuild(track, snapshot, beginIdx);
+		ASSERT_EQ(expected.size(), wave.points().size()) << "time=" << time;
+		for (std::size_t i = 0; i < expected.size(); ++i) {
+			auto const& p = wave.points()[i];
+			ASSERT_EQ(expected[i].idx, p.idx);
+			ASSERT_DOUBLE_EQ(expected[i].note, p.note);
+			ASSERT_EQ(expected[i].thickness, p.thickness);
+			ASSERT_EQ(expected[i].phase, p.phase);
+			// The first point always begins a strip when drawing, whatever came before it
+			if (i > 0) { ASSERT_EQ(expected[i].begin, p.begin) << "time=" << time << " idx=" << p.idx; }
+		}
+	};
+	for (double time = 0.0; time < track.endTime + 1.0; time += 1.0 / 60.0) check(time);
+	for (double time: { 30.0, 10.0, 45.0, 44.0, 59.0 }) check(time);  // Seeking back and forth
+	wave.update(PitchHistory::Snapshot(), 0);  // A new, empty history
+	EXPECT_TRUE(wave.points().empty());
+}
+
+/// A three minute song drawn at 60 FPS: updating the cached wave on every frame gives the same points as rebuilding it
+TEST(UnitTest_PitchWave, all_frames_of_a_song) {
+	VocalTrack const track = makeTrack(180.0);
+	PitchHistory const pitch = sing(track);
+	std::size_t rebuilt = 0, cached = 0;
+	for (double time = 0.0; time < track.endTime; time += 1.0 / 60.0) rebuilt += rebuild(track, until(pitch, time), visibleFrom(time)).size();
+	PitchWave wave(track);
+	for (double time = 0.0; time < track.endTime; time += 1.0 / 60.0) {
+		wave.update(until(pitch, time), visibleFrom(time));
+		cached += wave.points().size();
+	}
+	EXPECT_EQ(rebuilt, cached);
+}
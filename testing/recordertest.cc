@@ -0,0 +1,122 @@
+#include "common.hh"
+
+#include "game/analyzer.hh"
+#include "game/libda/sample.hpp"
+#include "game/recorder.hh"
+#include "game/spscring.hh"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <memory>
+
+namespace {
+	/// Stands in for a PortAudio input device: interleaved buffers handed to the analyzers like Device::operator() does
+	struct FakeInputDevice {
+		static constexpr std::ptrdiff_t frames = 256;
+		std::deque<Analyzer>& analyzers;
+		std::vector<float> buffer;
+		explicit FakeInputDevice(std::deque<Analyzer>& analyzers): analyzers(analyzers), buffer(frames * analyzers.size()) {}
+		/// Fill each channel with a ramp continuing from offset, then run the callback
+		void callback(float offset) {
+			auto const channels = static_cast<std::ptrdiff_t>(analyzers.size());
+			for (std::ptrdiff_t i = 0; i < frames; ++i)
+				for (std::ptrdiff_t ch = 0; ch < channels; ++ch) buffer[static_cast<size_t>(i * channels + ch)] = offset + static_cast<float>(i) + 0.5f * static_cast<float>(ch);
+			for (std::ptrdiff_t ch = 0; ch < channels; ++ch) {
+				auto it = da::sample_const_iterator(buffer.data() + ch, channels);
+				analyzers[static_cast<size_t>(ch)].input(it, it + frames);
+			}
+		}
+	};
+
+	std::uint32_t readLE32(BinaryBuffer const& data, size_t pos) {
+		std::uint32_t value = 0;
+		for (unsigned i = 0; i < 4; ++i) value |= static_cast<std::uint32_t>(static_cast<unsigned char>(data[pos + i])) << (8 * i);
+		return value;
+	}
+}
+
+TEST(UnitTest_SpscRing, keeps_order_over_wrap_around) {
+	SpscRing ring(5);
+	EXPECT_EQ(8u, ring.capacity());
+	std::vector<float> out(8);
+	float next = 0.0f, expected = 0.0f;
+	for (unsigned round = 0; round < 10; ++round) {
+		std::vector<float> in{ next, next + 1, next + 2, next + 3, next + 4 };
+		next += 5;
+		EXPECT_EQ(5u, ring.push(in.begin(), in.end()));
+		ASSERT_EQ(5u, ring.pop(out.data(), out.size()));
+		for (unsigned i = 0; i < 5; ++i) EXPECT_EQ(expected++, out[i]);
+	}
+	EXPECT_EQ(0u, ring.overruns());
+}
+
+TEST(UnitTest_SpscRing, drops_and_counts_overruns) {
+	SpscRing ring(4);
+	std::vector<float> in{ 1, 2, 3, 4, 5, 6 };
+	EXPECT_EQ(4u, ring.push(in.begin(), in.end()));
+	EXPECT_EQ(2u, ring.overruns());
+	std::vector<float> out(6);
+	ASSERT_EQ(4u, ring.pop(out.data(), out.size()));
+	EXPECT_THAT(std::vector<float>(out.begin(), out.begin() + 4), ElementsAre(1, 2, 3, 4));
+	ring.push(in.begin(), in.begin() + 2);
+	ring.clear();
+	EXPECT_EQ(0u, ring.pop(out.data(), out.size()));
+}
+
+TEST(UnitTest_Recorder, writes_wav_per_mic) {
+	auto const dir = fs::temp_directory_path() / "performous_recordertest";
+	fs::remove_all(dir);
+	std::deque<Analyzer> analyzers;
+	analyzers.emplace_back(48000, "blue");
+	analyzers.emplace_back(48000, "red");
+	FakeInputDevice device(analyzers);
+	unsigned const buffers = 40;
+	{
+		Recorder recorder(analyzers, dir, -4.25);
+		for (unsigned b = 0; b < buffers; ++b) device.callback(static_cast<float>(b * FakeInputDevice::frames));
+	}
+	device.callback(-1.0f);  // Not recording anymore
+	std::vector<fs::path> files(fs::directory_iterator(dir), fs::directory_iterator{});
+	std::sort(files.begin(), files.end());
+	ASSERT_EQ(2u, files.size());
+	EXPECT_EQ("-blue.wav", files[0].string().substr(files[0].string().size() - 9));
+	for (size_t ch = 0; ch < files.size(); ++ch) {
+		auto const data = readFile(files[ch]);
+		size_t const samples = buffers * FakeInputDevice::frames;
+		ASSERT_EQ(62 + samples * 4, data.size());
+		EXPECT_EQ("RIFF", std::string(reinterpret_cast<char const*>(data.data()), 4));
+		EXPECT_EQ(data.size() - 8, readLE32(data, 4));
+		EXPECT_EQ(48000u, readLE32(data, 24));
+		EXPECT_EQ(samples * 4, readLE32(data, 58));
+		EXPECT_EQ(-4.25, Recorder::startTime(files[ch]));
+		std::vector<float> pcm(samples);
+		std::memcpy(pcm.data(), data.data() + 62, samples * 4);
+		float const channelOffset = files[ch].string().find("red") != std::string::npos ? 0.5f : 0.0f;
+		for (size_t i = 0; i < samples; ++i) ASSERT_EQ(static_cast<float>(i) + channelOffset, pcm[i]);
+	}
+	fs::remove_all(dir);
+}
+
+TEST(UnitTest_Recorder, unwritable_folder) {
+	auto const file = fs::temp_directory_path() / "performous_recordertest_file";
+	std::ofstream(file) << "Not a folder";
+	std::deque<Analyzer> analyzers;
+	analyzers.emplace_back(48000, "blue");
+	{
+		std::unique_ptr<Recorder> recorder;
+		ASSERT_NO_THROW(recorder = std::make_unique<Recorder>(analyzers, file / "recordings", 0.0));
+		FakeInputDevice(analyzers).callback(0.0f);
+	}
+	EXPECT_EQ(nullptr, analyzers[0].recorded());
+	fs::remove(file);
+}
+
+TEST(UnitTest_Recorder, start_time_of_other_files) {
+	auto const file = fs::temp_directory_path() / "performous_recordertest.wav";
+	std::string const wav("RIFF\x0c\0\0\0WAVEdata\0\0\0\0", 20);  // No samples and no start time
+	std::ofstream(file, std::ios::binary).write(wav.data(), static_cast<std::streamsize>(wav.size()));
+	EXPECT_EQ(0.0, Recorder::startTime(file));
+	EXPECT_EQ(0.0, Recorder::startTime(fs::temp_directory_path() / "performous_no_such_file.wav"));
+	fs::remove(file);
+}
@@ -0,0 +1,87 @@
+#include "common.hh"
+
+#include "game/configuration.hh"
+#include "game/notes.hh"
+#include "game/replay.hh"
+
+
+namespace {
+	/// A line of eight notes of half a second each, starting at one second
+	VocalTrack makeTrack() {
+		VocalTrack track("Vocals");
+		double t = 1.0;
+		for (float pitch: { 57.f, 59.f, 60.f, 62.f, 64.f, 62.f, 60.f, 57.f }) {
+			Note n;
+			n.type = Note::Type::NORMAL;
+			n.begin = t;
+			n.end = t + 0.5;
+			n.phase = 0.0;
+			n.note = n.notePrev = pitch;
+			track.notes.push_back(n);
+			t += 0.6;
+		}
+		Note sleep;
+		sleep.type = Note::Type::SLEEP;
+		sleep.begin = sleep.end = t;
+		track.notes.push_back(sleep);
+		track.beginTime = track.notes.front().begin;
+		track.endTime = t;
+		double maxScore = 0.0;
+		for (auto const& n: track.notes) maxScore += n.maxScore();
+		track.m_scoreFactor = 1.0 / maxScore;
+		return track;
+	}
+
+	/// Sine waves at the pitch of the notes (transposed by the given semitones), silence elsewhere
+	std::vector<float> sing(VocalTrack const& track, double rate, double transpose = 0.0) {
+		std::vector<float> samples(static_cast<size_t>((track.endTime + 1.0) * rate));
+		for (auto const& n: track.notes) {
+			if (n.type == Note::Type::SLEEP) continue;
+			double const freq = MusicalScale().setNote(n.note + transpose).getFreq();
+			for (auto i = static_cast<size_t>(n.begin * rate); i < static_cast<size_t>(n.end * rate); ++i) {
+				samples[i] = 0.3f * static_cast<float>(std::sin(static_cast<double>(pi2) * freq * static_cast<double>(i) / rate));
+			}
+		}
+		return samples;
+	}
+
+	struct UnitTest_Replay : public testing::Test {
+		void SetUp() override {
+			// Note scoring reads the difficulty from config
+			if (config.find("game/difficulty") == config.end()) config["game/difficulty"] = ConfigItem(static_cast<unsigned short>(0));
+			initGameDifficulty();
+		}
+		double const rate = 48000.0;
+		VocalTrack track = makeTrack();
+	};
+}
+
+TEST_F(UnitTest_Replay, in_tune_singing_scores_high) {
+	auto result = replay({ { "blue", &track, sing(track, rate) } }, rate);
+	ASSERT_EQ(1u, result.scores.size());
+	EXPECT_GT(result.scores[0], 8000u);
+}
+
+TEST_F(UnitTest_Replay, silence_and_wrong_notes_score_nothing) {
+	auto result = replay({ { "blue", &track, std::vector<float>(static_cast<size_t>(track.endTime * rate)) }, { "red", &track, sing(track, rate, 5.0) } }, rate);
+	EXPECT_THAT(result.scores, ElementsAre(0u, 0u));
+}
+
+TEST_F(UnitTest_Replay, is_deterministic) {
+	auto const capture = sing(track, rate, 0.7);
+	auto first = replay({ { "blue", &track, capture } }, rate);
+	auto second = replay({ { "blue", &track, capture } }, rate);
+	EXPECT_EQ(first.scores, second.scores);
+	EXPECT_EQ(static_cast<unsigned long>(track.endTime / 0.01), first.steps);
+	EXPECT_EQ(first.steps, first.analyze.samples);
+}
+
+TEST_F(UnitTest_Replay, align_capture) {
+	std::vector<float> samples{ 1, 2, 3, 4 };
+	alignCapture(samples, -2.0, 1.0);  // Recording started before the song
+	EXPECT_THAT(samples, ElementsAre(3, 4));
+	alignCapture(samples, 1.0, 1.0);  // Recording started during the song
+	EXPECT_THAT(samples, ElementsAre(0, 3, 4));
+	alignCapture(samples, -5.0, 1.0);
+	EXPECT_TRUE(samples.empty());
+}
@@ -0,0 +1,57 @@
+#include "common.hh"
+
+#include "game/graphic/shelf_packer.hh"
+
+#include <random>
+#include <vector>
+
+namespace {
+	struct Rect {
+		unsigned x, y, w, h;
+		bool overlaps(Rect const& other) const {
+			// The gap counts as part of the rectangle
+			return x < other.x + other.w + ShelfPacker::gap && other.x < x + w + ShelfPacker::gap
+			  && y < other.y + other.h + ShelfPacker::gap && other.y < y + h + ShelfPacker::gap;
+		}
+	};
+}
+
+TEST(UnitTest_ShelfPacker, packs_glyphs_without_overlap) {
+	unsigned const size = 256;
+	ShelfPacker packer(size, size);
+	std::mt19937 random(1);
+	std::uniform_int_distribution<unsigned> width(1, 20), height(8, 24);
+	std::vector<Rect> rects;
+	while (true) {
+		unsigned const w = width(random), h = height(random);
+		auto pos = packer.add(w, h);
+		if (!pos) break;
+		Rect const rect{ pos->first, pos->second, w, h };
+		EXPECT_LE(rect.x + rect.w, size);
+		EXPECT_LE(rect.y + rect.h, size);
+		for (auto const& other: rects) ASSERT_FALSE(rect.overlaps(other)) << rects.size();
+		rects.push_back(rect);
+	}
+	// Most of the area gets used before the atlas is full
+	unsigned area = 0;
+	for (auto const& rect: rects) area += (rect.w + ShelfPacker::gap) * (rect.h + ShelfPacker::gap);
+	EXPECT_GT(area, size * size * 6 / 10);
+}
+
+TEST(UnitTest_ShelfPacker, full_and_clear) {
+	ShelfPacker packer(64, 64);
+	EXPECT_FALSE(packer.add(64, 10));  // No room for the gap
+	EXPECT_FALSE(packer.add(10, 64));
+	ASSERT_TRUE(packer.add(62, 62));
+	EXPECT_FALSE(packer.add(1, 1));
+	packer.clear();
+	auto pos = packer.add(10, 10);
+	ASSERT_TRUE(pos);
+	EXPECT_EQ(ShelfPacker::gap, pos->first);
+	EXPECT_EQ(ShelfPacker::gap, pos->second);
+	// A much shorter glyph gets a row of its own while there is room for one
+	auto tall = packer.add(10, 40);
+	auto small = packer.add(10, 4);
+	ASSERT_TRUE(tall && small);
+	EXPECT_NE(tall->second, small->second);
+}
@@ -0,0 +1,59 @@
+#include "common.hh"
+
+#include "game/startup.hh"
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+
+TEST(UnitTest_Startup, runs_stages_after_their_dependencies) {
+	std::mutex mutex;
+	std::vector<std::string> order;
+	auto stage = [&](std::string name) {
+		return [&, name] { std::lock_guard<std::mutex> l(mutex); order.push_back(name); };
+	};
+	Startup startup;
+	startup.add("a", Startup::Thread::WORKER, {}, stage("a"));
+	startup.add("b", Startup::Thread::MAIN, { "a" }, stage("b"));
+	startup.add("c", Startup::Thread::WORKER, { "a", "b" }, stage("c"));
+	startup.add("d", Startup::Thread::MAIN, { "c" }, stage("d"));
+	startup.run();
+	EXPECT_THAT(order, testing::ElementsAre("a", "b", "c", "d"));
+}
+
+TEST(UnitTest_Startup, main_stages_run_on_calling_thread) {
+	auto const caller = std::this_thread::get_id();
+	std::thread::id mainId, workerId;
+	Startup startup;
+	startup.add("main", Startup::Thread::MAIN, {}, [&] { mainId = std::this_thread::get_id(); });
+	startup.add("worker", Startup::Thread::WORKER, {}, [&] { workerId = std::this_thread::get_id(); });
+	startup.run();
+	EXPECT_EQ(caller, mainId);
+	EXPECT_NE(caller, workerId);
+}
+
+TEST(UnitTest_Startup, independent_stages_overlap) {
+	// Each stage waits until both have started, which only finishes if they run concurrently
+	std::atomic<int> started{0};
+	auto stage = [&] {
+		++started;
+		for (int i = 0; i < 1000 && started < 2; ++i) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	};
+	Startup startup;
+	startup.add("worker", Startup::Thread::WORKER, {}, stage);
+	startup.add("main", Startup::Thread::MAIN, {}, stage);
+	auto const begin = std::chrono::steady_clock::now();
+	startup.run();
+	EXPECT_LT(std::chrono::steady_clock::now() - begin, std::chrono::milliseconds(500));
+}
+
+TEST(UnitTest_Startup, failure_stops_dependents_and_is_rethrown) {
+	bool dependentRan = false;
+	Startup startup;
+	startup.add("fails", Startup::Thread::WORKER, {}, [] { throw std::runtime_error("broken"); });
+	startup.add("dependent", Startup::Thread::MAIN, { "fails" }, [&] { dependentRan = true; });
+	EXPECT_THROW(startup.run(), std::runtime_error);
+	EXPECT_FALSE(dependentRan);
+	EXPECT_THROW(startup.add("unknown", Startup::Thread::MAIN, { "missing" }, [] {}), std::logic_error);
+}
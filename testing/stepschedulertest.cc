@@ -0,0 +1,59 @@
+#include "common.hh"
+
+#include "game/stepscheduler.hh"
+
+#include <random>
+
+namespace {
+	double const timestep = 0.01;
+}
+
+TEST(UnitTest_StepScheduler, nothing_due_without_clock) {
+	StepScheduler scheduler(timestep);
+	EXPECT_EQ(0u, scheduler.take(std::nan("")).steps);
+	EXPECT_EQ(0u, scheduler.take(-0.09).steps);  // Before the song starts (round-trip latency subtracted)
+	EXPECT_DOUBLE_EQ(timestep, scheduler.wait(std::nan("")));
+	EXPECT_DOUBLE_EQ(timestep, scheduler.wait(-0.09));
+	EXPECT_DOUBLE_EQ(0.004, scheduler.wait(-0.004));
+}
+
+TEST(UnitTest_StepScheduler, catches_up_in_one_batch) {
+	StepScheduler scheduler(timestep);
+	auto batch = scheduler.take(0.0);
+	EXPECT_EQ(1u, batch.steps);
+	EXPECT_EQ(0u, scheduler.take(0.005).steps);
+	EXPECT_DOUBLE_EQ(0.005, scheduler.wait(0.005));
+	// A stall of a quarter second
+	batch = scheduler.take(0.255);
+	EXPECT_EQ(25u, batch.steps);
+	EXPECT_NEAR(0.245, batch.lag, 1e-9);
+	EXPECT_EQ(26u, scheduler.steps());
+	EXPECT_DOUBLE_EQ(0.26, scheduler.next());
+	// Clock going backwards (seek) does not repeat steps
+	EXPECT_EQ(0u, scheduler.take(0.1).steps);
+}
+
+/// The engine loop against a fake audio clock that advances in audio blocks, with the engine thread waking up late
+/// by random scheduler jitter after each block
+TEST(UnitTest_StepScheduler, steps_land_within_a_block_of_their_time) {
+	double const block = 256.0 / 48000.0;
+	double const roundTrip = 0.09;
+	std::mt19937 random(7);
+	std::uniform_real_distribution<double> jitter(0.0, 0.002);
+	StepScheduler scheduler(timestep);
+	double maxLag = 0.0;
+	unsigned long stepsRun = 0;
+	double clock = 0.0;
+	for (unsigned b = 0; b < 60000; ++b) {  // About five minutes of song
+		clock += block;
+		double const now = clock + jitter(random) - roundTrip;
+		auto const batch = scheduler.take(now);
+		if (batch.steps == 0) continue;
+		maxLag = std::max(maxLag, batch.lag);
+		// Each step of the batch ran at now, after its begin time
+		EXPECT_LE(static_cast<double>(stepsRun + batch.steps - 1) * timestep, now + 1e-9);
+		stepsRun += batch.steps;
+	}
+	EXPECT_EQ(static_cast<unsigned long>((clock - roundTrip) / timestep) + 1, stepsRun);
+	EXPECT_LE(maxLag, block + 0.002);
+}
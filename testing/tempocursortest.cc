@@ -0,0 +1,71 @@
+#include "common.hh"
+
+#include "game/tempocursor.hh"
+
+#include <random>
+#include <vector>
+
+namespace {
+	/// Like Song::BPM
+	struct Segment {
+		double begin;  // Time in seconds
+		double step;  // Seconds per quarter note
+		double ts;
+	};
+
+	/// A synthetic chart with the given number of tempo changes at random (increasing) timestamps, built like SongParser::addBPM
+	std::vector<Segment> tempoChanges(unsigned count) {
+		std::mt19937 random(7);
+		std::uniform_real_distribution<double> bpm(60.0, 400.0), gap(1.0, 16.0);
+		std::vector<Segment> segments;
+		double ts = 0.0, begin = 0.0;
+		for (unsigned i = 0; i < count; ++i) {
+			if (!segments.empty()) begin = segments.back().begin + (ts - segments.back().ts) * segments.back().step;
+			segments.push_back({ begin, 0.25 * 60.0 / bpm(random), ts });
+			ts += gap(random);
+		}
+		return segments;
+	}
+
+	/// The backwards scan that SongParser::tsTime did before
+	double scanTime(std::vector<Segment> const& segments, double ts) {
+		for (auto it = segments.rbegin(); it != segments.rend(); ++it) {
+			if (it->ts <= ts) return it->begin + (ts - it->ts) * it->step;
+		}
+		return -1.0;
+	}
+
+	double cursorTime(TempoCursor& cursor, std::vector<Segment> const& segments, double ts) {
+		std::size_t i = cursor.find(segments, ts);
+		if (i == TempoCursor::npos) return -1.0;
+		return segments[i].begin + (ts - segments[i].ts) * segments[i].step;
+	}
+}
+
+TEST(UnitTest_TempoCursor, finds_segment_of_timestamp) {
+	std::vector<Segment> const segments{ { 0.0, 1.0, 0.0 }, { 4.0, 0.5, 4.0 }, { 5.0, 2.0, 6.0 } };
+	TempoCursor cursor;
+	EXPECT_EQ(TempoCursor::npos, cursor.find(segments, -1.0));
+	EXPECT_EQ(TempoCursor::npos, cursor.find(segments, std::nan("")));
+	EXPECT_EQ(TempoCursor::npos, cursor.find(std::vector<Segment>(), 0.0));
+	EXPECT_EQ(0u, cursor.find(segments, 0.0));
+	EXPECT_EQ(0u, cursor.find(segments, 3.9));
+	EXPECT_EQ(1u, cursor.find(segments, 4.0));
+	EXPECT_EQ(2u, cursor.find(segments, 100.0));
+	EXPECT_EQ(0u, cursor.find(segments, 1.0));  // Backwards
+	EXPECT_EQ(2u, cursor.find(std::vector<Segment>(segments.begin(), segments.end()), 7.0));
+	EXPECT_EQ(0u, cursor.find(std::vector<Segment>(segments.begin(), segments.begin() + 1), 7.0));  // Table shrunk
+}
+
+TEST(UnitTest_TempoCursor, same_times_as_scan) {
+	auto const segments = tempoChanges(1000);
+	std::mt19937 random(3);
+	std::uniform_real_distribution<double> anywhere(-1.0, segments.back().ts + 100.0);
+	TempoCursor cursor;
+	for (double ts = 0.0; ts < segments.back().ts + 10.0; ts += 0.25) ASSERT_EQ(scanTime(segments, ts), cursorTime(cursor, segments, ts)) << "ts=" << ts;
+	for (unsigned i = 0; i < 10000; ++i) {
+		double const ts = anywhere(random);
+		ASSERT_EQ(scanTime(segments, ts), cursorTime(cursor, segments, ts)) << "ts=" << ts;
+	}
+	for (auto const& segment: segments) ASSERT_EQ(scanTime(segments, segment.ts), cursorTime(cursor, segments, segment.ts));
+}
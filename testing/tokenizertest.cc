@@ -0,0 +1,223 @@
+#include "common.hh"
+
+#include "game/tokenizer.hh"
+#include "game/util.hh"
+
+#include <clocale>
+#include <limits>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+	/// Song files with the quirks found in real libraries: CRLF line ends, missing final newline, comments, odd spacing
+	std::vector<std::string> const txtCorpus = {
+		"#TITLE:Test Song\n#ARTIST:Tester\n#MP3:song.mp3\n#BPM:300\n#GAP:1500\n: 0 4 5 Hel\n: 4 4 7 lo\n- 10\n* 12 2 -3  world\nF 16 2 0 ~\nR 20 1 12\nG 22 3 1 gold \nE\n",
+		"#TITLE: Spaced  \r\n#ARTIST:\tCRLF\r\n#BPM:240,5\r\n#RELATIVE:yes\r\n: 0 2 5 a\r\n- 4 6\r\n: 0 2 5 b\r\n- 3\r\nE\r\n",
+		"#TITLE:Duet\n#ARTIST:Both\n#BPM:200\nP1\n: 0 4 5 one\n-8\nP 2\n: 10 4 5 two\nB 20 150.5\n: 24 1e1 5 weird\n: 30 2 5.5 frac\n:  40   2   -1   spaced out\n: 50 2 x bad\nE",
+		"#TITLE:Edge\n#ARTIST:Cases\n#BPM:100\n\n: 0 1 0 \n: 2 1 99999999999 overflow\n: -1 2 3 negative\n- 4294967297\n: 5 1 +4 plus\n-\nE\n",
+	};
+	std::vector<std::string> const smCorpus = {
+		"#TITLE:Step Song;\n#ARTIST:Stepper;\n#BPMS:0.000=120.000,\n32.000=140.500\n;\n#STOPS:16.000=0.250;\n#OFFSET:-0.100;\n"
+		"//comment\n#NOTES:\n     dance-single:\n     Blank:\n     Easy:\n     3:\n     0.1,0.2:\n1000\n0100\n// measure 2\n0010\n0001\n,\n2000\n0000\n3000\n0000\n;\n"
+		"#NOTES:\n     dance-double:\n     Someone:\n     Challenge:\n     10:\n     0,0:\n10000001\n00000000\n;\n",
+		"#TITLE:CRLF Steps;\r\n#ARTIST:Stepper;\r\n#BPMS:0=180;\r\n#NOTES:\r\n  pump-single:\r\n  :\r\n  Hard:\r\n  8:\r\n  :\r\n10000\r\n0M000,\r\n00L00\r\n00002;\r\n",
+	};
+	std::vector<std::string> const iniCorpus = {
+		"[song]\nname = Rock Song\nartist=  The Band  \ngenre = Rock\nfrets = Someone\ndelay = 120\ncassettecolor = #FF0000\n; comment\n# another\n",
+		"  [song]  ; with comment\r\nname=CRLF\r\nartist = X\r\nvideo_start_time = -500\r\n[other]\nname = ignored\n",
+		"garbage line\nweird key! = 1\n  preview_start_time  =  42  \nname = <b>Bold</b> and <br/> break\nkey.with-dots_ok = yes\n= no key\nempty =\n",
+	};
+
+	/// Split like SongParser did before, using std::getline
+	std::vector<std::string> streamLines(std::string const& text) {
+		std::istringstream ss(text);
+		std::vector<std::string> lines;
+		for (std::string line; std::getline(ss, line);) lines.push_back(line);
+		return lines;
+	}
+
+	std::vector<std::string_view> readerLines(std::string const& text) {
+		tokenizer::LineReader reader(text);
+		std::vector<std::string_view> lines;
+		for (std::string_view line; reader.next(line);) lines.push_back(line);
+		return lines;
+	}
+
+	/// The result of reading a TXT note line, as txtParseNote does
+	struct NoteFields {
+		int type = 0, ts = 0, length = 0;
+		float note = 0.0f;
+		bool ok = false;
+		std::string syllable;
+		bool operator==(NoteFields const& o) const { return type == o.type && ts == o.ts && length == o.length && note == o.note && ok == o.ok && syllable == o.syllable; }
+	};
+
+	template <typename Stream> NoteFields readNote(Stream& in, std::string_view rest(Stream&)) {
+		NoteFields n;
+		n.type = in.get();
+		n.ok = static_cast<bool>(in >> n.ts >> n.length >> n.note);
+		if (n.ok && in.get() == ' ') n.syllable = rest(in);
+		return n;
+	}
+
+	std::string_view streamRest(std::istringstream& in) {
+		static std::string rest;
+		std::getline(in, rest);
+		return rest;
+	}
+
+	std::string_view scannerRest(tokenizer::Scanner& in) { return in.rest(); }
+
+	std::string stripCR(std::string line) {
+		if (!line.empty() && line.back() == '\r') line.pop_back();
+		return line;
+	}
+
+	/// The regexes formerly used by the INI parser
+	std::regex const iniParseLine(
+	  R"(^[^\S^\r\n]*([a-zA-Z0-9._-]+)[^\S^\r\n]*=[^\S^\r\n]*([^\n\r]*?)(?=[^\S^\r\n]*$))", std::regex::multiline);
+	std::regex const iniCheckHeader(R"(^[^\S^\r\n]*\[song\][^\S^\r\n]*(?:$|[;#]))", std::regex::multiline);
+}
+
+TEST(UnitTest_Tokenizer, trim) {
+	EXPECT_EQ("", tokenizer::trim(""));
+	EXPECT_EQ("", tokenizer::trim(" \t\r\n"));
+	EXPECT_EQ("a b", tokenizer::trim("  a b\r"));
+	EXPECT_EQ("\xC3\xA9", tokenizer::trim(" \xC3\xA9 "));
+	EXPECT_TRUE(tokenizer::startsWith("//comment", "//"));
+	EXPECT_FALSE(tokenizer::startsWith("/", "//"));
+}
+
+TEST(UnitTest_Tokenizer, scanner_failures) {
+	tokenizer::Scanner scan("  12 x 3");
+	int a = -1, b = -1, c = -1;
+	EXPECT_FALSE(scan >> a >> b >> c);
+	EXPECT_EQ(12, a);
+	EXPECT_EQ(0, b);  // Failed read stores zero
+	EXPECT_EQ(-1, c);  // Reads after a failure do nothing
+	unsigned u = 0;
+	EXPECT_TRUE(tokenizer::Scanner("-1") >> u);
+	EXPECT_EQ(4294967295u, u);
+	float f = 0.0f;
+	EXPECT_FALSE(tokenizer::Scanner("1e") >> f);
+	EXPECT_FALSE(tokenizer::Scanner("0x10") >> f >> u);
+	EXPECT_TRUE(tokenizer::Scanner("-2.5e1,") >> f);
+	EXPECT_EQ(-25.0f, f);
+	EXPECT_TRUE(tokenizer::Scanner("+4") >> f);
+	EXPECT_EQ(4.0f, f);
+	EXPECT_FALSE(tokenizer::Scanner("-1e400") >> f);
+	EXPECT_EQ(std::numeric_limits<float>::lowest(), f);
+	EXPECT_FALSE(tokenizer::Scanner("+") >> f);
+}
+
+/// Song files always use a decimal point, whatever the locale of the user
+TEST(UnitTest_Tokenizer, scanner_ignores_locale) {
+	std::string const previous = std::setlocale(LC_NUMERIC, nullptr);
+	bool found = false;
+	for (char const* name: { "de_DE.UTF-8", "de_DE.utf8", "fr_FR.UTF-8", "fr_FR.utf8", "German", "French" }) {
+		if (std::setlocale(LC_NUMERIC, name)) { found = true; break; }
+	}
+	if (!found) GTEST_SKIP() << "No locale with a decimal comma installed";
+	double d = 0.0;
+	bool const ok = static_cast<bool>(tokenizer::Scanner("12.5") >> d);
+	std::setlocale(LC_NUMERIC, previous.c_str());
+	EXPECT_TRUE(ok);
+	EXPECT_EQ(12.5, d);
+}
+
+/// Every line of every corpus file tokenizes exactly as with the std::getline, std::istringstream and std::regex based code
+TEST(UnitTest_Tokenizer, corpus_lines) {
+	std::vector<std::string> all = txtCorpus;
+	all.insert(all.end(), smCorpus.begin(), smCorpus.end());
+	all.insert(all.end(), iniCorpus.begin(), iniCorpus.end());
+	for (auto const& text: all) {
+		auto const expected = streamLines(text);
+		auto const lines = readerLines(text);
+		ASSERT_EQ(expected.size(), lines.size()) << text;
+		for (std::size_t i = 0; i < lines.size(); ++i) {
+			EXPECT_EQ(expected[i], lines[i]);
+			// #KEY:VALUE fields
+			std::string const line = trim(expected[i]);
+			auto const pos = line.find(':');
+			std::string_view key, value;
+			ASSERT_EQ(pos != std::string::npos, tokenizer::keyValue(tokenizer::trim(lines[i]), key, value)) << line;
+			if (pos == std::string::npos) continue;
+			EXPECT_EQ(trim(line.substr(1, pos - 1)), key);
+			EXPECT_EQ(trim(line.substr(pos + 1)), value);
+		}
+	}
+}
+
+TEST(UnitTest_Tokenizer, corpus_txt_notes) {
+	for (auto const& text: txtCorpus) {
+		for (auto const& raw: streamLines(text)) {
+			std::string const line = stripCR(raw);
+			if (line.empty() || line[0] == '#' || line[0] == 'E' || line[0] == 'P') continue;
+			std::istringstream iss(line);
+			tokenizer::Scanner scan(line);
+			if (line[0] == 'B') {
+				int ts1 = 0, ts2 = 0;
+				float bpm1 = 0.0f, bpm2 = 0.0f;
+				iss.ignore();
+				scan.ignore();
+				EXPECT_EQ(static_cast<bool>(iss >> ts1 >> bpm1), static_cast<bool>(scan >> ts2 >> bpm2)) << line;
+				EXPECT_EQ(ts1, ts2);
+				EXPECT_EQ(bpm1, bpm2);
+				continue;
+			}
+			if (line[0] == '-') {
+				unsigned ts1 = 7, end1 = 7, ts2 = 7, end2 = 7;
+				iss.ignore();
+				scan.ignore();
+				EXPECT_EQ(static_cast<bool>(iss >> ts1 >> end1), static_cast<bool>(scan >> ts2 >> end2)) << line;
+				EXPECT_EQ(ts1, ts2) << line;
+				EXPECT_EQ(end1, end2) << line;
+				continue;
+			}
+			EXPECT_EQ(readNote(iss, streamRest), readNote(scan, scannerRest)) << line;
+		}
+	}
+}
+
+TEST(UnitTest_Tokenizer, corpus_sm_values) {
+	for (auto const& value: { "0.000=120.000,32.000=140.500", "0=180", "16.000=0.250", "1=2,3", "=1", "4=5,,6=7", "1.5e=2" }) {
+		std::istringstream iss(value);
+		tokenizer::Scanner scan(value);
+		std::vector<double> expected, values;
+		double a, b;
+		char chr;
+		while (iss >> a >> chr >> b) { expected.insert(expected.end(), { a, b }); if (!(iss >> chr)) break; }
+		while (scan >> a >> chr >> b) { values.insert(values.end(), { a, b }); if (!(scan >> chr)) break; }
+		EXPECT_EQ(expected, values) << value;
+	}
+}
+
+TEST(UnitTest_Tokenizer, corpus_ini) {
+	for (auto const& text: iniCorpus) {
+		EXPECT_EQ(std::regex_search(text.substr(0, 1024), iniCheckHeader), tokenizer::iniSongSection(std::string_view(text).substr(0, 1024))) << text;
+		for (auto line: streamLines(text)) {
+			trim(line);
+			std::smatch match;
+			std::string_view key, value;
+			bool const found = std::regex_search(line, match, iniParseLine);
+			ASSERT_EQ(found, tokenizer::iniKeyValue(line, key, value)) << line;
+			if (!found) continue;
+			EXPECT_EQ(match[1].str(), key);
+			EXPECT_EQ(match[2].str(), value);
+		}
+	}
+	for (std::string const text: { "[song]", "x\n[song]#", "x\r  [song] \r", "[songs]\n", "[Song]\n", " x [song]\n" }) {
+		EXPECT_EQ(std::regex_search(text, iniCheckHeader), tokenizer::iniSongSection(text)) << text;
+	}
+	for (std::string const line: { "a=b", "a = b c \r", "junk\rkey=value", "k\t=\tv\t", "!k=v", "k v", "a=b\rc" }) {
+		std::smatch match;
+		std::string_view key, value;
+		bool const found = std::regex_search(line, match, iniParseLine);
+		ASSERT_EQ(found, tokenizer::iniKeyValue(line, key, value)) << line;
+		if (found) {
+			EXPECT_EQ(match[2].str(), value) << line;
+		}
+	}
+}
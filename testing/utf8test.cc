@@ -0,0 +1,82 @@
+#include "common.hh"
+
+#include "game/utf8.hh"
+
+#include <unicode/ucsdet.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+TEST(UnitTest_UTF8, isASCII) {
+	EXPECT_TRUE(utf8::isASCII(""));
+	EXPECT_TRUE(utf8::isASCII("#TITLE:Hello World"));
+	EXPECT_TRUE(utf8::isASCII(std::string(100, 'x')));
+	EXPECT_FALSE(utf8::isASCII("#TITLE:Caf\xC3\xA9"));
+	// Non-ASCII byte at every position relative to the eight byte blocks
+	for (std::size_t pos = 0; pos < 20; ++pos) {
+		std::string str(20, 'a');
+		str[pos] = '\xE9';
+		EXPECT_FALSE(utf8::isASCII(str)) << pos;
+	}
+}
+
+TEST(UnitTest_UTF8, isValid) {
+	EXPECT_TRUE(utf8::isValid(""));
+	EXPECT_TRUE(utf8::isValid("plain ASCII text, long enough to use the block scan"));
+	EXPECT_TRUE(utf8::isValid("Caf\xC3\xA9 \xE2\x82\xAC \xE6\x97\xA5\xE6\x9C\xAC \xF0\x9F\x8E\xA4"));  // é € 日本 🎤
+	EXPECT_TRUE(utf8::isValid("\xED\x9F\xBF"));  // U+D7FF, last before surrogates
+	EXPECT_TRUE(utf8::isValid("\xF4\x8F\xBF\xBF"));  // U+10FFFF
+	EXPECT_TRUE(utf8::isValid(std::string_view("a\0b", 3)));
+
+	EXPECT_FALSE(utf8::isValid("Caf\xE9"));  // Latin-1
+	EXPECT_FALSE(utf8::isValid("\xC3"));  // Truncated
+	EXPECT_FALSE(utf8::isValid("\xE2\x82"));
+	EXPECT_FALSE(utf8::isValid("\xF0\x9F\x8E"));
+	EXPECT_FALSE(utf8::isValid("\x80"));  // Stray continuation
+	EXPECT_FALSE(utf8::isValid("\xC3\xA9\xA9"));
+	EXPECT_FALSE(utf8::isValid("\xC0\xAF"));  // Overlong
+	EXPECT_FALSE(utf8::isValid("\xE0\x80\xAF"));
+	EXPECT_FALSE(utf8::isValid("\xF0\x80\x80\xAF"));
+	EXPECT_FALSE(utf8::isValid("\xED\xA0\x80"));  // Surrogate U+D800
+	EXPECT_FALSE(utf8::isValid("\xF4\x90\x80\x80"));  // Above U+10FFFF
+	EXPECT_FALSE(utf8::isValid("\xF5\x80\x80\x80"));
+	EXPECT_FALSE(utf8::isValid("\xFF"));
+}
+
+namespace {
+	/// Song headers as found in real libraries: mostly ASCII and UTF-8, some in legacy encodings
+	std::vector<std::string> makeCorpus() {
+		std::vector<std::string> const headers = {
+			"#TITLE:Never Gonna Give You Up\n#ARTIST:Rick Astley\n#MP3:song.mp3\n#BPM:226\n#GAP:1500\n",
+			"#TITLE:Sch\xC3\xB6n ist es auf der Welt zu sein\n#ARTIST:Roy Black & Anita\n#MP3:song.ogg\n#BPM:300\n",
+			"#TITLE:\xE5\xA4\x9C\xE3\x81\xAB\xE9\xA7\x86\xE3\x81\x91\xE3\x82\x8B\n#ARTIST:YOASOBI\n#MP3:yoru.mp3\n#BPM:260\n",
+			"#TITLE:Je veux\n#ARTIST:Za\xC3\xAFz\n#LANGUAGE:Fran\xC3\xA7\x61is\n#MP3:zaz.mp3\n#BPM:280\n",
+			"#TITLE:Sch\xF6n ist es auf der Welt zu sein\n#ARTIST:Roy Black & Anita\n#MP3:song.ogg\n#BPM:300\n",  // Latin-1
+			"#TITLE:\xCA\xE0\xF2\xFE\xF8\xE0\n#ARTIST:\xD0\xF3\xF1\xF1\xEA\xE8\xE9\n#MP3:katyusha.mp3\n#BPM:240\n",  // CP1251
+		};
+		std::vector<std::string> corpus;
+		for (unsigned i = 0; i < 3000; ++i) corpus.push_back(headers[i % headers.size()] + "#EDITION:SingStar " + std::to_string(i) + "\n");
+		return corpus;
+	}
+}
+
+TEST(UnitTest_UTF8, detection_only_for_legacy_encodings) {
+	auto const corpus = makeCorpus();
+	UErrorCode status = U_ZERO_ERROR;
+	std::unique_ptr<UCharsetDetector, decltype(&ucsdet_close)> detector(ucsdet_open(&status), &ucsdet_close);
+	ASSERT_TRUE(U_SUCCESS(status));
+	auto detect = [&](std::string const& text) {
+		UErrorCode error = U_ZERO_ERROR;
+		ucsdet_setText(detector.get(), text.data(), static_cast<int32_t>(text.size()), &error);
+		return ucsdet_detect(detector.get(), &error) != nullptr;
+	};
+	auto count = [&](auto classify) {
+		std::size_t detected = 0;
+		for (auto const& text: corpus) detected += classify(text);
+		return detected;
+	};
+	EXPECT_EQ(corpus.size(), count([&](std::string const& text) { return detect(text); }));
+	// Only the legacy encoded headers need detection
+	EXPECT_EQ(corpus.size() / 3, count([&](std::string const& text) { return !utf8::isValid(text) && detect(text); }));
+}
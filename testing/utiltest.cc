@@ -2,6 +2,8 @@
 
 #include "game/util.hh"
 
+#include <regex>
+
 TEST(UnitTest_Utils, clamp) {
     EXPECT_EQ(0.0, clamp(-1.0, 0.0, 1.0));
     EXPECT_EQ(0.5, clamp(0.5, 0.0, 1.0));
@@ -282,3 +284,41 @@ TEST(UnitTest_Utils, isText_utf8_euro_border_2) {
     EXPECT_TRUE(isText("euro sign: " + euro_utf8, 13));
 }
 
+
+TEST(UnitTest_Utils, moveLeadingWord) {
+    std::vector<std::string> const words = { "The", "A", "La", "Los", "Las", "\xC3\x89l" };
+    EXPECT_EQ("Beatles,The", moveLeadingWord("The Beatles", words));
+    EXPECT_EQ("Beatles,THE", moveLeadingWord("THE Beatles", words));
+    EXPECT_EQ("Day in the Life,a", moveLeadingWord("a Day in the Life", words));
+    EXPECT_EQ("Bamba,La", moveLeadingWord("La\tBamba", words));
+    EXPECT_EQ("Rey,\xC3\x89l", moveLeadingWord("\xC3\x89l Rey", words));
+    // Not a whole word or nothing after it
+    EXPECT_EQ("Theatre of Tragedy", moveLeadingWord("Theatre of Tragedy", words));
+    EXPECT_EQ("The", moveLeadingWord("The", words));
+    EXPECT_EQ("The ", moveLeadingWord("The ", words));
+    EXPECT_EQ("A-ha", moveLeadingWord("A-ha", words));
+    EXPECT_EQ("Lost Boys", moveLeadingWord("Lost Boys", words));
+    EXPECT_EQ("The Line\nBreak", moveLeadingWord("The Line\nBreak", words));
+    EXPECT_EQ("", moveLeadingWord("", words));
+    EXPECT_EQ("The Beatles", moveLeadingWord("The Beatles", {}));
+}
+
+namespace {
+    /// The per field regex formerly built by UnicodeUtil::collate
+    std::string moveLeadingWordRegex(std::string const& s, std::vector<std::string> const& words) {
+        std::string pattern = "^((";
+        for (auto const& word: words) pattern += (&word == &words.front() ? "" : "|") + word;
+        pattern += ")\\s(.+))$";
+        return std::regex_replace(s, std::regex(pattern, std::regex_constants::icase), "$3,$2");
+    }
+}
+
+TEST(UnitTest_Utils, moveLeadingWord_matches_regex) {
+    std::vector<std::string> const words = { "The", "A", "La", "Los", "Las", "\xC3\x89l" };
+    std::vector<std::string> const samples = { "The Beatles", "Abba", "A Day in the Life", "La Bamba", "Queen",
+      "Los Lobos", "Bohemian Rhapsody", "the Killers", "Theatre of Tragedy", "Las Ketchup" };
+    for (unsigned i = 0; i < 3 * samples.size(); ++i) {
+        std::string const field = samples[i % samples.size()] + (i % 3 ? "" : " " + std::to_string(i));
+        EXPECT_EQ(moveLeadingWordRegex(field, words), moveLeadingWord(field, words)) << field;
+    }
+}